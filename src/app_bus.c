@@ -0,0 +1,296 @@
+/**
+ * @file app_bus.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Message bus and the dispatcher task that runs the app
+ *
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <string.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "app_bus.h"
+#include "mem_stats.h"
+
+_Static_assert((BUS_DEPTH & (BUS_DEPTH - 1)) == 0, "BUS_DEPTH must be a power of two");
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define BUS_TASK_STACK     3072
+#define BUS_TASK_PRIORITY  5
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+/* Queue slot, seq tells whose turn it is: pos when free for the producer
+ * claiming pos, pos + 1 once the message is published. */
+typedef struct {
+	atomic_uint seq;
+	BUS_msg_t msg;
+} BUS_slot_t;
+
+typedef struct {
+	BUS_handler_t handler;
+	void* arg;
+} BUS_subscriber_t;
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static const char* TAG = "app_bus";
+
+static BUS_slot_t slots[BUS_DEPTH];
+static atomic_uint tail = 0;   //next position to claim, producers
+static atomic_uint head = 0;   //next position to read, dispatcher only writes it
+
+static BUS_subscriber_t subscribers[BUS_MSG_TYPES][BUS_MAX_HANDLERS];
+static int subscriber_count[BUS_MSG_TYPES];
+
+static TaskHandle_t bus_task = NULL;
+static StaticTask_t bus_task_buf;
+static StackType_t bus_task_stack[BUS_TASK_STACK];
+
+//producer side counters, posting never takes the stats lock
+static atomic_uint posted[BUS_MSG_TYPES];
+static atomic_uint dropped[BUS_MSG_TYPES];
+static atomic_uint handoffs[BUS_MSG_TYPES];
+static atomic_uint depth_max[BUS_MSG_TYPES];
+static BUS_stats_t stats;
+static int64_t start_us;
+static portMUX_TYPE stats_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+//Take the oldest published message, dispatcher only
+static bool BUS_pop(BUS_msg_t* msg)
+{
+	const unsigned pos = atomic_load_explicit(&head, memory_order_relaxed);
+	BUS_slot_t* slot = &slots[pos & (BUS_DEPTH - 1)];
+
+	//claimed but not published yet, its producer notifies once it is
+	if (atomic_load_explicit(&slot->seq, memory_order_acquire) != pos + 1)
+	{
+		return false;
+	}
+
+	*msg = slot->msg;
+	//free for the producer that claims this slot one lap later
+	atomic_store_explicit(&slot->seq, pos + BUS_DEPTH, memory_order_release);
+	atomic_store_explicit(&head, pos + 1, memory_order_relaxed);
+	return true;
+}
+
+static void BUS_atomicMax(atomic_uint* max, unsigned value)
+{
+	unsigned old = atomic_load_explicit(max, memory_order_relaxed);
+	while (value > old && !atomic_compare_exchange_weak_explicit(max, &old, value, memory_order_relaxed, memory_order_relaxed))
+	{
+	}
+}
+
+static void BUS_dispatch(const BUS_msg_t* msg)
+{
+	BUS_type_stats_t* t = &stats.types[msg->type];
+	const int64_t start = esp_timer_get_time();
+
+	for (int i = 0; i < subscriber_count[msg->type]; i++)
+	{
+		subscribers[msg->type][i].handler(msg, subscribers[msg->type][i].arg);
+	}
+
+	const int64_t end = esp_timer_get_time();
+	taskENTER_CRITICAL(&stats_lock);
+	t->dispatched++;
+	if (start - msg->post_us > t->latency_max_us)
+	{
+		t->latency_max_us = start - msg->post_us;
+	}
+	if (end - start > t->handler_max_us)
+	{
+		t->handler_max_us = end - start;
+	}
+	taskEXIT_CRITICAL(&stats_lock);
+}
+
+static void BUS_task(void* arg)
+{
+	BUS_msg_t msg;
+
+	for (;;)
+	{
+		//one wakeup for however many posts landed since the last one
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+		const uint32_t depth = atomic_load(&tail) - atomic_load(&head);
+		taskENTER_CRITICAL(&stats_lock);
+		stats.wakeups++;
+		if (depth > stats.depth_max)
+		{
+			stats.depth_max = depth;
+		}
+		taskEXIT_CRITICAL(&stats_lock);
+
+		while (BUS_pop(&msg))
+		{
+			BUS_dispatch(&msg);
+		}
+	}
+}
+
+esp_err_t BUS_init(void)
+{
+	for (unsigned i = 0; i < BUS_DEPTH; i++)
+	{
+		atomic_init(&slots[i].seq, i);
+	}
+	for (int i = 0; i < BUS_MSG_TYPES; i++)
+	{
+		atomic_init(&posted[i], 0);
+		atomic_init(&dropped[i], 0);
+		atomic_init(&handoffs[i], 0);
+		atomic_init(&depth_max[i], 0);
+	}
+	memset(subscriber_count, 0, sizeof(subscriber_count));
+	memset(&stats, 0, sizeof(stats));
+	start_us = esp_timer_get_time();
+
+	bus_task = xTaskCreateStatic(BUS_task, "app_bus", BUS_TASK_STACK, NULL, BUS_TASK_PRIORITY, bus_task_stack, &bus_task_buf);
+	MEM_registerTask(bus_task);
+	return ESP_OK;
+}
+
+esp_err_t BUS_subscribe(BUS_msg_type_t type, BUS_handler_t handler, void* arg)
+{
+	if (type >= BUS_MSG_TYPES || handler == NULL)
+	{
+		return ESP_ERR_INVALID_ARG;
+	}
+	if (subscriber_count[type] == BUS_MAX_HANDLERS)
+	{
+		return ESP_ERR_NO_MEM;
+	}
+
+	subscribers[type][subscriber_count[type]].handler = handler;
+	subscribers[type][subscriber_count[type]].arg = arg;
+	subscriber_count[type]++;
+	return ESP_OK;
+}
+
+esp_err_t BUS_post(const BUS_msg_t* msg)
+{
+	unsigned pos = atomic_load_explicit(&tail, memory_order_relaxed);
+	BUS_slot_t* slot;
+
+	if (msg->type >= BUS_MSG_TYPES)
+	{
+		return ESP_ERR_INVALID_ARG;
+	}
+
+	//claim a slot, producers only ever retry when another one won the same slot
+	for (;;)
+	{
+		slot = &slots[pos & (BUS_DEPTH - 1)];
+		const int diff = (int)(atomic_load_explicit(&slot->seq, memory_order_acquire) - pos);
+
+		if (diff == 0)
+		{
+			if (atomic_compare_exchange_weak_explicit(&tail, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if (diff < 0)
+		{
+			//the dispatcher has not freed this slot yet, a full lap is waiting
+			atomic_fetch_add(&dropped[msg->type], 1);
+			ESP_LOGW(TAG, "queue full, dropping message %d", msg->type);
+			return ESP_ERR_NO_MEM;
+		}
+		else
+		{
+			pos = atomic_load_explicit(&tail, memory_order_relaxed);
+		}
+	}
+
+	//head cannot pass pos before the slot is published
+	BUS_atomicMax(&depth_max[msg->type], pos - atomic_load_explicit(&head, memory_order_relaxed));
+	atomic_fetch_add(&posted[msg->type], 1);
+
+	slot->msg = *msg;
+	slot->msg.post_us = esp_timer_get_time();
+	atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+
+	//the dispatcher drains everything before it sleeps, posting to itself needs no wakeup
+	if (xTaskGetCurrentTaskHandle() != bus_task)
+	{
+		atomic_fetch_add(&handoffs[msg->type], 1);
+		xTaskNotifyGive(bus_task);
+	}
+	return ESP_OK;
+}
+
+void BUS_getStats(BUS_stats_t* out)
+{
+	taskENTER_CRITICAL(&stats_lock);
+	*out = stats;
+	taskEXIT_CRITICAL(&stats_lock);
+
+	out->dropped = 0;
+	out->latency_max_us = 0;
+	out->handler_max_us = 0;
+	for (int i = 0; i < BUS_MSG_TYPES; i++)
+	{
+		BUS_type_stats_t* t = &out->types[i];
+		t->posted = atomic_load(&posted[i]);
+		t->dropped = atomic_load(&dropped[i]);
+		t->handoffs = atomic_load(&handoffs[i]);
+		t->depth_max = atomic_load(&depth_max[i]);
+
+		out->dropped += t->dropped;
+		out->latency_max_us = (t->latency_max_us > out->latency_max_us) ? t->latency_max_us : out->latency_max_us;
+		out->handler_max_us = (t->handler_max_us > out->handler_max_us) ? t->handler_max_us : out->handler_max_us;
+	}
+	out->uptime_us = esp_timer_get_time() - start_us;
+}
+
+void BUS_logStats(void)
+{
+	static const char* names[BUS_MSG_TYPES] = {"tick", "button", "icon", "media", "panel", "redraw"};
+	static uint32_t last_total = 0;
+	static int64_t last_us = 0;
+	BUS_stats_t s;
+	uint32_t total = 0;
+
+	BUS_getStats(&s);
+	for (int i = 0; i < BUS_MSG_TYPES; i++)
+	{
+		total += s.types[i].dispatched;
+	}
+
+	const int64_t window_us = s.uptime_us - last_us;
+	const float rate = (window_us > 0) ? (total - last_total) * 1000000.0f / window_us : 0.0f;
+	last_total = total;
+	last_us = s.uptime_us;
+
+	ESP_LOGI(TAG, "%"PRIu32" messages, %.2f/s, %"PRIu32" dropped, %"PRIu32" wakeups, depth max %"PRIu32"/%d, latency max %"PRId64" us, handler max %"PRId64" us",
+		total, rate, s.dropped, s.wakeups, s.depth_max, BUS_DEPTH, s.latency_max_us, s.handler_max_us);
+	for (int i = 0; i < BUS_MSG_TYPES; i++)
+	{
+		const BUS_type_stats_t* t = &s.types[i];
+		ESP_LOGI(TAG, "  %-6s posted %"PRIu32" dispatched %"PRIu32" dropped %"PRIu32" handoffs %"PRIu32" depth max %"PRIu32" latency max %"PRId64" us handler max %"PRId64" us",
+			names[i], t->posted, t->dispatched, t->dropped, t->handoffs, t->depth_max, t->latency_max_us, t->handler_max_us);
+	}
+}
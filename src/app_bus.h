@@ -0,0 +1,141 @@
+/**
+ * @file app_bus.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Message bus and the dispatcher task that runs the app
+ *
+ * Clock ticks, button gestures and the work they lead to are posted as small
+ * fixed size messages to one queue, and a single dispatcher task runs the
+ * handlers subscribed to each type. Handlers never race each other, so the
+ * widgets and the frame buffer are only touched from the dispatcher.
+ *
+ * Posting is lock-free (a bounded ring with a sequence number per slot) and
+ * never blocks: any task or esp_timer callback may post, the dispatcher is
+ * woken with a task notification and drains everything that is queued before
+ * sleeping again. Posts from the dispatcher itself do not wake it.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "buttons.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define BUS_DEPTH               32    //messages in flight (power of two)
+#define BUS_MAX_HANDLERS        2     //handlers per message type
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+/* Message types. */
+typedef enum {
+	BUS_MSG_CLOCK_TICK = 0,  //minute boundary or clock set, no data
+	BUS_MSG_BUTTON,          //button gesture, data.button
+	BUS_MSG_ICON,            //show a media icon, data.icon
+	BUS_MSG_MEDIA,           //send a media command, data.ctrl
+	BUS_MSG_PANEL,           //change the panel power mode, data.panel
+	BUS_MSG_REDRAW,          //a transition ended, flush what changed meanwhile, no data
+	BUS_MSG_TYPES,
+} BUS_msg_type_t;
+
+/* Message, copied into the queue. */
+typedef struct {
+	uint8_t type;            //BUS_msg_type_t
+	int64_t post_us;         //set by BUS_post
+	union {
+		BUTTON_event_t button;
+		struct {
+			uint8_t index;
+			bool forward;    //slide direction
+		} icon;
+		uint8_t ctrl;        //CTRL_ bits of hid_device.c
+		uint8_t panel;       //LCD_panel_mode_t
+	} data;
+} BUS_msg_t;
+
+/* Runs in the dispatcher task. */
+typedef void (*BUS_handler_t)(const BUS_msg_t* msg, void* arg);
+
+/* Counters of one message type since BUS_init. */
+typedef struct {
+	uint32_t posted;         //accepted by BUS_post
+	uint32_t dispatched;
+	uint32_t dropped;        //posts lost to a full queue
+	uint32_t handoffs;       //posts from another task, each one notifies the dispatcher
+	uint32_t depth_max;      //messages queued ahead of one of this type, high-water mark
+	int64_t latency_max_us;  //post to the first handler
+	int64_t handler_max_us;  //longest time its handlers took on one message
+} BUS_type_stats_t;
+
+/* Event rate and queue depth since BUS_init. */
+typedef struct {
+	BUS_type_stats_t types[BUS_MSG_TYPES];
+	uint32_t dropped;        //all types
+	uint32_t wakeups;        //dispatcher wakeups, messages / wakeups is the batching
+	uint32_t depth_max;      //messages waiting when the dispatcher woke, high-water mark
+	int64_t latency_max_us;  //all types
+	int64_t handler_max_us;
+	int64_t uptime_us;       //time the counters cover
+} BUS_stats_t;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+/** @brief Create the queue and start the dispatcher task
+ *
+ *  @return ESP_OK on success.
+ */
+esp_err_t BUS_init(void);
+
+/** @brief Run a handler for every message of a type
+ *
+ *  Call during init, before anything posts that type.
+ *
+ *  @param type Message type
+ *  @param handler Handler, runs in the dispatcher task
+ *  @param arg Passed back to handler
+ *  @return ESP_OK, ESP_ERR_INVALID_ARG for a bad type or ESP_ERR_NO_MEM when
+ *          the type already has BUS_MAX_HANDLERS handlers.
+ */
+esp_err_t BUS_subscribe(BUS_msg_type_t type, BUS_handler_t handler, void* arg);
+
+/** @brief Queue a message for the dispatcher
+ *
+ *  Never blocks, safe to call from any task (not from an ISR).
+ *
+ *  @param msg Message, type and data are copied
+ *  @return ESP_OK, or ESP_ERR_NO_MEM when the queue is full.
+ */
+esp_err_t BUS_post(const BUS_msg_t* msg);
+
+/** @brief Get the event and queue counters
+ *
+ *  @param stats Filled with the current counters
+ *  @return Void.
+ */
+void BUS_getStats(BUS_stats_t* stats);
+
+/** @brief Log the counters and the event rate since the last call
+ *
+ *  @return Void.
+ */
+void BUS_logStats(void);
+
+#ifdef __cplusplus
+}
+#endif
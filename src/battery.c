@@ -0,0 +1,182 @@
+/**
+ * @file battery.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Battery voltage sense and state of charge estimate
+ *
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <stdbool.h>
+#include "esp_log.h"
+#include "esp_adc/adc_oneshot.h"
+#include "esp_adc/adc_cali.h"
+#include "esp_adc/adc_cali_scheme.h"
+#include "battery.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define BATTERY_ATTEN         ADC_ATTEN_DB_2_5
+#define BATTERY_RAW_FULL_MV   1250  //approximate full scale at BATTERY_ATTEN, used without calibration
+#define BATTERY_RAW_MAX       4095
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+typedef struct {
+	int mv;
+	int percent;
+} BATTERY_point_t;
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static const char* TAG = "battery";
+
+static adc_oneshot_unit_handle_t adc = NULL;
+static adc_cali_handle_t cali = NULL;
+static adc_channel_t channel;
+
+//Resting LiPo discharge curve, highest voltage first
+static const BATTERY_point_t curve[] = {
+	{4200, 100},
+	{4100, 90},
+	{4000, 78},
+	{3900, 65},
+	{3800, 50},
+	{3750, 40},
+	{3700, 28},
+	{3650, 18},
+	{3600, 10},
+	{3500, 4},
+	{3300, 0},
+};
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+static void BATTERY_initCali(adc_unit_t unit)
+{
+	esp_err_t ret = ESP_ERR_NOT_SUPPORTED;
+
+#if ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
+	const adc_cali_curve_fitting_config_t config = {
+		.unit_id = unit,
+		.chan = channel,
+		.atten = BATTERY_ATTEN,
+		.bitwidth = ADC_BITWIDTH_DEFAULT,
+	};
+	ret = adc_cali_create_scheme_curve_fitting(&config, &cali);
+#elif ADC_CALI_SCHEME_LINE_FITTING_SUPPORTED
+	const adc_cali_line_fitting_config_t config = {
+		.unit_id = unit,
+		.atten = BATTERY_ATTEN,
+		.bitwidth = ADC_BITWIDTH_DEFAULT,
+	};
+	ret = adc_cali_create_scheme_line_fitting(&config, &cali);
+#endif
+
+	if (ret != ESP_OK)
+	{
+		//readings are still usable, just less accurate
+		ESP_LOGW(TAG, "no ADC calibration (%s), using nominal full scale", esp_err_to_name(ret));
+		cali = NULL;
+	}
+}
+
+esp_err_t BATTERY_init(void)
+{
+	adc_unit_t unit;
+	esp_err_t ret = adc_oneshot_io_to_channel(BATTERY_GPIO, &unit, &channel);
+	if (ret != ESP_OK)
+	{
+		ESP_LOGW(TAG, "GPIO%d has no ADC channel: %s", BATTERY_GPIO, esp_err_to_name(ret));
+		return ret;
+	}
+
+	const adc_oneshot_unit_init_cfg_t unit_config = {
+		.unit_id = unit,
+	};
+	ret = adc_oneshot_new_unit(&unit_config, &adc);
+	if (ret != ESP_OK)
+	{
+		return ret;
+	}
+
+	const adc_oneshot_chan_cfg_t chan_config = {
+		.atten = BATTERY_ATTEN,
+		.bitwidth = ADC_BITWIDTH_DEFAULT,
+	};
+	ret = adc_oneshot_config_channel(adc, channel, &chan_config);
+	if (ret != ESP_OK)
+	{
+		adc_oneshot_del_unit(adc);
+		adc = NULL;
+		return ret;
+	}
+
+	BATTERY_initCali(unit);
+	return ESP_OK;
+}
+
+esp_err_t BATTERY_readMv(int* mv)
+{
+	int sum = 0;
+
+	if (adc == NULL)
+	{
+		return ESP_ERR_INVALID_STATE;
+	}
+
+	for (int i = 0; i < BATTERY_SAMPLES; i++)
+	{
+		int raw;
+		esp_err_t ret = adc_oneshot_read(adc, channel, &raw);
+		if (ret != ESP_OK)
+		{
+			return ret;
+		}
+		sum += raw;
+	}
+	const int raw = sum / BATTERY_SAMPLES;
+
+	int pin_mv;
+	if (cali == NULL || adc_cali_raw_to_voltage(cali, raw, &pin_mv) != ESP_OK)
+	{
+		pin_mv = raw * BATTERY_RAW_FULL_MV / BATTERY_RAW_MAX;
+	}
+
+	//undo the divider
+	*mv = pin_mv * (BATTERY_R_TOP + BATTERY_R_BOTTOM) / BATTERY_R_BOTTOM;
+	return ESP_OK;
+}
+
+int BATTERY_percent(int mv)
+{
+	const int points = sizeof(curve) / sizeof(curve[0]);
+
+	if (mv >= curve[0].mv)
+	{
+		return 100;
+	}
+
+	//linear between the two points around mv
+	for (int i = 1; i < points; i++)
+	{
+		if (mv >= curve[i].mv)
+		{
+			const BATTERY_point_t* hi = &curve[i - 1];
+			const BATTERY_point_t* lo = &curve[i];
+			return lo->percent + (mv - lo->mv) * (hi->percent - lo->percent) / (hi->mv - lo->mv);
+		}
+	}
+	return 0;
+}
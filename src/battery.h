@@ -0,0 +1,62 @@
+/**
+ * @file battery.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Battery voltage sense and state of charge estimate
+ *
+ * The battery is read through the R3 (100k) / R4 (27k) divider into GPIO36
+ * (ADC1 channel 0 on the ESP32). A full cell (4.2V) shows up as ~0.89V at the
+ * pin, so the ADC runs at 2.5dB attenuation for the best resolution. Boards
+ * without ADC on that pin fail BATTERY_init and every read after it.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include "esp_err.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define BATTERY_GPIO         36   //divider tap
+#define BATTERY_R_TOP        100  //R3, kOhm
+#define BATTERY_R_BOTTOM     27   //R4, kOhm
+#define BATTERY_SAMPLES      16   //readings averaged per measurement, the divider is high impedance
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+/** @brief Set up the ADC channel behind BATTERY_GPIO
+ *
+ *  Uses the eFuse calibration when the chip has one.
+ *
+ *  @return ESP_OK on success, the ADC driver error if the pin has no ADC channel.
+ */
+esp_err_t BATTERY_init(void);
+
+/** @brief Measure the battery voltage
+ *
+ *  @param mv Filled with the battery voltage in millivolts
+ *  @return ESP_OK on success, ESP_ERR_INVALID_STATE before a successful BATTERY_init.
+ */
+esp_err_t BATTERY_readMv(int* mv);
+
+/** @brief Estimate the state of charge of a LiPo cell at rest
+ *
+ *  @param mv Battery voltage in millivolts
+ *  @return Charge in percent (0 - 100).
+ */
+int BATTERY_percent(int mv);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,357 @@
+/**
+ * @file buttons.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Push button debouncing and gesture recognition
+ *
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <string.h>
+#include <assert.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "driver/gpio.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "power_mgmt.h"
+#include "buttons.h"
+#include "mem_stats.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define BUTTON_QUEUE_DEPTH     16
+#define BUTTON_TASK_STACK      2048
+#define BUTTON_TASK_PRIORITY   10
+
+#define BUTTON_TIMER_EDGE      (-1)  //queue item from a button timer rather than the ISR
+#define BUTTON_NO_DEADLINE     INT64_MAX
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+typedef enum {
+	GESTURE_IDLE = 0,
+	GESTURE_PRESSED,      //down, waiting for the long press time
+	GESTURE_LONG_HELD,    //long press reported, repeating
+	GESTURE_WAIT_DOUBLE,  //released after a short press, waiting for a second press
+	GESTURE_SECOND_DOWN,  //double press reported, waiting for release
+} BUTTON_gesture_state_t;
+
+typedef struct {
+	uint8_t button;
+	int8_t level;         //new pin level, or BUTTON_TIMER_EDGE
+	int64_t time_us;
+} BUTTON_edge_t;
+
+typedef struct {
+	BUTTON_config_t cfg;
+	esp_timer_handle_t timer;
+
+	//shared with the ISR
+	int isr_level;        //last accepted level
+	bool lockout;         //edges are dropped until the task samples the pin again
+	int64_t lockout_end_us;
+
+	//button task only
+	BUTTON_gesture_state_t state;
+	int64_t deadline_us;  //next gesture timeout
+} BUTTON_state_t;
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static const char* TAG = "buttons";
+
+static BUTTON_state_t buttons[BUTTON_MAX];
+static BUTTON_cb_t button_cb = NULL;
+static void* button_cb_arg = NULL;
+
+static QueueHandle_t edge_queue = NULL;
+static StaticQueue_t edge_queue_buf;
+static uint8_t edge_storage[BUTTON_QUEUE_DEPTH * sizeof(BUTTON_edge_t)];
+static StaticTask_t button_task_buf;
+static StackType_t button_task_stack[BUTTON_TASK_STACK];
+static portMUX_TYPE button_lock = portMUX_INITIALIZER_UNLOCKED;
+static BUTTON_stats_t stats;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+static void IRAM_ATTR BUTTON_isr(void* arg)
+{
+	const uint8_t index = (uintptr_t)arg;
+	BUTTON_state_t* b = &buttons[index];
+	const int64_t now = esp_timer_get_time();
+	const int level = gpio_get_level(b->cfg.gpio);
+	BaseType_t woken = pdFALSE;
+
+	//stay level triggered for light sleep wakeup, wait for the opposite level
+	gpio_set_intr_type(b->cfg.gpio, level ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+
+	portENTER_CRITICAL_ISR(&button_lock);
+	if (b->lockout || level == b->isr_level)
+	{
+		stats.bounces++;
+		portEXIT_CRITICAL_ISR(&button_lock);
+		return;
+	}
+	b->isr_level = level;
+	b->lockout = true;
+	b->lockout_end_us = now + BUTTON_DEBOUNCE_US;
+	stats.edges++;
+	portEXIT_CRITICAL_ISR(&button_lock);
+
+	BUTTON_edge_t edge = {.button = index, .level = level, .time_us = now};
+	xQueueSendFromISR(edge_queue, &edge, &woken);
+	if (woken)
+	{
+		portYIELD_FROM_ISR();
+	}
+}
+
+static void BUTTON_timerCallback(void* arg)
+{
+	BUTTON_edge_t edge = {.button = (uintptr_t)arg, .level = BUTTON_TIMER_EDGE, .time_us = esp_timer_get_time()};
+	xQueueSend(edge_queue, &edge, 0);
+}
+
+//Arm the button timer for whichever comes first, the end of the lockout or the gesture deadline
+static void BUTTON_armTimer(BUTTON_state_t* b)
+{
+	int64_t next = b->deadline_us;
+
+	portENTER_CRITICAL(&button_lock);
+	if (b->lockout && b->lockout_end_us < next)
+	{
+		next = b->lockout_end_us;
+	}
+	portEXIT_CRITICAL(&button_lock);
+
+	esp_timer_stop(b->timer);
+	if (next != BUTTON_NO_DEADLINE)
+	{
+		const int64_t delay = next - esp_timer_get_time();
+		esp_timer_start_once(b->timer, delay > 0 ? delay : 0);
+	}
+}
+
+static void BUTTON_emit(BUTTON_state_t* b, BUTTON_gesture_t gesture, int64_t edge_us)
+{
+	const BUTTON_event_t evt = {.gpio = b->cfg.gpio, .gesture = gesture, .edge_us = edge_us};
+	button_cb(&evt, button_cb_arg);
+
+	const int64_t latency = esp_timer_get_time() - edge_us;
+	portENTER_CRITICAL(&button_lock);
+	stats.events++;
+	if (latency > stats.latency_max_us)
+	{
+		stats.latency_max_us = latency;
+	}
+	portEXIT_CRITICAL(&button_lock);
+}
+
+//Debounced press or release
+static void BUTTON_onEdge(BUTTON_state_t* b, bool pressed, int64_t t)
+{
+	if (pressed)
+	{
+		POWER_requestWake(POWER_SRC_BUTTON);
+		if (b->state == GESTURE_WAIT_DOUBLE)
+		{
+			BUTTON_emit(b, BUTTON_DOUBLE, t);
+			b->state = GESTURE_SECOND_DOWN;
+			b->deadline_us = BUTTON_NO_DEADLINE;
+		}
+		else
+		{
+			b->state = GESTURE_PRESSED;
+			b->deadline_us = t + BUTTON_LONG_US;
+		}
+		return;
+	}
+
+	if (b->state == GESTURE_PRESSED && b->cfg.double_press)
+	{
+		b->state = GESTURE_WAIT_DOUBLE;
+		b->deadline_us = t + BUTTON_DOUBLE_GAP_US;
+		return;
+	}
+	if (b->state == GESTURE_PRESSED)
+	{
+		BUTTON_emit(b, BUTTON_SHORT, t);
+	}
+	//release after a long or double press ends the gesture silently
+	b->state = GESTURE_IDLE;
+	b->deadline_us = BUTTON_NO_DEADLINE;
+}
+
+static void BUTTON_onDeadline(BUTTON_state_t* b, int64_t now)
+{
+	switch (b->state)
+	{
+		case GESTURE_PRESSED:
+			BUTTON_emit(b, BUTTON_LONG, b->deadline_us);
+			b->state = GESTURE_LONG_HELD;
+			b->deadline_us += BUTTON_REPEAT_US;
+			break;
+		case GESTURE_LONG_HELD:
+			BUTTON_emit(b, BUTTON_REPEAT, b->deadline_us);
+			b->deadline_us += BUTTON_REPEAT_US;
+			break;
+		case GESTURE_WAIT_DOUBLE:
+			BUTTON_emit(b, BUTTON_SHORT, b->deadline_us);
+			b->state = GESTURE_IDLE;
+			b->deadline_us = BUTTON_NO_DEADLINE;
+			break;
+		default:
+			b->deadline_us = BUTTON_NO_DEADLINE;
+			break;
+	}
+	//never fall behind if the task was held up
+	if (b->deadline_us != BUTTON_NO_DEADLINE && b->deadline_us < now)
+	{
+		b->deadline_us = now;
+	}
+}
+
+//End of the lockout window: the pin may have settled on the other level while edges were ignored
+static void BUTTON_checkLockout(BUTTON_state_t* b, int64_t now)
+{
+	bool changed = false;
+
+	portENTER_CRITICAL(&button_lock);
+	if (b->lockout && now >= b->lockout_end_us)
+	{
+		const int level = gpio_get_level(b->cfg.gpio);
+		if (level != b->isr_level)
+		{
+			//missed the final edge, take it now and lock out again
+			b->isr_level = level;
+			b->lockout_end_us = now + BUTTON_DEBOUNCE_US;
+			stats.edges++;
+			changed = true;
+		}
+		else
+		{
+			b->lockout = false;
+		}
+	}
+	portEXIT_CRITICAL(&button_lock);
+
+	if (changed)
+	{
+		BUTTON_onEdge(b, b->isr_level == 0, now);
+	}
+}
+
+//One queue item, an edge from the ISR or a button timer expiry
+static void BUTTON_handle(const BUTTON_edge_t* edge)
+{
+	BUTTON_state_t* b = &buttons[edge->button];
+
+	if (edge->level != BUTTON_TIMER_EDGE)
+	{
+		BUTTON_onEdge(b, edge->level == 0, edge->time_us);
+	}
+	else
+	{
+		const int64_t now = esp_timer_get_time();
+		BUTTON_checkLockout(b, now);
+		if (now >= b->deadline_us)
+		{
+			BUTTON_onDeadline(b, now);
+		}
+	}
+	BUTTON_armTimer(b);
+}
+
+static void BUTTON_task(void* arg)
+{
+	BUTTON_edge_t edge;
+
+	for (;;)
+	{
+		xQueueReceive(edge_queue, &edge, portMAX_DELAY);
+		BUTTON_handle(&edge);
+	}
+}
+
+esp_err_t BUTTON_init(const BUTTON_config_t* cfg, int count, BUTTON_cb_t cb, void* arg)
+{
+	assert(count <= BUTTON_MAX);
+	esp_err_t ret;
+
+	button_cb = cb;
+	button_cb_arg = arg;
+	memset(&stats, 0, sizeof(stats));
+
+	edge_queue = xQueueCreateStatic(BUTTON_QUEUE_DEPTH, sizeof(BUTTON_edge_t), edge_storage, &edge_queue_buf);
+
+	//install gpio isr service, someone else may have done it already
+	ret = gpio_install_isr_service(0);
+	if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE)
+	{
+		return ret;
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		BUTTON_state_t* b = &buttons[i];
+		memset(b, 0, sizeof(*b));
+		b->cfg = cfg[i];
+		b->state = GESTURE_IDLE;
+		b->deadline_us = BUTTON_NO_DEADLINE;
+
+		const esp_timer_create_args_t timer_args = {
+			.callback = BUTTON_timerCallback,
+			.arg = (void*)(uintptr_t)i,
+			.name = "button",
+		};
+		ret = esp_timer_create(&timer_args, &b->timer);
+		if (ret != ESP_OK)
+		{
+			ESP_LOGE(TAG, "failed to create timer: %s", esp_err_to_name(ret));
+			return ret;
+		}
+
+		gpio_config_t io_conf = {
+			.pin_bit_mask = 1ULL << b->cfg.gpio,
+			.mode = GPIO_MODE_INPUT,
+			.pull_up_en = true,
+			.intr_type = GPIO_INTR_LOW_LEVEL,
+		};
+		gpio_config(&io_conf);
+		b->isr_level = gpio_get_level(b->cfg.gpio);
+
+		//let the button wake the CPU from light sleep
+		POWER_enableGpioWakeup(b->cfg.gpio);
+		gpio_isr_handler_add(b->cfg.gpio, BUTTON_isr, (void*)(uintptr_t)i);
+	}
+
+	MEM_registerTask(xTaskCreateStatic(BUTTON_task, "buttons", BUTTON_TASK_STACK, NULL, BUTTON_TASK_PRIORITY,
+		button_task_stack, &button_task_buf));
+	return ESP_OK;
+}
+
+void BUTTON_getStats(BUTTON_stats_t* out)
+{
+	portENTER_CRITICAL(&button_lock);
+	*out = stats;
+	portEXIT_CRITICAL(&button_lock);
+}
+
+bool BUTTON_acts(BUTTON_gesture_t gesture, bool repeat)
+{
+	return gesture != BUTTON_REPEAT || repeat;
+}
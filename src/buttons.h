@@ -0,0 +1,109 @@
+/**
+ * @file buttons.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Push button debouncing and gesture recognition
+ *
+ * The ISR timestamps edges and drops bounces inside a lockout window, the
+ * button task samples the pin again once the window ends and runs a gesture
+ * state machine per button. Each gesture is delivered as a single event.
+ * Pins stay level triggered (the ISR flips the level it waits for) so they
+ * can still wake the CPU from light sleep.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define BUTTON_MAX                4
+#define BUTTON_DEBOUNCE_US        20000   //edges ignored after an accepted edge
+#define BUTTON_LONG_US            600000  //held this long for a long press
+#define BUTTON_REPEAT_US          150000  //repeat period while held after a long press
+#define BUTTON_DOUBLE_GAP_US      250000  //max release to press gap for a double press
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+/* Gestures delivered to the callback. */
+typedef enum {
+	BUTTON_SHORT = 0,
+	BUTTON_LONG,
+	BUTTON_DOUBLE,
+	BUTTON_REPEAT,
+} BUTTON_gesture_t;
+
+/* Per button configuration, buttons are active low with the internal pull-up. */
+typedef struct {
+	int gpio;
+	bool double_press;  //wait for a second press before reporting short (adds BUTTON_DOUBLE_GAP_US latency)
+} BUTTON_config_t;
+
+/* Gesture event. */
+typedef struct {
+	int gpio;
+	BUTTON_gesture_t gesture;
+	int64_t edge_us;    //time of the edge that completed the gesture (esp_timer time)
+} BUTTON_event_t;
+
+/* Runs in the button task. */
+typedef void (*BUTTON_cb_t)(const BUTTON_event_t* evt, void* arg);
+
+/* Filter statistics since BUTTON_init. */
+typedef struct {
+	uint32_t edges;          //edges accepted by the ISR
+	uint32_t bounces;        //edges dropped inside the lockout window
+	uint32_t events;         //gestures delivered
+	int64_t latency_max_us;  //worst edge to callback delay
+} BUTTON_stats_t;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+/** @brief Configure the button pins and start the button task
+ *
+ *  @param buttons Button configurations (copied)
+ *  @param count Number of buttons, at most BUTTON_MAX
+ *  @param cb Gesture callback
+ *  @param arg Passed back to cb
+ *  @return ESP_OK on success.
+ */
+esp_err_t BUTTON_init(const BUTTON_config_t* buttons, int count, BUTTON_cb_t cb, void* arg);
+
+/** @brief Get the filter statistics
+ *
+ *  @param stats Filled with the current statistics
+ *  @return Void.
+ */
+void BUTTON_getStats(BUTTON_stats_t* stats);
+
+/** @brief Whether a gesture should act
+ *
+ *  A held button reports BUTTON_LONG once and then BUTTON_REPEAT every
+ *  BUTTON_REPEAT_US. Actions that make sense to repeat (volume) act on every
+ *  one, the rest act once per press.
+ *
+ *  @param gesture Gesture from the event
+ *  @param repeat true if the action repeats while the button is held
+ *  @return true if the action should run.
+ */
+bool BUTTON_acts(BUTTON_gesture_t gesture, bool repeat);
+
+#ifdef __cplusplus
+}
+#endif
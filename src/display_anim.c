@@ -0,0 +1,178 @@
+/**
+ * @file display_anim.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Frame paced screen transitions using the ST7735S vertical scroll
+ *
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <string.h>
+#include <assert.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_pm.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "display_anim.h"
+#include "mem_stats.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define ANIM_TASK_STACK     2048
+#define ANIM_TASK_PRIORITY  11 //below the flush task so it can send strips as they are composed
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static const char* TAG = "display_anim";
+
+static TaskHandle_t anim_task = NULL;
+static StaticTask_t anim_task_buf;
+static StackType_t anim_task_stack[ANIM_TASK_STACK];
+static esp_timer_handle_t frame_timer;
+static esp_pm_lock_handle_t anim_lock;  //keeps the timer on time, light sleep would stretch frames
+static int64_t frame_period_us;
+static ANIM_done_cb_t done_cb;
+static void* done_arg;
+
+//current transition, owned by the animation task while running
+static volatile bool running = false;
+static FB_rect_t anim_rect;
+static int anim_frame;
+static int anim_frames;
+
+static ANIM_stats_t stats;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+static void ANIM_timerCallback(void* arg)
+{
+	xTaskNotifyGive(anim_task);
+}
+
+//Rows of the new content shown after frame of frames, eased out so the motion settles
+static int ANIM_ease(int frame, int frames, int rows)
+{
+	const int left = frames - frame;
+	return rows - (rows * left * left) / (frames * frames);
+}
+
+static void ANIM_finish(void)
+{
+	esp_timer_stop(frame_timer);
+	//a tick may have landed after the last frame
+	ulTaskNotifyTake(pdTRUE, 0);
+
+	FB_scrollEnd();
+	running = false;
+	esp_pm_lock_release(anim_lock);
+
+	//whatever changed in the region during the transition, flushed by the framebuffer's owner
+	if (done_cb != NULL)
+	{
+		done_cb(done_arg);
+	}
+}
+
+static void ANIM_task(void* arg)
+{
+	for (;;)
+	{
+		//one notification per tick, more than one means frames were missed
+		const uint32_t ticks = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		if (!running)
+		{
+			continue;
+		}
+
+		stats.dropped += ticks - 1;
+		anim_frame = (anim_frame + (int)ticks < anim_frames) ? anim_frame + (int)ticks : anim_frames;
+
+		const int64_t start = esp_timer_get_time();
+		stats.bytes += FB_scrollStep(ANIM_ease(anim_frame, anim_frames, anim_rect.h));
+		stats.redraw_bytes += anim_rect.w * anim_rect.h * PIXEL_SIZE;
+		stats.frames++;
+
+		const uint32_t frame_us = (uint32_t)(esp_timer_get_time() - start);
+		if (frame_us > stats.max_frame_us)
+		{
+			stats.max_frame_us = frame_us;
+		}
+
+		if (anim_frame == anim_frames)
+		{
+			ANIM_finish();
+		}
+	}
+}
+
+esp_err_t ANIM_init(int fps, ANIM_done_cb_t done, void* arg)
+{
+	esp_err_t ret;
+
+	assert(fps > 0 && fps <= ANIM_MAX_FPS);
+	frame_period_us = 1000000 / fps;
+	done_cb = done;
+	done_arg = arg;
+
+	ret = esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "anim", &anim_lock);
+	if (ret != ESP_OK)
+	{
+		return ret;
+	}
+
+	const esp_timer_create_args_t timer_args = {
+		.callback = ANIM_timerCallback,
+		.name = "anim_frame",
+	};
+	ret = esp_timer_create(&timer_args, &frame_timer);
+	if (ret != ESP_OK)
+	{
+		return ret;
+	}
+
+	anim_task = xTaskCreateStatic(ANIM_task, "anim", ANIM_TASK_STACK, NULL, ANIM_TASK_PRIORITY, anim_task_stack, &anim_task_buf);
+	MEM_registerTask(anim_task);
+
+	memset(&stats, 0, sizeof(stats));
+	ESP_LOGI(TAG, "transitions at %d fps", fps);
+	return ESP_OK;
+}
+
+bool ANIM_begin(FB_rect_t rect, ANIM_direction_t dir)
+{
+	if (running || !FB_scrollBegin(rect, dir == ANIM_SCROLL_UP))
+	{
+		stats.rejected++;
+		return false;
+	}
+
+	anim_rect = rect;
+	return true;
+}
+
+void ANIM_start(int duration_ms)
+{
+	anim_frames = (int)((duration_ms * 1000LL) / frame_period_us);
+	anim_frames = (anim_frames > 0) ? anim_frames : 1;
+	anim_frame = 0;
+	stats.transitions++;
+
+	esp_pm_lock_acquire(anim_lock);
+	running = true;
+	ESP_ERROR_CHECK(esp_timer_start_periodic(frame_timer, frame_period_us));
+}
+
+void ANIM_getStats(ANIM_stats_t* stats_out)
+{
+	memcpy(stats_out, &stats, sizeof(*stats_out));
+}
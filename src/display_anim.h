@@ -0,0 +1,110 @@
+/**
+ * @file display_anim.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Frame paced screen transitions using the ST7735S vertical scroll
+ *
+ * A transition replaces the content of a region by scrolling its rows with
+ * VSCRDEF/VSCSAD, so each frame only sends the rows that just came into view
+ * instead of the whole region (see FB_scrollBegin). Frames are paced by a
+ * periodic timer at a target rate, ticks that arrive while a frame is still
+ * being sent are counted as dropped and the transition skips ahead to stay on
+ * time.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "display_fb.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define ANIM_DEFAULT_FPS     30
+#define ANIM_DEFAULT_MS      200  //transition length, keep within a power wake window
+#define ANIM_MAX_FPS         60
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+/* Direction the old content leaves in. */
+typedef enum {
+	ANIM_SCROLL_UP = 0,  //new content comes in from the bottom
+	ANIM_SCROLL_DOWN,    //new content comes in from the top
+} ANIM_direction_t;
+
+/* Runs in the animation task when a transition ends. Slots set inside the
+ * region while it ran are not on the glass yet, the owner of the framebuffer
+ * has to flush them. */
+typedef void (*ANIM_done_cb_t)(void* arg);
+
+/* Counters since ANIM_init. */
+typedef struct {
+	uint32_t transitions;    //transitions played
+	uint32_t rejected;       //ANIM_begin refused, the caller redrew instead
+	uint32_t frames;         //frames sent
+	uint32_t dropped;        //frame ticks missed because the previous frame was still being sent
+	uint32_t max_frame_us;   //longest time spent sending one frame
+	uint32_t bytes;          //pixel data sent by transitions
+	uint32_t redraw_bytes;   //what redrawing the whole region every frame would have sent
+} ANIM_stats_t;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+/** @brief Start the animation task and frame timer
+ *
+ *  Call after FB_init.
+ *
+ *  @param fps Target frame rate (1 - ANIM_MAX_FPS)
+ *  @param done Called when a transition ends (may be NULL)
+ *  @param arg Passed back to done
+ *  @return ESP_OK on success.
+ */
+esp_err_t ANIM_init(int fps, ANIM_done_cb_t done, void* arg);
+
+/** @brief Reserve a region for a transition
+ *
+ *  On success set the new slot contents inside rect, then call ANIM_start. On
+ *  failure just set the slots and flush as usual.
+ *
+ *  @param rect Region whose content changes, other slots may not cross its rows
+ *  @param dir Direction the old content leaves in
+ *  @return false if a transition is already running or the rows are shared.
+ */
+bool ANIM_begin(FB_rect_t rect, ANIM_direction_t dir);
+
+/** @brief Play the transition reserved with ANIM_begin
+ *
+ *  Returns right away, the frames are sent from the animation task. Anything
+ *  else that changed inside the region waits for the flush after the done
+ *  callback.
+ *
+ *  @param duration_ms Length of the transition
+ *  @return Void.
+ */
+void ANIM_start(int duration_ms);
+
+/** @brief Get the transition counters
+ *
+ *  @param stats Filled with a snapshot of the counters
+ *  @return Void.
+ */
+void ANIM_getStats(ANIM_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
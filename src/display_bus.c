@@ -0,0 +1,142 @@
+/**
+ * @file display_bus.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief SPI bus setup, transfer chunking and clock calibration for the LCD
+ *
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_rom_crc.h"
+#include "display_main.h"
+#include "display_bus.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define LCD_BUS_PATTERN_BYTES  (LCD_BUS_PATTERN_SIZE * LCD_BUS_PATTERN_SIZE * PIXEL_SIZE)
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static const char* TAG = "display_bus";
+
+static spi_device_interface_config_t dev_config = {
+	.mode = 0,                            //SPI mode 0
+	.spics_io_num = PIN_CHIP_SEL,         //CS pin
+	.queue_size = LCD_QUEUE_DEPTH,
+	.pre_cb = LCD_spiPreTransferCallback, //drives D/C per transaction
+};
+
+static DMA_ATTR uint8_t test_pattern[LCD_BUS_PATTERN_BYTES];
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+esp_err_t LCD_busInit(spi_device_handle_t* spi, int clock_hz)
+{
+	esp_err_t ret;
+
+	spi_bus_config_t bus_config = {
+		.mosi_io_num = PIN_SDA,
+		.miso_io_num = -1,
+		.sclk_io_num = PIN_SCK,
+		.max_transfer_sz = LCD_BUS_MAX_CHUNK + 8
+	};
+	//Init bus
+	ret = spi_bus_initialize(HOST_DEVICE, &bus_config, SPI_DMA_CH_AUTO);
+	if (ret != ESP_OK)
+	{
+		ESP_LOGE(TAG, "failed to init bus: %s", esp_err_to_name(ret));
+		return ret;
+	}
+
+	//Attach device to bus
+	dev_config.clock_speed_hz = clock_hz;
+	return spi_bus_add_device(HOST_DEVICE, &dev_config, spi);
+}
+
+esp_err_t LCD_busSetClock(spi_device_handle_t* spi, int clock_hz)
+{
+	esp_err_t ret = spi_bus_remove_device(*spi);
+	if (ret != ESP_OK)
+	{
+		return ret;
+	}
+
+	dev_config.clock_speed_hz = clock_hz;
+	return spi_bus_add_device(HOST_DEVICE, &dev_config, spi);
+}
+
+int LCD_busGetClock(void)
+{
+	return dev_config.clock_speed_hz;
+}
+
+int LCD_busChunkSize(const int size)
+{
+	if (size <= 0)
+	{
+		return 4;
+	}
+
+	const int chunks = (size + LCD_BUS_MAX_CHUNK - 1) / LCD_BUS_MAX_CHUNK;
+	const int chunk = (size + chunks - 1) / chunks;
+
+	//word aligned for DMA, never above the limit since MAX_TRANSFER_SIZE is aligned too
+	return (chunk + 3) & ~3;
+}
+
+//Pixels that toggle every bit lane plus a gradient, a marginal clock corrupts them quickly
+static void LCD_busFillPattern(int step)
+{
+	for (int i = 0; i < LCD_BUS_PATTERN_BYTES; i += PIXEL_SIZE)
+	{
+		const int px = i / PIXEL_SIZE;
+		const uint16_t color = (px & 1) ? 0x5555 ^ (step << 8) : 0xAAAA ^ px;
+		test_pattern[i]     = color >> 8;
+		test_pattern[i + 1] = color & 0xFF;
+	}
+}
+
+esp_err_t LCD_busCalibrate(spi_device_handle_t* spi, LCD_bus_verify_cb_t verify, void* arg)
+{
+	if (verify == NULL)
+	{
+		return ESP_ERR_NOT_SUPPORTED;
+	}
+
+	const LCD_bus_region_t region = {X_OFFSET, Y_OFFSET, LCD_BUS_PATTERN_SIZE, LCD_BUS_PATTERN_SIZE};
+	int good_hz = dev_config.clock_speed_hz;
+
+	for (int hz = good_hz + LCD_BUS_STEP_HZ; hz <= LCD_BUS_MAX_HZ; hz += LCD_BUS_STEP_HZ)
+	{
+		esp_err_t ret = LCD_busSetClock(spi, hz);
+		if (ret != ESP_OK)
+		{
+			return ret;
+		}
+
+		//new pattern per step so a stale region never passes
+		LCD_busFillPattern(hz / LCD_BUS_STEP_HZ);
+		LCD_waitFrame(LCD_sendWindowAsync(*spi, region.x, region.y, region.w, region.h, test_pattern, LCD_BUS_PATTERN_BYTES));
+
+		if (!verify(esp_rom_crc32_le(0, test_pattern, LCD_BUS_PATTERN_BYTES), &region, arg))
+		{
+			ESP_LOGW(TAG, "pattern failed at %d Hz", hz);
+			break;
+		}
+		good_hz = hz;
+	}
+
+	ESP_LOGI(TAG, "clock calibrated to %d Hz", good_hz);
+	return LCD_busSetClock(spi, good_hz);
+}
@@ -0,0 +1,112 @@
+/**
+ * @file display_bus.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief SPI bus setup, transfer chunking and clock calibration for the LCD
+ *
+ * Chunk sizes are derived from MAX_TRANSFER_SIZE so callers only pass a byte
+ * count. The ST7735S has no read line on this board, so the clock calibration
+ * cannot check the panel itself: each step sends a test pattern and hands its
+ * CRC to a verify hook (an emulator port, a logic analyzer script, ...) that
+ * decides whether the pattern arrived intact. The port's hook is
+ * LCD_PORT_VERIFY (display_port.h), app_main runs the calibration with it
+ * when LCD_BUS_CALIBRATE is set to 1.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "driver/spi_master.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define LCD_BUS_DEFAULT_HZ     10000000  //known good on this board
+#define LCD_BUS_MAX_HZ         15000000  //ST7735S serial write cycle is 66ns min
+#define LCD_BUS_STEP_HZ        1000000   //calibration step
+#define LCD_BUS_MAX_CHUNK      MAX_TRANSFER_SIZE
+#define LCD_BUS_PATTERN_SIZE   16        //calibration pattern is a square this many pixels wide
+
+#ifndef LCD_BUS_CALIBRATE
+#define LCD_BUS_CALIBRATE      0         //calibrate the clock at startup, needs a port with LCD_PORT_VERIFY
+#endif
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+/* Region the calibration pattern was written to (panel coordinates). */
+typedef struct {
+	uint8_t x;
+	uint8_t y;
+	uint8_t w;
+	uint8_t h;
+} LCD_bus_region_t;
+
+/* Calibration verify hook, returns true if the region now holds data with the expected CRC. */
+typedef bool (*LCD_bus_verify_cb_t)(uint32_t expected_crc, const LCD_bus_region_t* region, void* arg);
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+/** @brief Initialize the SPI bus and attach the LCD
+ *
+ *  @param spi Filled with the device handle
+ *  @param clock_hz SPI clock
+ *  @return ESP_OK on success.
+ */
+esp_err_t LCD_busInit(spi_device_handle_t* spi, int clock_hz);
+
+/** @brief Change the SPI clock
+ *
+ *  Re-attaches the device, the handle changes. Nothing may be in flight.
+ *
+ *  @param spi Device handle, replaced with the new one
+ *  @param clock_hz SPI clock
+ *  @return ESP_OK on success.
+ */
+esp_err_t LCD_busSetClock(spi_device_handle_t* spi, int clock_hz);
+
+/** @brief Get the current SPI clock
+ *
+ *  @return Clock in Hz.
+ */
+int LCD_busGetClock(void);
+
+/** @brief Chunk size for a transfer
+ *
+ *  Splits the transfer into the fewest chunks that fit MAX_TRANSFER_SIZE, sized
+ *  evenly and word aligned, the last chunk takes the remainder.
+ *
+ *  @param size Transfer size in bytes
+ *  @return Chunk size in bytes.
+ */
+int LCD_busChunkSize(const int size);
+
+/** @brief Step the SPI clock up until the verify hook reports a bad transfer
+ *
+ *  Must run after LCD_init and before anything else owns the handle
+ *  (e.g. FB_init). The last clock that passed is kept.
+ *
+ *  @param spi Device handle, replaced when the clock changes
+ *  @param verify Hook checking each test pattern, NULL keeps the current clock
+ *  @param arg Passed back to verify
+ *  @return ESP_OK, or ESP_ERR_NOT_SUPPORTED without a verify hook.
+ */
+esp_err_t LCD_busCalibrate(spi_device_handle_t* spi, LCD_bus_verify_cb_t verify, void* arg);
+
+#ifdef __cplusplus
+}
+#endif
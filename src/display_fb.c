@@ -0,0 +1,597 @@
+/**
+ * @file display_fb.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Draw list rasterization and pipelined strip flushing for the ST7735s LCD
+ *
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <string.h>
+#include <stdbool.h>
+#include <assert.h>
+#include "esp_attr.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "display_fb.h"
+#include "display_vsync.h"
+#include "mem_stats.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define FB_TASK_STACK     2048
+#define FB_TASK_PRIORITY  12 //above the drawing tasks so the next strip is queued as soon as DMA finishes
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+/* Strip handed to the flush task. */
+typedef struct {
+	uint8_t buf;
+	bool start;      //first strip of a rect, sets the window and starts the memory write
+	bool fill;       //rect only shows background, sent with LCD_fillRect (buf is just a credit)
+	bool sync;       //first strip of a flush, wait for vertical blanking before sending
+	FB_rect_t rect;
+	int len;
+} FB_job_t;
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+//strip buffers, one is composed while the other is being sent
+static DMA_ATTR uint8_t fb_strip[2][FB_STRIP_SIZE];
+
+//row scratch for decoding compressed bitmaps (one spare pixel for odd glyph rows)
+static WORD_ALIGNED_ATTR uint8_t fb_row[(WIDTH + 2) * PIXEL_SIZE];
+
+static FB_cmd_t slots[FB_MAX_SLOTS];
+static uint16_t background_color;
+
+static FB_rect_t dirty[FB_MAX_DIRTY];
+static int dirty_count = 0;
+
+//hardware scroll in progress, the band across its rows is left to FB_scrollStep
+static bool scroll_active = false;
+static bool scroll_started = false;
+static bool scroll_up;
+static FB_rect_t scroll_rect;
+static int scroll_rows;     //rows of scroll_rect already streamed
+
+//vsync the current flush started on, set by the flush task
+static int64_t fb_sync_us;
+
+static spi_device_handle_t fb_spi;
+static SemaphoreHandle_t fb_mutex = NULL;
+static QueueHandle_t fb_job_queue = NULL;   //strips ready to be sent
+static QueueHandle_t fb_free_queue = NULL;  //strip buffers ready to be composed
+
+static StaticSemaphore_t fb_mutex_buf;
+static StaticQueue_t fb_job_queue_buf;
+static StaticQueue_t fb_free_queue_buf;
+static uint8_t fb_job_storage[2 * sizeof(FB_job_t)];
+static uint8_t fb_free_storage[2 * sizeof(uint8_t)];
+static StaticTask_t fb_task_buf;
+static StackType_t fb_task_stack[FB_TASK_STACK];
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+static uint32_t FB_area(const FB_rect_t r)
+{
+	return (uint32_t)r.w * r.h;
+}
+
+static FB_rect_t FB_union(const FB_rect_t a, const FB_rect_t b)
+{
+	const int x0 = (a.x < b.x) ? a.x : b.x;
+	const int y0 = (a.y < b.y) ? a.y : b.y;
+	const int x1 = (a.x + a.w > b.x + b.w) ? a.x + a.w : b.x + b.w;
+	const int y1 = (a.y + a.h > b.y + b.h) ? a.y + a.h : b.y + b.h;
+	FB_rect_t u = {x0, y0, x1 - x0, y1 - y0};
+	return u;
+}
+
+static bool FB_intersects(const FB_rect_t a, const FB_rect_t b)
+{
+	return (a.x < b.x + b.w) && (b.x < a.x + a.w) && (a.y < b.y + b.h) && (b.y < a.y + a.h);
+}
+
+static bool FB_contains(const FB_rect_t outer, const FB_rect_t inner)
+{
+	return inner.x >= outer.x && inner.y >= outer.y
+		&& inner.x + inner.w <= outer.x + outer.w && inner.y + inner.h <= outer.y + outer.h;
+}
+
+//Full width rows a hardware scroll of rect moves
+static FB_rect_t FB_band(const FB_rect_t rect)
+{
+	FB_rect_t band = {0, rect.y, WIDTH, rect.h};
+	return band;
+}
+
+static bool FB_rectEqual(const FB_rect_t a, const FB_rect_t b)
+{
+	return a.x == b.x && a.y == b.y && a.w == b.w && a.h == b.h;
+}
+
+//Merge when the rects overlap or when the union costs less than a second window setup
+static bool FB_shouldMerge(const FB_rect_t a, const FB_rect_t b)
+{
+	return FB_intersects(a, b) || (FB_area(FB_union(a, b)) <= FB_area(a) + FB_area(b) + FB_MERGE_SLACK);
+}
+
+static void FB_removeDirty(int index)
+{
+	dirty[index] = dirty[--dirty_count];
+}
+
+//Caller must hold fb_mutex
+static void FB_addDirty(FB_rect_t rect)
+{
+	bool merged;
+
+	if (rect.w == 0 || rect.h == 0)
+	{
+		return;
+	}
+
+	do {
+		merged = false;
+		for (int i = 0; i < dirty_count; i++)
+		{
+			if (FB_shouldMerge(dirty[i], rect))
+			{
+				rect = FB_union(dirty[i], rect);
+				FB_removeDirty(i);
+				merged = true;
+				break;
+			}
+		}
+
+		//out of slots, fold into the rect that grows the least
+		if (!merged && dirty_count == FB_MAX_DIRTY)
+		{
+			int best = 0;
+			uint32_t best_growth = UINT32_MAX;
+			for (int i = 0; i < dirty_count; i++)
+			{
+				uint32_t growth = FB_area(FB_union(dirty[i], rect)) - FB_area(dirty[i]);
+				if (growth < best_growth)
+				{
+					best_growth = growth;
+					best = i;
+				}
+			}
+			rect = FB_union(dirty[best], rect);
+			FB_removeDirty(best);
+			merged = true;
+		}
+	} while (merged);
+
+	dirty[dirty_count++] = rect;
+}
+
+//Sends composed strips, one strip is on the bus while the caller composes the other
+static void FB_flushTask(void* arg)
+{
+	FB_job_t job;
+
+	for (;;)
+	{
+		if (xQueueReceive(fb_job_queue, &job, portMAX_DELAY))
+		{
+			//the next strip is composed while we wait for the blanking
+			if (job.sync)
+			{
+				fb_sync_us = LCD_vsyncWait();
+			}
+
+			if (job.fill)
+			{
+				LCD_fillRect(fb_spi, job.rect.x + X_OFFSET, job.rect.y + Y_OFFSET, job.rect.w, job.rect.h, background_color);
+			}
+			else if (job.start)
+			{
+				LCD_waitFrame(LCD_sendWindowAsync(fb_spi, job.rect.x + X_OFFSET, job.rect.y + Y_OFFSET, job.rect.w, job.rect.h,
+					fb_strip[job.buf], job.len));
+			}
+			else
+			{
+				LCD_waitFrame(LCD_continueFrameAsync(fb_spi, fb_strip[job.buf], job.len));
+			}
+			xQueueSend(fb_free_queue, &job.buf, portMAX_DELAY);
+		}
+	}
+}
+
+void FB_init(spi_device_handle_t spi, uint16_t background)
+{
+	if (fb_mutex == NULL)
+	{
+		fb_mutex = xSemaphoreCreateMutexStatic(&fb_mutex_buf);
+		fb_job_queue = xQueueCreateStatic(2, sizeof(FB_job_t), fb_job_storage, &fb_job_queue_buf);
+		fb_free_queue = xQueueCreateStatic(2, sizeof(uint8_t), fb_free_storage, &fb_free_queue_buf);
+		for (uint8_t i = 0; i < 2; i++)
+		{
+			xQueueSend(fb_free_queue, &i, 0);
+		}
+		MEM_registerTask(xTaskCreateStatic(FB_flushTask, "fb_flush", FB_TASK_STACK, NULL, FB_TASK_PRIORITY, fb_task_stack, &fb_task_buf));
+	}
+
+	xSemaphoreTake(fb_mutex, portMAX_DELAY);
+	fb_spi = spi;
+	background_color = background;
+	memset(slots, 0, sizeof(slots));
+	dirty_count = 0;
+	FB_rect_t screen = {0, 0, WIDTH, HEIGHT};
+	FB_addDirty(screen);
+	xSemaphoreGive(fb_mutex);
+}
+
+void FB_markDirty(FB_rect_t rect)
+{
+	xSemaphoreTake(fb_mutex, portMAX_DELAY);
+	FB_addDirty(rect);
+	xSemaphoreGive(fb_mutex);
+}
+
+void FB_setPanelMode(LCD_panel_mode_t mode)
+{
+	xSemaphoreTake(fb_mutex, portMAX_DELAY);
+	LCD_setPanelMode(fb_spi, mode);
+	xSemaphoreGive(fb_mutex);
+}
+
+//Replace a slot, nothing is marked dirty when the command did not change
+static void FB_setSlot(int slot, const FB_cmd_t* cmd)
+{
+	assert(slot >= 0 && slot < FB_MAX_SLOTS);
+	assert(cmd->rect.x + cmd->rect.w <= WIDTH && cmd->rect.y + cmd->rect.h <= HEIGHT);
+
+	xSemaphoreTake(fb_mutex, portMAX_DELAY);
+	FB_cmd_t* cur = &slots[slot];
+	if (cur->type == cmd->type && FB_rectEqual(cur->rect, cmd->rect) && cur->color == cmd->color
+		&& cur->src == cmd->src && cur->pal == cmd->pal
+		&& cur->font == cmd->font && cur->scale == cmd->scale && strcmp(cur->text, cmd->text) == 0)
+	{
+		xSemaphoreGive(fb_mutex);
+		return;
+	}
+
+	if (cur->type != FB_CMD_NONE)
+	{
+		FB_addDirty(cur->rect);
+	}
+	*cur = *cmd;
+	cur->dec_row = -1;
+	if (cur->type != FB_CMD_NONE)
+	{
+		FB_addDirty(cur->rect);
+	}
+	xSemaphoreGive(fb_mutex);
+}
+
+void FB_setFill(int slot, FB_rect_t rect, uint16_t color)
+{
+	FB_cmd_t cmd = {.type = FB_CMD_FILL, .rect = rect, .color = color};
+	FB_setSlot(slot, &cmd);
+}
+
+void FB_setBitmap(int slot, uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t* src)
+{
+	FB_cmd_t cmd = {.type = FB_CMD_BITMAP, .rect = {x, y, w, h}, .src = src};
+	FB_setSlot(slot, &cmd);
+}
+
+void FB_setRle(int slot, uint8_t x, uint8_t y, const LCD_rle_asset_t* asset)
+{
+	FB_cmd_t cmd = {.type = FB_CMD_RLE, .rect = {x, y, asset->width, asset->height}, .src = asset};
+	FB_setSlot(slot, &cmd);
+}
+
+void FB_setGlyph(int slot, uint8_t x, uint8_t y, const LCD_glyph_t* glyph, const LCD_palette_t* pal)
+{
+	FB_cmd_t cmd = {.type = FB_CMD_GLYPH, .rect = {x, y, glyph->width, glyph->height}, .src = glyph, .pal = pal};
+	FB_setSlot(slot, &cmd);
+}
+
+void FB_setText(int slot, uint8_t x, uint8_t y, const char* text, const FONT_t* font, uint8_t scale, const LCD_palette_t* pal)
+{
+	assert(scale >= 1 && scale <= FONT_MAX_SCALE);
+
+	FB_cmd_t cmd = {.type = FB_CMD_TEXT, .font = font, .scale = scale, .pal = pal};
+	strncpy(cmd.text, text, FB_TEXT_MAX - 1);
+
+	//clip to the screen, a cut multi-byte sequence just renders as the fallback glyph
+	const int w = FONT_measure(font, cmd.text, scale);
+	cmd.rect = (FB_rect_t){x, y, (w < WIDTH - x) ? w : WIDTH - x, font->height * scale};
+	FB_setSlot(slot, &cmd);
+}
+
+void FB_clearSlot(int slot)
+{
+	FB_cmd_t cmd = {.type = FB_CMD_NONE};
+	FB_setSlot(slot, &cmd);
+}
+
+//Pixels of one row of a bitmap command (relative to the command origin)
+static const uint8_t* FB_cmdRow(FB_cmd_t* cmd, int row)
+{
+	const int w = cmd->rect.w;
+
+	switch (cmd->type)
+	{
+	case FB_CMD_BITMAP:
+		return (const uint8_t*)cmd->src + (row * w * PIXEL_SIZE);
+
+	case FB_CMD_RLE:
+		//strips go top to bottom, keep decoding from where the last strip stopped
+		if (cmd->dec_row < 0 || cmd->dec_row > row)
+		{
+			LCD_rleDecoderInit(&cmd->dec, cmd->src);
+			cmd->dec_row = 0;
+		}
+		for (; cmd->dec_row <= row; cmd->dec_row++)
+		{
+			LCD_rleDecode(&cmd->dec, fb_row, w * PIXEL_SIZE);
+		}
+		return fb_row;
+
+	case FB_CMD_GLYPH: {
+		//expansion starts on an even pixel, skip the spare one on odd rows
+		const int first = row * w;
+		LCD_glyphExpand(cmd->src, cmd->pal, first & ~1, w + (first & 1), fb_row);
+		return fb_row + ((first & 1) * PIXEL_SIZE);
+	}
+
+	case FB_CMD_TEXT:
+		FONT_renderRow(cmd->font, cmd->text, cmd->scale, cmd->pal, row, w, fb_row);
+		return fb_row;
+
+	default:
+		return NULL;
+	}
+}
+
+//True when any slot draws inside rect
+static bool FB_covered(const FB_rect_t rect)
+{
+	for (int s = 0; s < FB_MAX_SLOTS; s++)
+	{
+		if (slots[s].type != FB_CMD_NONE && FB_intersects(slots[s].rect, rect))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+//Compose the area covered by a strip from the background and every slot on top of it
+static void FB_rasterize(uint8_t* out, const FB_rect_t strip)
+{
+	const int pixels = strip.w * strip.h;
+
+	for (int i = 0; i < pixels; i++)
+	{
+		out[i * PIXEL_SIZE]     = background_color >> 8;
+		out[i * PIXEL_SIZE + 1] = background_color & 0xFF;
+	}
+
+	for (int s = 0; s < FB_MAX_SLOTS; s++)
+	{
+		FB_cmd_t* cmd = &slots[s];
+		if (cmd->type == FB_CMD_NONE || !FB_intersects(cmd->rect, strip))
+		{
+			continue;
+		}
+
+		const int x0 = (cmd->rect.x > strip.x) ? cmd->rect.x : strip.x;
+		const int x1 = (cmd->rect.x + cmd->rect.w < strip.x + strip.w) ? cmd->rect.x + cmd->rect.w : strip.x + strip.w;
+		const int y0 = (cmd->rect.y > strip.y) ? cmd->rect.y : strip.y;
+		const int y1 = (cmd->rect.y + cmd->rect.h < strip.y + strip.h) ? cmd->rect.y + cmd->rect.h : strip.y + strip.h;
+
+		for (int y = y0; y < y1; y++)
+		{
+			uint8_t* dst = out + (((y - strip.y) * strip.w + (x0 - strip.x)) * PIXEL_SIZE);
+
+			if (cmd->type == FB_CMD_FILL)
+			{
+				for (int x = x0; x < x1; x++)
+				{
+					*dst++ = cmd->color >> 8;
+					*dst++ = cmd->color & 0xFF;
+				}
+			}
+			else
+			{
+				const uint8_t* line = FB_cmdRow(cmd, y - cmd->rect.y);
+				memcpy(dst, line + ((x0 - cmd->rect.x) * PIXEL_SIZE), (x1 - x0) * PIXEL_SIZE);
+			}
+		}
+	}
+}
+
+//Rasterize a rect into strips and hand them to the flush task, caller must hold fb_mutex
+static void FB_sendRect(const FB_rect_t rect, const bool sync)
+{
+	uint8_t buf;
+	const int rows_per_strip = FB_STRIP_SIZE / (rect.w * PIXEL_SIZE);
+
+	//nothing drawn here, stream the background from the fill pattern instead of strips
+	if (!FB_covered(rect))
+	{
+		FB_job_t job = {.fill = true, .sync = sync, .rect = rect};
+		xQueueReceive(fb_free_queue, &job.buf, portMAX_DELAY);
+		xQueueSend(fb_job_queue, &job, portMAX_DELAY);
+		return;
+	}
+
+	for (int row = 0; row < rect.h; row += rows_per_strip)
+	{
+		FB_rect_t strip = {rect.x, rect.y + row, rect.w, (rect.h - row < rows_per_strip) ? rect.h - row : rows_per_strip};
+
+		xQueueReceive(fb_free_queue, &buf, portMAX_DELAY);
+		FB_rasterize(fb_strip[buf], strip);
+
+		FB_job_t job = {
+			.buf = buf,
+			.start = (row == 0),
+			.sync = sync && (row == 0),
+			.rect = rect,
+			.len = strip.w * strip.h * PIXEL_SIZE,
+		};
+		xQueueSend(fb_job_queue, &job, portMAX_DELAY);
+	}
+}
+
+//Wait for the flush task to hand both buffers back
+static void FB_waitStrips(void)
+{
+	uint8_t buf;
+	uint8_t other;
+	xQueueReceive(fb_free_queue, &buf, portMAX_DELAY);
+	xQueueReceive(fb_free_queue, &other, portMAX_DELAY);
+	xQueueSend(fb_free_queue, &buf, 0);
+	xQueueSend(fb_free_queue, &other, 0);
+}
+
+void FB_flush(void)
+{
+	int kept = 0;
+	int sent = 0;
+
+	xSemaphoreTake(fb_mutex, portMAX_DELAY);
+	LCD_TRACE_FRAME_BEGIN();
+	for (int i = 0; i < dirty_count; i++)
+	{
+		//rows being scrolled would land at the wrong line, they wait for FB_scrollEnd
+		if (scroll_active && FB_intersects(FB_band(scroll_rect), dirty[i]))
+		{
+			dirty[kept++] = dirty[i];
+			continue;
+		}
+		FB_sendRect(dirty[i], sent++ == 0);
+	}
+	dirty_count = kept;
+
+	FB_waitStrips();
+	if (sent > 0)
+	{
+		LCD_vsyncFrameDone(fb_sync_us);
+	}
+	LCD_TRACE_FRAME_END();
+	xSemaphoreGive(fb_mutex);
+}
+
+bool FB_scrollBegin(FB_rect_t rect, bool up)
+{
+	bool ok = (rect.h > 1) && (rect.y + rect.h <= HEIGHT);
+
+	xSemaphoreTake(fb_mutex, portMAX_DELAY);
+	ok = ok && !scroll_active;
+
+	//the whole band moves, anything else drawn across it would scroll along
+	for (int s = 0; ok && s < FB_MAX_SLOTS; s++)
+	{
+		if (slots[s].type != FB_CMD_NONE && FB_intersects(slots[s].rect, FB_band(rect)) && !FB_contains(rect, slots[s].rect))
+		{
+			ok = false;
+		}
+	}
+
+	if (ok)
+	{
+		scroll_active = true;
+		scroll_started = false;
+		scroll_up = up;
+		scroll_rect = rect;
+		scroll_rows = 0;
+	}
+	xSemaphoreGive(fb_mutex);
+	return ok;
+}
+
+int FB_scrollStep(int rows)
+{
+	int sent = 0;
+
+	xSemaphoreTake(fb_mutex, portMAX_DELAY);
+	assert(scroll_active);
+	const int h = scroll_rect.h;
+	LCD_TRACE_FRAME_BEGIN();
+
+	if (!scroll_started)
+	{
+		//the scroll streams everything inside rect, only dirt reaching outside it is left for later
+		for (int i = 0; i < dirty_count; )
+		{
+			if (FB_contains(scroll_rect, dirty[i]))
+			{
+				FB_removeDirty(i);
+			}
+			else
+			{
+				i++;
+			}
+		}
+		LCD_setScrollArea(fb_spi, scroll_rect.y + Y_OFFSET, h);
+		scroll_started = true;
+	}
+
+	rows = (rows > h) ? h : rows;
+	if (rows > scroll_rows)
+	{
+		/*
+		 * Memory line n of the band always receives row n of the new content, only the
+		 * order and the scroll offset depend on the direction. Scrolling up by n shows
+		 * lines n.. at the top and wraps lines 0..n-1 in at the bottom, scrolling down
+		 * wraps lines h-n.. in at the top.
+		 */
+		const int first = scroll_up ? scroll_rows : h - rows;
+		const int offset = scroll_up ? rows % h : (h - rows) % h;
+		FB_rect_t exposed = {scroll_rect.x, scroll_rect.y + first, scroll_rect.w, rows - scroll_rows};
+
+		//move during blanking, the entering lines show stale pixels only until their write lands
+		const int64_t sync_us = LCD_vsyncWait();
+		LCD_setScrollStart(fb_spi, scroll_rect.y + Y_OFFSET + offset);
+		FB_sendRect(exposed, false);
+		FB_waitStrips();
+		LCD_vsyncFrameDone(sync_us);
+
+		sent = exposed.w * exposed.h * PIXEL_SIZE;
+		scroll_rows = rows;
+	}
+
+	LCD_TRACE_FRAME_END();
+	xSemaphoreGive(fb_mutex);
+	return sent;
+}
+
+void FB_scrollEnd(void)
+{
+	xSemaphoreTake(fb_mutex, portMAX_DELAY);
+	if (scroll_active)
+	{
+		//every line is back where it is stored once all rows were streamed
+		if (scroll_started)
+		{
+			LCD_scrollStop(fb_spi);
+			if (scroll_rows < scroll_rect.h)
+			{
+				FB_addDirty(scroll_rect);
+			}
+		}
+		scroll_active = false;
+	}
+	xSemaphoreGive(fb_mutex);
+}
@@ -0,0 +1,218 @@
+/**
+ * @file display_fb.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Strip based partial framebuffer for the ST7735s LCD
+ *
+ * The screen is described by a retained draw list: each slot holds one
+ * command (fill, bitmap, compressed bitmap or glyph), slots are drawn in
+ * index order so later slots overlap earlier ones. Changing a slot marks
+ * the old and new bounds dirty. FB_flush rasterizes the dirty regions into
+ * two strip buffers, a flush task sends one strip while the next is composed.
+ * A region can also be replaced through the controller's vertical scroll
+ * (FB_scrollBegin), which only sends the rows that come into view.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include "display_main.h"
+#include "display_rle.h"
+#include "display_glyph.h"
+#include "display_font.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define FB_MAX_SLOTS      16                 //draw list commands
+#define FB_MAX_DIRTY      8                  //dirty rects tracked before forced merging
+#define FB_MERGE_SLACK    64                 //extra pixels we accept to save a window setup
+#define FB_STRIP_SIZE     MAX_TRANSFER_SIZE  //size of each strip buffer (12 full width rows)
+#define FB_TEXT_MAX       32                 //bytes of UTF-8 a text slot holds (including terminator)
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+/* Screen region, x/y are screen coordinates (the panel offset is applied on flush). */
+typedef struct {
+	uint8_t x;
+	uint8_t y;
+	uint8_t w;
+	uint8_t h;
+} FB_rect_t;
+
+/* Draw list command types. */
+typedef enum {
+	FB_CMD_NONE = 0,
+	FB_CMD_FILL,
+	FB_CMD_BITMAP,
+	FB_CMD_RLE,
+	FB_CMD_GLYPH,
+	FB_CMD_TEXT,
+} FB_cmd_type_t;
+
+/* Draw list command. */
+typedef struct {
+	FB_cmd_type_t type;
+	FB_rect_t rect;
+	uint16_t color;            //FB_CMD_FILL
+	const void* src;           //raw bitmap, LCD_rle_asset_t or LCD_glyph_t
+	const LCD_palette_t* pal;  //FB_CMD_GLYPH and FB_CMD_TEXT
+	const FONT_t* font;        //FB_CMD_TEXT
+	uint8_t scale;
+	char text[FB_TEXT_MAX];
+	LCD_rle_decoder_t dec;     //FB_CMD_RLE decoder position while rasterizing
+	int dec_row;
+} FB_cmd_t;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+/** @brief Initialize the framebuffer
+ *
+ *  Clears the draw list, marks the whole screen dirty and starts the flush task.
+ *
+ *  @param spi The device handle used for sending commands.
+ *  @param background RGB565 color behind every slot
+ *  @return Void.
+ */
+void FB_init(spi_device_handle_t spi, uint16_t background);
+
+/** @brief Set a slot to a solid rectangle
+ *
+ *  @param slot Draw list index (higher slots are drawn on top)
+ *  @param rect Region to fill
+ *  @param color RGB565 color
+ *  @return Void.
+ */
+void FB_setFill(int slot, FB_rect_t rect, uint16_t color);
+
+/** @brief Set a slot to a raw bitmap
+ *
+ *  @param slot Draw list index (higher slots are drawn on top)
+ *  @param x x coordinate of the bitmap (top left)
+ *  @param y y coordinate of the bitmap (top left)
+ *  @param w width of the bitmap in pixels
+ *  @param h height of the bitmap in pixels
+ *  @param src RGB565 pixel data, w * h * PIXEL_SIZE bytes (must outlive the slot)
+ *  @return Void.
+ */
+void FB_setBitmap(int slot, uint8_t x, uint8_t y, uint8_t w, uint8_t h, const uint8_t* src);
+
+/** @brief Set a slot to a compressed bitmap
+ *
+ *  @param slot Draw list index (higher slots are drawn on top)
+ *  @param x x coordinate of the bitmap (top left)
+ *  @param y y coordinate of the bitmap (top left)
+ *  @param asset Compressed bitmap
+ *  @return Void.
+ */
+void FB_setRle(int slot, uint8_t x, uint8_t y, const LCD_rle_asset_t* asset);
+
+/** @brief Set a slot to a palette indexed glyph
+ *
+ *  @param slot Draw list index (higher slots are drawn on top)
+ *  @param x x coordinate of the glyph (top left)
+ *  @param y y coordinate of the glyph (top left)
+ *  @param glyph Source glyph
+ *  @param pal Palette built for the glyph bit depth
+ *  @return Void.
+ */
+void FB_setGlyph(int slot, uint8_t x, uint8_t y, const LCD_glyph_t* glyph, const LCD_palette_t* pal);
+
+/** @brief Set a slot to a line of text
+ *
+ *  The string is copied into the slot, setting the same text again marks nothing dirty.
+ *  Text running off the right edge of the screen is clipped.
+ *
+ *  @param slot Draw list index (higher slots are drawn on top)
+ *  @param x x coordinate of the text (top left)
+ *  @param y y coordinate of the text (top left)
+ *  @param text UTF-8 string, truncated to FB_TEXT_MAX - 1 bytes
+ *  @param font Font to draw with
+ *  @param scale Integer scale (1 - FONT_MAX_SCALE)
+ *  @param pal Palette from FONT_makePalette
+ *  @return Void.
+ */
+void FB_setText(int slot, uint8_t x, uint8_t y, const char* text, const FONT_t* font, uint8_t scale, const LCD_palette_t* pal);
+
+/** @brief Remove a slot from the draw list
+ *
+ *  @param slot Draw list index
+ *  @return Void.
+ */
+void FB_clearSlot(int slot);
+
+/** @brief Mark a region dirty
+ *
+ *  Use when something a slot refers to changed in place (e.g. a palette was rebuilt).
+ *  Overlapping or nearby rects are merged so the flush needs as few windows as possible.
+ *
+ *  @param rect Region to be resent on the next flush
+ *  @return Void.
+ */
+void FB_markDirty(FB_rect_t rect);
+
+/** @brief Change the panel power mode
+ *
+ *  Waits for any flush in progress so the mode commands never interleave with a frame.
+ *
+ *  @param mode Requested panel mode
+ *  @return Void.
+ */
+void FB_setPanelMode(LCD_panel_mode_t mode);
+
+/** @brief Reserve the rows of a region for a hardware scroll
+ *
+ *  The controller scrolls whole lines, so nothing outside rect may be drawn across
+ *  its rows. From here on FB_flush leaves those rows alone, set the new slot contents
+ *  inside rect next and then stream them with FB_scrollStep.
+ *
+ *  @param rect Region whose content is replaced (screen coordinates)
+ *  @param up true to move the old content up and bring the new one in from the bottom
+ *  @return false if another scroll is running or other slots cross the rows.
+ */
+bool FB_scrollBegin(FB_rect_t rect, bool up);
+
+/** @brief Advance a hardware scroll
+ *
+ *  Moves the scroll start and sends only the rows of the new content that became
+ *  visible since the last step.
+ *
+ *  @param rows Rows of the new content shown after this step (0 - rect height)
+ *  @return Bytes of pixel data sent.
+ */
+int FB_scrollStep(int rows);
+
+/** @brief Finish a hardware scroll
+ *
+ *  Returns the panel to normal mode. A scroll ended before all rows were streamed
+ *  marks the region dirty so the next flush completes it.
+ *
+ *  @return Void.
+ */
+void FB_scrollEnd(void);
+
+/** @brief Send all dirty regions to the display
+ *
+ *  Returns once the last strip has been sent.
+ *
+ *  @return Void.
+ */
+void FB_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,235 @@
+/**
+ * @file display_font.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Bitmap fonts, UTF-8 text layout and a glyph cache
+ *
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <string.h>
+#include <assert.h>
+#include "display_font.h"
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+/* Glyph unpacked to one palette index per pixel. */
+typedef struct {
+	const LCD_glyph_t* glyph;  //NULL when the entry is free
+	uint32_t last_use;
+	uint8_t index[FONT_CACHE_GLYPH_MAX];
+} FONT_cache_entry_t;
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static FONT_cache_entry_t cache[FONT_CACHE_ENTRIES];
+static uint32_t cache_clock = 0;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+uint32_t FONT_utf8Next(const char** text)
+{
+	const uint8_t* s = (const uint8_t*)*text;
+	uint32_t cp;
+	int extra;
+
+	if (s[0] == 0)
+	{
+		return 0;
+	}
+	if (s[0] < 0x80)
+	{
+		*text += 1;
+		return s[0];
+	}
+
+	if ((s[0] & 0xE0) == 0xC0)
+	{
+		cp = s[0] & 0x1F;
+		extra = 1;
+	}
+	else if ((s[0] & 0xF0) == 0xE0)
+	{
+		cp = s[0] & 0x0F;
+		extra = 2;
+	}
+	else if ((s[0] & 0xF8) == 0xF0)
+	{
+		cp = s[0] & 0x07;
+		extra = 3;
+	}
+	else
+	{
+		*text += 1;
+		return 0xFFFD;
+	}
+
+	for (int i = 1; i <= extra; i++)
+	{
+		if ((s[i] & 0xC0) != 0x80)
+		{
+			*text += 1;
+			return 0xFFFD;
+		}
+		cp = (cp << 6) | (s[i] & 0x3F);
+	}
+
+	*text += extra + 1;
+	return cp;
+}
+
+const LCD_glyph_t* FONT_findGlyph(const FONT_t* font, uint32_t codepoint)
+{
+	for (int attempt = 0; attempt < 2; attempt++)
+	{
+		if (font->codepoints == NULL)
+		{
+			if (codepoint >= font->first && codepoint < font->first + font->count)
+			{
+				return &font->glyphs[codepoint - font->first];
+			}
+		}
+		else
+		{
+			//sparse sets are sorted, binary search
+			int lo = 0;
+			int hi = font->count - 1;
+			while (lo <= hi)
+			{
+				const int mid = (lo + hi) / 2;
+				if (font->codepoints[mid] == codepoint)
+				{
+					return &font->glyphs[mid];
+				}
+				if (font->codepoints[mid] < codepoint)
+				{
+					lo = mid + 1;
+				}
+				else
+				{
+					hi = mid - 1;
+				}
+			}
+		}
+		codepoint = font->fallback;
+	}
+	return NULL;
+}
+
+int FONT_measure(const FONT_t* font, const char* text, int scale)
+{
+	int width = 0;
+	uint32_t cp;
+
+	while ((cp = FONT_utf8Next(&text)) != 0)
+	{
+		const LCD_glyph_t* glyph = FONT_findGlyph(font, cp);
+		if (glyph != NULL)
+		{
+			width += (glyph->width + font->spacing) * scale;
+		}
+	}
+	return width;
+}
+
+//Blend two RGB565 colors, t from 0 (a) to max (b)
+static uint16_t FONT_blend(uint16_t a, uint16_t b, int t, int max)
+{
+	const int r = ((a >> 11) * (max - t) + (b >> 11) * t) / max;
+	const int g = (((a >> 5) & 0x3F) * (max - t) + ((b >> 5) & 0x3F) * t) / max;
+	const int bl = ((a & 0x1F) * (max - t) + (b & 0x1F) * t) / max;
+	return (r << 11) | (g << 5) | bl;
+}
+
+void FONT_makePalette(LCD_palette_t* pal, const FONT_t* font, uint16_t fg, uint16_t bg)
+{
+	uint16_t colors[GLYPH_MAX_COLORS];
+	const int levels = 1 << font->bpp;
+
+	//index 0 is background, the highest index full coverage
+	for (int i = 0; i < levels; i++)
+	{
+		colors[i] = FONT_blend(bg, fg, i, levels - 1);
+	}
+	LCD_paletteInit(pal, colors, font->bpp);
+}
+
+//Unpacked indices of a glyph, least recently used entry is replaced on a miss
+static const uint8_t* FONT_cacheGet(const LCD_glyph_t* glyph)
+{
+	FONT_cache_entry_t* victim = &cache[0];
+	const int pixels = glyph->width * glyph->height;
+	const int mask = (1 << glyph->bpp) - 1;
+
+	assert(pixels <= FONT_CACHE_GLYPH_MAX);
+	cache_clock++;
+
+	for (int i = 0; i < FONT_CACHE_ENTRIES; i++)
+	{
+		if (cache[i].glyph == glyph)
+		{
+			cache[i].last_use = cache_clock;
+			return cache[i].index;
+		}
+		if (cache[i].glyph == NULL || cache[i].last_use < victim->last_use)
+		{
+			victim = &cache[i];
+		}
+	}
+
+	//packed MSB first without row padding
+	for (int p = 0; p < pixels; p++)
+	{
+		const int bit = p * glyph->bpp;
+		victim->index[p] = (glyph->data[bit >> 3] >> (8 - glyph->bpp - (bit & 7))) & mask;
+	}
+	victim->glyph = glyph;
+	victim->last_use = cache_clock;
+	return victim->index;
+}
+
+void FONT_renderRow(const FONT_t* font, const char* text, int scale, const LCD_palette_t* pal, int row, int width, uint8_t* out)
+{
+	const int src_row = row / scale;
+	const uint16_t bg = pal->colors[0];
+	int x = 0;
+	uint32_t cp;
+
+	while (x < width && (cp = FONT_utf8Next(&text)) != 0)
+	{
+		const LCD_glyph_t* glyph = FONT_findGlyph(font, cp);
+		if (glyph == NULL)
+		{
+			continue;
+		}
+
+		const uint8_t* line = FONT_cacheGet(glyph) + (src_row * glyph->width);
+		const int glyph_w = glyph->width * scale;
+		for (int gx = 0; gx < glyph_w && x < width; gx++, x++)
+		{
+			const uint16_t color = pal->colors[line[gx / scale]];
+			out[x * PIXEL_SIZE]     = color >> 8;
+			out[x * PIXEL_SIZE + 1] = color & 0xFF;
+		}
+		for (int s = 0; s < font->spacing * scale && x < width; s++, x++)
+		{
+			out[x * PIXEL_SIZE]     = bg >> 8;
+			out[x * PIXEL_SIZE + 1] = bg & 0xFF;
+		}
+	}
+
+	for (; x < width; x++)
+	{
+		out[x * PIXEL_SIZE]     = bg >> 8;
+		out[x * PIXEL_SIZE + 1] = bg & 0xFF;
+	}
+}
@@ -0,0 +1,110 @@
+/**
+ * @file display_font.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Bitmap fonts, UTF-8 text layout and a glyph cache
+ *
+ * A font is a set of palette indexed glyphs (1 bpp, or 2/4 bpp for anti-aliased
+ * fonts) looked up by codepoint. Text is drawn at integer scales through the
+ * framebuffer (FB_setText). Glyphs are unpacked to one palette index per pixel
+ * into a small LRU cache so a text row only costs a lookup per pixel.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include <inttypes.h>
+#include "display_glyph.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define FONT_MAX_SCALE       4
+#define FONT_CACHE_ENTRIES   8
+#define FONT_CACHE_GLYPH_MAX 256  //pixels of the largest glyph the cache holds
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+/* Font, glyphs share the height and bit depth. */
+typedef struct {
+	uint8_t height;
+	uint8_t bpp;                 //1, 2 or 4
+	uint8_t spacing;             //blank columns after every glyph
+	uint16_t count;
+	uint32_t first;              //codepoint of glyphs[0] when codepoints is NULL
+	const uint32_t* codepoints;  //sorted codepoint of each glyph, NULL for a contiguous range
+	const LCD_glyph_t* glyphs;
+	uint32_t fallback;           //drawn for codepoints the font does not have
+} FONT_t;
+
+/* Built in 5x7 ASCII font (0x20 - 0x7E). */
+extern const FONT_t font_5x7;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+/** @brief Decode the next UTF-8 codepoint
+ *
+ *  Malformed sequences decode to U+FFFD and skip one byte.
+ *
+ *  @param text Current position, advanced past the codepoint
+ *  @return Codepoint, 0 at the end of the string.
+ */
+uint32_t FONT_utf8Next(const char** text);
+
+/** @brief Find the glyph for a codepoint
+ *
+ *  @param font Font to search
+ *  @param codepoint Unicode codepoint
+ *  @return Glyph, the fallback glyph, or NULL if the font has neither.
+ */
+const LCD_glyph_t* FONT_findGlyph(const FONT_t* font, uint32_t codepoint);
+
+/** @brief Width of a string in pixels
+ *
+ *  @param font Font used to draw
+ *  @param text UTF-8 string
+ *  @param scale Integer scale (1 - FONT_MAX_SCALE)
+ *  @return Width in pixels.
+ */
+int FONT_measure(const FONT_t* font, const char* text, int scale);
+
+/** @brief Build a palette that blends from the background to the text color
+ *
+ *  @param pal Palette to initialize
+ *  @param font Font the palette is used with
+ *  @param fg RGB565 text color
+ *  @param bg RGB565 background color
+ *  @return Void.
+ */
+void FONT_makePalette(LCD_palette_t* pal, const FONT_t* font, uint16_t fg, uint16_t bg);
+
+/** @brief Render one row of a string
+ *
+ *  Not thread safe (shares the glyph cache), the framebuffer calls it under its lock.
+ *
+ *  @param font Font used to draw
+ *  @param text UTF-8 string
+ *  @param scale Integer scale (1 - FONT_MAX_SCALE)
+ *  @param pal Palette from FONT_makePalette
+ *  @param row Row inside the text, 0 to font height * scale - 1
+ *  @param width Pixels to render, columns past the end of the text get the background
+ *  @param out RGB565 destination, width * PIXEL_SIZE bytes
+ *  @return Void.
+ */
+void FONT_renderRow(const FONT_t* font, const char* text, int scale, const LCD_palette_t* pal, int row, int width, uint8_t* out);
+
+#ifdef __cplusplus
+}
+#endif
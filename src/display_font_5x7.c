@@ -0,0 +1,226 @@
+/**
+ * @file display_font_5x7.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Built in 5x7 ASCII font
+ *
+ * Rows packed MSB first (35 bits per glyph), converted from the classic
+ * column ordered 5x7 LCD font.
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include "display_font.h"
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static const uint8_t font_5x7_bitmap[95][5] = {
+	{0x00, 0x00, 0x00, 0x00, 0x00}, // ' '
+	{0x21, 0x08, 0x42, 0x00, 0x80}, // '!'
+	{0x52, 0x94, 0x00, 0x00, 0x00}, // '"'
+	{0x52, 0xBE, 0xAF, 0xA9, 0x40}, // '#'
+	{0x23, 0xE8, 0xE2, 0xF8, 0x80}, // '$'
+	{0xC6, 0x44, 0x44, 0x4C, 0x60}, // '%'
+	{0x64, 0xA8, 0x8A, 0xC9, 0xA0}, // '&'
+	{0x61, 0x10, 0x00, 0x00, 0x00}, // '''
+	{0x11, 0x10, 0x84, 0x10, 0x40}, // '('
+	{0x41, 0x04, 0x21, 0x11, 0x00}, // ')'
+	{0x02, 0x89, 0xF2, 0x28, 0x00}, // '*'
+	{0x01, 0x09, 0xF2, 0x10, 0x00}, // '+'
+	{0x00, 0x00, 0x06, 0x11, 0x00}, // ','
+	{0x00, 0x01, 0xF0, 0x00, 0x00}, // '-'
+	{0x00, 0x00, 0x00, 0x31, 0x80}, // '.'
+	{0x00, 0x44, 0x44, 0x40, 0x00}, // '/'
+	{0x74, 0x67, 0x5C, 0xC5, 0xC0}, // '0'
+	{0x23, 0x08, 0x42, 0x11, 0xC0}, // '1'
+	{0x74, 0x42, 0x22, 0x23, 0xE0}, // '2'
+	{0xF8, 0x88, 0x20, 0xC5, 0xC0}, // '3'
+	{0x11, 0x95, 0x2F, 0x88, 0x40}, // '4'
+	{0xFC, 0x3C, 0x10, 0xC5, 0xC0}, // '5'
+	{0x32, 0x21, 0xE8, 0xC5, 0xC0}, // '6'
+	{0xF8, 0x44, 0x44, 0x21, 0x00}, // '7'
+	{0x74, 0x62, 0xE8, 0xC5, 0xC0}, // '8'
+	{0x74, 0x62, 0xF0, 0x89, 0x80}, // '9'
+	{0x03, 0x18, 0x06, 0x30, 0x00}, // ':'
+	{0x03, 0x18, 0x06, 0x11, 0x00}, // ';'
+	{0x11, 0x11, 0x04, 0x10, 0x40}, // '<'
+	{0x00, 0x3E, 0x0F, 0x80, 0x00}, // '='
+	{0x41, 0x04, 0x11, 0x11, 0x00}, // '>'
+	{0x74, 0x42, 0x22, 0x00, 0x80}, // '?'
+	{0x74, 0x42, 0xDA, 0xD5, 0xC0}, // '@'
+	{0x74, 0x63, 0x1F, 0xC6, 0x20}, // 'A'
+	{0xF4, 0x63, 0xE8, 0xC7, 0xC0}, // 'B'
+	{0x74, 0x61, 0x08, 0x45, 0xC0}, // 'C'
+	{0xE4, 0xA3, 0x18, 0xCB, 0x80}, // 'D'
+	{0xFC, 0x21, 0xE8, 0x43, 0xE0}, // 'E'
+	{0xFC, 0x21, 0xC8, 0x42, 0x00}, // 'F'
+	{0x74, 0x61, 0x09, 0xC5, 0xC0}, // 'G'
+	{0x8C, 0x63, 0xF8, 0xC6, 0x20}, // 'H'
+	{0x71, 0x08, 0x42, 0x11, 0xC0}, // 'I'
+	{0x38, 0x84, 0x21, 0x49, 0x80}, // 'J'
+	{0x8C, 0xA9, 0x8A, 0x4A, 0x20}, // 'K'
+	{0x84, 0x21, 0x08, 0x43, 0xE0}, // 'L'
+	{0x8E, 0xEB, 0x18, 0xC6, 0x20}, // 'M'
+	{0x8C, 0x73, 0x59, 0xC6, 0x20}, // 'N'
+	{0x74, 0x63, 0x18, 0xC5, 0xC0}, // 'O'
+	{0xF4, 0x63, 0xE8, 0x42, 0x00}, // 'P'
+	{0x74, 0x63, 0x1A, 0xC9, 0xA0}, // 'Q'
+	{0xF4, 0x63, 0xEA, 0x4A, 0x20}, // 'R'
+	{0x7C, 0x20, 0xE0, 0x87, 0xC0}, // 'S'
+	{0xF9, 0x08, 0x42, 0x10, 0x80}, // 'T'
+	{0x8C, 0x63, 0x18, 0xC5, 0xC0}, // 'U'
+	{0x8C, 0x63, 0x18, 0xA8, 0x80}, // 'V'
+	{0x8C, 0x63, 0x5A, 0xEE, 0x20}, // 'W'
+	{0x8C, 0x54, 0x45, 0x46, 0x20}, // 'X'
+	{0x8C, 0x54, 0x42, 0x10, 0x80}, // 'Y'
+	{0xF8, 0x44, 0x44, 0x43, 0xE0}, // 'Z'
+	{0x39, 0x08, 0x42, 0x10, 0xE0}, // '['
+	{0x04, 0x10, 0x41, 0x04, 0x00}, // '\\'
+	{0xE1, 0x08, 0x42, 0x13, 0x80}, // ']'
+	{0x22, 0xA2, 0x00, 0x00, 0x00}, // '^'
+	{0x00, 0x00, 0x00, 0x03, 0xE0}, // '_'
+	{0x41, 0x04, 0x00, 0x00, 0x00}, // '`'
+	{0x00, 0x1C, 0x17, 0xC5, 0xE0}, // 'a'
+	{0x84, 0x2D, 0x98, 0xC7, 0xC0}, // 'b'
+	{0x00, 0x1D, 0x08, 0x45, 0xC0}, // 'c'
+	{0x08, 0x5B, 0x38, 0xC5, 0xE0}, // 'd'
+	{0x00, 0x1D, 0x1F, 0xC1, 0xC0}, // 'e'
+	{0x32, 0x51, 0xC4, 0x21, 0x00}, // 'f'
+	{0x00, 0x1F, 0x17, 0x84, 0xC0}, // 'g'
+	{0x84, 0x2D, 0x98, 0xC6, 0x20}, // 'h'
+	{0x20, 0x18, 0x42, 0x11, 0xC0}, // 'i'
+	{0x10, 0x0C, 0x21, 0x49, 0x80}, // 'j'
+	{0x42, 0x12, 0xA6, 0x29, 0x20}, // 'k'
+	{0x61, 0x08, 0x42, 0x11, 0xC0}, // 'l'
+	{0x00, 0x35, 0x5A, 0xC6, 0x20}, // 'm'
+	{0x00, 0x2D, 0x98, 0xC6, 0x20}, // 'n'
+	{0x00, 0x1D, 0x18, 0xC5, 0xC0}, // 'o'
+	{0x00, 0x3D, 0x1F, 0x42, 0x00}, // 'p'
+	{0x00, 0x1B, 0x37, 0x84, 0x20}, // 'q'
+	{0x00, 0x2D, 0x98, 0x42, 0x00}, // 'r'
+	{0x00, 0x1D, 0x07, 0x07, 0xC0}, // 's'
+	{0x42, 0x38, 0x84, 0x24, 0xC0}, // 't'
+	{0x00, 0x23, 0x18, 0xCD, 0xA0}, // 'u'
+	{0x00, 0x23, 0x18, 0xA8, 0x80}, // 'v'
+	{0x00, 0x23, 0x1A, 0xD5, 0x40}, // 'w'
+	{0x00, 0x22, 0xA2, 0x2A, 0x20}, // 'x'
+	{0x00, 0x23, 0x17, 0x85, 0xC0}, // 'y'
+	{0x00, 0x3E, 0x22, 0x23, 0xE0}, // 'z'
+	{0x11, 0x08, 0x82, 0x10, 0x40}, // '{'
+	{0x21, 0x08, 0x42, 0x10, 0x80}, // '|'
+	{0x41, 0x08, 0x22, 0x11, 0x00}, // '}'
+	{0x45, 0x44, 0x00, 0x00, 0x00}, // '~'
+};
+
+static const LCD_glyph_t font_5x7_glyphs[95] = {
+	{5, 7, 1, font_5x7_bitmap[0]},
+	{5, 7, 1, font_5x7_bitmap[1]},
+	{5, 7, 1, font_5x7_bitmap[2]},
+	{5, 7, 1, font_5x7_bitmap[3]},
+	{5, 7, 1, font_5x7_bitmap[4]},
+	{5, 7, 1, font_5x7_bitmap[5]},
+	{5, 7, 1, font_5x7_bitmap[6]},
+	{5, 7, 1, font_5x7_bitmap[7]},
+	{5, 7, 1, font_5x7_bitmap[8]},
+	{5, 7, 1, font_5x7_bitmap[9]},
+	{5, 7, 1, font_5x7_bitmap[10]},
+	{5, 7, 1, font_5x7_bitmap[11]},
+	{5, 7, 1, font_5x7_bitmap[12]},
+	{5, 7, 1, font_5x7_bitmap[13]},
+	{5, 7, 1, font_5x7_bitmap[14]},
+	{5, 7, 1, font_5x7_bitmap[15]},
+	{5, 7, 1, font_5x7_bitmap[16]},
+	{5, 7, 1, font_5x7_bitmap[17]},
+	{5, 7, 1, font_5x7_bitmap[18]},
+	{5, 7, 1, font_5x7_bitmap[19]},
+	{5, 7, 1, font_5x7_bitmap[20]},
+	{5, 7, 1, font_5x7_bitmap[21]},
+	{5, 7, 1, font_5x7_bitmap[22]},
+	{5, 7, 1, font_5x7_bitmap[23]},
+	{5, 7, 1, font_5x7_bitmap[24]},
+	{5, 7, 1, font_5x7_bitmap[25]},
+	{5, 7, 1, font_5x7_bitmap[26]},
+	{5, 7, 1, font_5x7_bitmap[27]},
+	{5, 7, 1, font_5x7_bitmap[28]},
+	{5, 7, 1, font_5x7_bitmap[29]},
+	{5, 7, 1, font_5x7_bitmap[30]},
+	{5, 7, 1, font_5x7_bitmap[31]},
+	{5, 7, 1, font_5x7_bitmap[32]},
+	{5, 7, 1, font_5x7_bitmap[33]},
+	{5, 7, 1, font_5x7_bitmap[34]},
+	{5, 7, 1, font_5x7_bitmap[35]},
+	{5, 7, 1, font_5x7_bitmap[36]},
+	{5, 7, 1, font_5x7_bitmap[37]},
+	{5, 7, 1, font_5x7_bitmap[38]},
+	{5, 7, 1, font_5x7_bitmap[39]},
+	{5, 7, 1, font_5x7_bitmap[40]},
+	{5, 7, 1, font_5x7_bitmap[41]},
+	{5, 7, 1, font_5x7_bitmap[42]},
+	{5, 7, 1, font_5x7_bitmap[43]},
+	{5, 7, 1, font_5x7_bitmap[44]},
+	{5, 7, 1, font_5x7_bitmap[45]},
+	{5, 7, 1, font_5x7_bitmap[46]},
+	{5, 7, 1, font_5x7_bitmap[47]},
+	{5, 7, 1, font_5x7_bitmap[48]},
+	{5, 7, 1, font_5x7_bitmap[49]},
+	{5, 7, 1, font_5x7_bitmap[50]},
+	{5, 7, 1, font_5x7_bitmap[51]},
+	{5, 7, 1, font_5x7_bitmap[52]},
+	{5, 7, 1, font_5x7_bitmap[53]},
+	{5, 7, 1, font_5x7_bitmap[54]},
+	{5, 7, 1, font_5x7_bitmap[55]},
+	{5, 7, 1, font_5x7_bitmap[56]},
+	{5, 7, 1, font_5x7_bitmap[57]},
+	{5, 7, 1, font_5x7_bitmap[58]},
+	{5, 7, 1, font_5x7_bitmap[59]},
+	{5, 7, 1, font_5x7_bitmap[60]},
+	{5, 7, 1, font_5x7_bitmap[61]},
+	{5, 7, 1, font_5x7_bitmap[62]},
+	{5, 7, 1, font_5x7_bitmap[63]},
+	{5, 7, 1, font_5x7_bitmap[64]},
+	{5, 7, 1, font_5x7_bitmap[65]},
+	{5, 7, 1, font_5x7_bitmap[66]},
+	{5, 7, 1, font_5x7_bitmap[67]},
+	{5, 7, 1, font_5x7_bitmap[68]},
+	{5, 7, 1, font_5x7_bitmap[69]},
+	{5, 7, 1, font_5x7_bitmap[70]},
+	{5, 7, 1, font_5x7_bitmap[71]},
+	{5, 7, 1, font_5x7_bitmap[72]},
+	{5, 7, 1, font_5x7_bitmap[73]},
+	{5, 7, 1, font_5x7_bitmap[74]},
+	{5, 7, 1, font_5x7_bitmap[75]},
+	{5, 7, 1, font_5x7_bitmap[76]},
+	{5, 7, 1, font_5x7_bitmap[77]},
+	{5, 7, 1, font_5x7_bitmap[78]},
+	{5, 7, 1, font_5x7_bitmap[79]},
+	{5, 7, 1, font_5x7_bitmap[80]},
+	{5, 7, 1, font_5x7_bitmap[81]},
+	{5, 7, 1, font_5x7_bitmap[82]},
+	{5, 7, 1, font_5x7_bitmap[83]},
+	{5, 7, 1, font_5x7_bitmap[84]},
+	{5, 7, 1, font_5x7_bitmap[85]},
+	{5, 7, 1, font_5x7_bitmap[86]},
+	{5, 7, 1, font_5x7_bitmap[87]},
+	{5, 7, 1, font_5x7_bitmap[88]},
+	{5, 7, 1, font_5x7_bitmap[89]},
+	{5, 7, 1, font_5x7_bitmap[90]},
+	{5, 7, 1, font_5x7_bitmap[91]},
+	{5, 7, 1, font_5x7_bitmap[92]},
+	{5, 7, 1, font_5x7_bitmap[93]},
+	{5, 7, 1, font_5x7_bitmap[94]},
+};
+
+const FONT_t font_5x7 = {
+	.height = 7,
+	.bpp = 1,
+	.spacing = 1,
+	.count = 95,
+	.first = 0x20,
+	.codepoints = NULL,
+	.glyphs = font_5x7_glyphs,
+	.fallback = '?',
+};
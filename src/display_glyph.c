@@ -0,0 +1,108 @@
+/**
+ * @file display_glyph.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Palette indexed glyph expansion for the ST7735s LCD
+ *
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <string.h>
+#include <assert.h>
+#include "esp_attr.h"
+#include "display_glyph.h"
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+//staging buffers, one is expanded into while the other is being sent
+static DMA_ATTR uint8_t glyph_tx[2][GLYPH_TX_SIZE];
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+void LCD_paletteInit(LCD_palette_t* pal, const uint16_t* colors, const uint8_t bpp)
+{
+	const int num_colors = 1 << bpp;
+	const int entries = 1 << (2 * bpp);
+
+	assert(bpp == 1 || bpp == 2 || bpp == 4);
+
+	pal->bpp = bpp;
+	memcpy(pal->colors, colors, num_colors * sizeof(uint16_t));
+
+	//every combination of two indices, stored as the 4 bytes the display expects
+	for (int i = 0; i < entries; i++)
+	{
+		const uint16_t c0 = colors[i >> bpp];
+		const uint16_t c1 = colors[i & (num_colors - 1)];
+		const uint8_t px[4] = {c0 >> 8, c0 & 0xFF, c1 >> 8, c1 & 0xFF};
+		memcpy(&pal->pairs[i], px, sizeof(px));
+	}
+}
+
+int LCD_glyphExpand(const LCD_glyph_t* glyph, const LCD_palette_t* pal, const int first_pixel, const int pixel_count, uint8_t* out)
+{
+	const int bits = 2 * pal->bpp; //bits per pixel pair, always divides a byte
+	const uint32_t mask = (1 << bits) - 1;
+	const int pairs = (pixel_count + 1) / 2;
+	uint32_t* dst = (uint32_t*)out;
+	int bit = first_pixel * pal->bpp;
+
+	assert(glyph->bpp == pal->bpp);
+	assert((first_pixel & 1) == 0 && ((uintptr_t)out & 3) == 0);
+
+	if (bits == 8)
+	{
+		//4 bpp, one source byte is exactly one pair
+		const uint8_t* src = &glyph->data[bit >> 3];
+		for (int i = 0; i < pairs; i++)
+		{
+			dst[i] = pal->pairs[src[i]];
+		}
+	}
+	else
+	{
+		for (int i = 0; i < pairs; i++, bit += bits)
+		{
+			const uint8_t byte = glyph->data[bit >> 3];
+			dst[i] = pal->pairs[(byte >> (8 - bits - (bit & 7))) & mask];
+		}
+	}
+
+	return pairs * 4;
+}
+
+void LCD_sendGlyph(spi_device_handle_t spi, const LCD_glyph_t* glyph, const LCD_palette_t* pal)
+{
+	const int total = glyph->width * glyph->height;
+	const int chunk_pixels = GLYPH_TX_SIZE / PIXEL_SIZE;
+	LCD_frame_handle_t pending = NULL;
+	int buf = 0;
+
+	for (int pixel = 0; pixel < total; pixel += chunk_pixels)
+	{
+		const int count = (total - pixel < chunk_pixels) ? total - pixel : chunk_pixels;
+
+		LCD_glyphExpand(glyph, pal, pixel, count, glyph_tx[buf]);
+
+		if (pending)
+		{
+			LCD_waitFrame(pending);
+		}
+		pending = (pixel == 0)
+			? LCD_sendFrameAsync(spi, glyph_tx[buf], count * PIXEL_SIZE)
+			: LCD_continueFrameAsync(spi, glyph_tx[buf], count * PIXEL_SIZE);
+		buf ^= 1;
+	}
+
+	if (pending)
+	{
+		LCD_waitFrame(pending);
+	}
+}
@@ -0,0 +1,93 @@
+/**
+ * @file display_glyph.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Palette indexed glyphs (1/2/4 bpp) and RGB565 expansion
+ *
+ * Glyph pixels are stored as palette indices packed MSB first with no row
+ * padding, so a glyph is one continuous stream of width * height indices.
+ * Expansion looks up two pixels at a time from a table built from the palette
+ * and writes them with a single 32 bit store. Tables are generated from the PNG
+ * sources by tools/png_assets.py.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include <inttypes.h>
+#include "display_main.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define GLYPH_MAX_COLORS  16
+#define GLYPH_TX_SIZE     1024 //size of each staging buffer used by LCD_sendGlyph (multiple of 4)
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+/* Palette indexed bitmap. */
+typedef struct {
+	uint8_t width;
+	uint8_t height;
+	uint8_t bpp;         //1, 2 or 4
+	const uint8_t* data; //packed indices, (width * height * bpp + 7) / 8 bytes
+} LCD_glyph_t;
+
+/* Palette with its pixel pair lookup table. */
+typedef struct {
+	uint8_t bpp;
+	uint16_t colors[GLYPH_MAX_COLORS];     //RGB565
+	uint32_t pairs[1 << (2 * 4)];          //two pixels in display byte order, indexed by two packed indices
+} LCD_palette_t;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+/** @brief Build a palette
+ *
+ *  Can be called again at any time to recolor every glyph drawn with it (themes).
+ *
+ *  @param pal Palette to initialize
+ *  @param colors RGB565 colors, 1 << bpp entries
+ *  @param bpp Bits per pixel of the glyphs that will use this palette
+ *  @return Void.
+ */
+void LCD_paletteInit(LCD_palette_t* pal, const uint16_t* colors, const uint8_t bpp);
+
+/** @brief Expand glyph pixels to RGB565
+ *
+ *  @param glyph Source glyph
+ *  @param pal Palette built for the glyph bit depth
+ *  @param first_pixel Index of the first pixel to expand, must be even
+ *  @param pixel_count Number of pixels, rounded up to even (out must have room for it)
+ *  @param out Destination, must be 4 byte aligned
+ *  @return Number of bytes written.
+ */
+int LCD_glyphExpand(const LCD_glyph_t* glyph, const LCD_palette_t* pal, const int first_pixel, const int pixel_count, uint8_t* out);
+
+/** @brief Send a glyph to the display
+ *
+ *  Same contract as LCD_sendFrame (drawing window must already be set), the glyph is
+ *  expanded straight into small DMA staging buffers while the previous one is being sent.
+ *
+ *  @param spi The device handle used for sending commands.
+ *  @param glyph Source glyph
+ *  @param pal Palette built for the glyph bit depth
+ *  @return Void.
+ */
+void LCD_sendGlyph(spi_device_handle_t spi, const LCD_glyph_t* glyph, const LCD_palette_t* pal);
+
+#ifdef __cplusplus
+}
+#endif
@@ -11,6 +11,11 @@
  *   INCLUDES
  ***********************************************/
 
+#include <string.h>
+#include <assert.h>
+#include "esp_attr.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "esp_lcd_panel_io.h"
 #include "driver/spi_master.h"
 #include "esp_sntp.h"
@@ -18,6 +23,8 @@
 #include "esp_system.h"
 #include "esp_log.h"
 #include "display_main.h"
+#include "display_port.h"
+#include "display_bus.h"
 
 /************************************************
  *  DEFINITIONS	
@@ -29,6 +36,7 @@
 #define CMD_SWRESET 0x01 // Software Reset 
 #define CMD_SLPIN   0x10 // Sleep In 
 #define CMD_SLPOUT  0x11 // Sleep Out
+#define CMD_NORON   0x13 // Normal Display Mode On
 #define CMD_INVOFF  0x20 // Display Inversion Off
 #define CMD_INVON   0x21 // Display Inversion On
 #define CMD_GAMSET  0x26 // Gamma Set
@@ -37,40 +45,59 @@
 #define CMD_CASET   0x2A // Column Address Set 
 #define CMD_RASET   0x2B // Row Address Set 
 #define CMD_RAMWR   0x2C // Memory Write 
+#define CMD_VSCRDEF 0x33 // Vertical Scrolling Definition
 #define CMD_TEOFF   0x34 // Tearing Effect Line OFF 
 #define CMD_TEON    0x35 // Tearing Effect Line ON 
 #define CMD_MADCTL  0x36 // Memory Data Access Control 
+#define CMD_VSCSAD  0x37 // Vertical Scroll Start Address of RAM
 #define CMD_IDMOFF  0x38 // Idle Mode Off 
 #define CMD_IDMON   0x39 // Idle Mode On 
 #define CMD_COLMOD  0x3A // Interface Pixel Format
 
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+//State of the (single) frame currently being pushed through the SPI queue
+static LCD_frame_t frame_state;
+
+//Current panel power mode, the panel starts in normal mode after LCD_init
+static LCD_panel_mode_t panel_mode = LCD_PANEL_NORMAL;
+
+//Solid color pattern streamed repeatedly by LCD_fillRect
+static DMA_ATTR uint8_t fill_pattern[LCD_FILL_PATTERN_SIZE];
+
 /************************************************
  *  FUNCTIONS
  ***********************************************/
 
+//Runs in ISR context right before each transaction, drives the D/C line from t->user
+void IRAM_ATTR LCD_spiPreTransferCallback(spi_transaction_t *t)
+{
+	int dc = (int)(intptr_t)t->user;
+	LCD_PORT_SET_LEVEL(PIN_DATA_NCOMMAND, dc);
+}
+
 //Abstraction for sending commands
 void LCD_sendCommand(spi_device_handle_t spi, const uint8_t cmd)
 {
-	//Set data /command line low
-	gpio_set_level(PIN_DATA_NCOMMAND, LOW);
-
 	//Send SPI transfer
 	esp_err_t ret;
     spi_transaction_t t;
     memset(&t, 0, sizeof(t));       //Zero out the transaction
     t.length = 8;                   //Command is 8 bits
     t.tx_buffer = &cmd;             //The data is the cmd itself
+    t.user = (void*)LOW;            //D/C low (command)
 
-	ret = spi_device_polling_transmit(spi, &t);
+	const int64_t start = LCD_TRACE_NOW();
+	ret = LCD_PORT_POLL_TRANS(spi, &t);
     assert(ret == ESP_OK);
+	LCD_TRACE_RECORD(LCD_TRACE_CMD, 1, start);
 }
 
 //Abstraction for sending data
 void LCD_sendData(spi_device_handle_t spi, const uint8_t *data, const int len)
 {
-	//Set data /command line high
-	gpio_set_level(PIN_DATA_NCOMMAND, HIGH);
-
 	//Send Spi transfer
 	esp_err_t ret;
     spi_transaction_t t;
@@ -80,32 +107,37 @@ void LCD_sendData(spi_device_handle_t spi, const uint8_t *data, const int len)
     memset(&t, 0, sizeof(t));       //Zero out the transaction
     t.length = len * 8;             //length in bits, len in bytes
     t.tx_buffer = data;             
+    t.user = (void*)HIGH;           //D/C high (data)
 
-    ret = spi_device_polling_transmit(spi, &t); //Transmit!
+    const int64_t start = LCD_TRACE_NOW();
+    ret = LCD_PORT_POLL_TRANS(spi, &t); //Transmit!
     assert(ret == ESP_OK);
+    LCD_TRACE_RECORD(LCD_TRACE_DATA, len, start);
 }
 
 //TODO: figure out buffering and how transactions will work in terms of size
 void LCD_init(spi_device_handle_t spi)
 {
+	LCD_TRACE_TAG("init");
+
 	//Initialize remaining pins
 	gpio_config_t io_conf = {};
     io_conf.pin_bit_mask = ((1ULL << PIN_DATA_NCOMMAND) | (1ULL << PIN_RESET) | (1ULL << PIN_CHIP_SEL));
     io_conf.mode = GPIO_MODE_OUTPUT;
     io_conf.pull_up_en = true;
-    gpio_config(&io_conf);
+    LCD_PORT_CONFIG_OUTPUTS(&io_conf);
 
 	//Reset display
-    gpio_set_level(PIN_RESET, LOW);
-    vTaskDelay(100 / portTICK_PERIOD_MS);
-    gpio_set_level(PIN_RESET, HIGH);
-    vTaskDelay(100 / portTICK_PERIOD_MS);
+    LCD_PORT_SET_LEVEL(PIN_RESET, LOW);
+    LCD_PORT_DELAY_MS(100);
+    LCD_PORT_SET_LEVEL(PIN_RESET, HIGH);
+    LCD_PORT_DELAY_MS(100);
 
 	//Turn off sleep mode
 	LCD_sendCommand(spi, CMD_SLPOUT);
 
 	//Required delay after exiting sleep
-	vTaskDelay(120 / portTICK_PERIOD_MS);
+	LCD_PORT_DELAY_MS(120);
 	
 	/*  Send initialization commands */
 
@@ -132,36 +164,295 @@ void LCD_init(spi_device_handle_t spi)
 	LCD_sendCommand(spi, CMD_DISPON);
 }
 
-void LCD_sendFrame(spi_device_handle_t spi, uint8_t* buffer, const int frame_size, const int chunk_number)
+//Queue the next item of a frame: header commands first, then the data chunks
+static void LCD_queueFrameItem(LCD_frame_t* frame)
+{
+	esp_err_t ret;
+	spi_transaction_t* t;
+	const int item = frame->queued;
+
+	if (item < frame->header.count)
+	{
+		//header transactions are prebuilt and stay in the frame until it completes
+		t = &frame->header.trans[item];
+	}
+	else
+	{
+		const int offset = (item - frame->header.count) * frame->chunk_size;
+		const int len = (frame->frame_size - offset < frame->chunk_size) ? frame->frame_size - offset : frame->chunk_size;
+		t = &frame->trans[frame->queued % LCD_QUEUE_DEPTH];
+		memset(t, 0, sizeof(*t));
+		t->length = len * 8;
+		t->tx_buffer = frame->repeat ? frame->buffer : frame->buffer + offset;
+		t->user = (void*)HIGH;
+	}
+
+#if LCD_TRACE_ENABLE
+	frame->trace_start[frame->queued % LCD_QUEUE_DEPTH] = LCD_TRACE_NOW();
+#endif
+	ret = LCD_PORT_QUEUE_TRANS(frame->spi, t, portMAX_DELAY);
+	assert(ret == ESP_OK);
+	frame->queued++;
+}
+
+static LCD_frame_handle_t LCD_startFrame(spi_device_handle_t spi, const LCD_batch_t* header, const uint8_t* buffer, const int frame_size, const int chunk_size, const bool repeat)
+{
+	LCD_frame_t* frame = &frame_state;
+
+	//only one frame may own the queue at a time
+	assert(frame->completed == frame->queued);
+
+	frame->spi = spi;
+	frame->buffer = buffer;
+	frame->frame_size = frame_size;
+	frame->chunk_size = chunk_size;
+	frame->repeat = repeat;
+	if (header != NULL)
+	{
+		memcpy(&frame->header, header, sizeof(*header));
+	}
+	else
+	{
+		frame->header.count = 0;
+	}
+	frame->total = frame->header.count + ((frame_size + chunk_size - 1) / chunk_size);
+	frame->queued = 0;
+	frame->completed = 0;
+
+	//fill the queue, remaining chunks are queued as earlier ones complete
+	while (frame->queued < frame->total && frame->queued < LCD_QUEUE_DEPTH)
+	{
+		LCD_queueFrameItem(frame);
+	}
+
+	return frame;
+}
+
+LCD_frame_handle_t LCD_sendFrameAsync(spi_device_handle_t spi, const uint8_t* buffer, const int frame_size)
+{
+	LCD_batch_t header;
+	LCD_batchReset(&header);
+	LCD_batchAdd(&header, CMD_RAMWR, NULL, 0);
+
+	LCD_TRACE_TAG("frame");
+	return LCD_startFrame(spi, &header, buffer, frame_size, LCD_busChunkSize(frame_size), false);
+}
+
+LCD_frame_handle_t LCD_sendWindowAsync(spi_device_handle_t spi, const uint8_t x, const uint8_t y, const uint8_t w, const uint8_t h,
+	const uint8_t* buffer, const int frame_size)
+{
+	LCD_batch_t header;
+	LCD_batchReset(&header);
+	LCD_batchWindow(&header, x, y, w - 1, h - 1);
+	LCD_batchAdd(&header, CMD_RAMWR, NULL, 0);
+
+	LCD_TRACE_TAG("frame");
+	return LCD_startFrame(spi, &header, buffer, frame_size, LCD_busChunkSize(frame_size), false);
+}
+
+LCD_frame_handle_t LCD_continueFrameAsync(spi_device_handle_t spi, const uint8_t* buffer, const int frame_size)
+{
+	LCD_TRACE_TAG("frame");
+	return LCD_startFrame(spi, NULL, buffer, frame_size, LCD_busChunkSize(frame_size), false);
+}
+
+bool LCD_frameService(LCD_frame_handle_t frame, TickType_t ticks_to_wait)
+{
+	spi_transaction_t* rtrans;
+
+	while (frame->completed < frame->queued)
+	{
+		if (LCD_PORT_GET_RESULT(frame->spi, &rtrans, ticks_to_wait) != ESP_OK)
+		{
+			break; //nothing finished yet
+		}
+#if LCD_TRACE_ENABLE
+		//transactions complete in queue order
+		LCD_TRACE_RECORD(LCD_TRACE_QUEUED, rtrans->length / 8, frame->trace_start[frame->completed % LCD_QUEUE_DEPTH]);
+#endif
+		frame->completed++;
+
+		//top the queue back up
+		if (frame->queued < frame->total)
+		{
+			LCD_queueFrameItem(frame);
+		}
+	}
+
+	return frame->completed == frame->total;
+}
+
+void LCD_waitFrame(LCD_frame_handle_t frame)
+{
+	LCD_frameService(frame, portMAX_DELAY);
+}
+
+void LCD_sendFrame(spi_device_handle_t spi, uint8_t* buffer, const int frame_size)
+{
+	LCD_waitFrame(LCD_sendFrameAsync(spi, buffer, frame_size));
+}
+
+void LCD_fillRect(spi_device_handle_t spi, const uint8_t x, const uint8_t y, const uint8_t w, const uint8_t h, const uint16_t color)
+{
+	const int size = w * h * PIXEL_SIZE;
+
+	if (size == 0)
+	{
+		return;
+	}
+
+	//pattern only holds as many pixels as the fill needs
+	const int pattern_size = (size < LCD_FILL_PATTERN_SIZE) ? size : LCD_FILL_PATTERN_SIZE;
+	for (int i = 0; i < pattern_size; i += PIXEL_SIZE)
+	{
+		fill_pattern[i]     = color >> 8;
+		fill_pattern[i + 1] = color & 0xFF;
+	}
+
+	LCD_batch_t header;
+	LCD_batchReset(&header);
+	LCD_batchWindow(&header, x, y, w - 1, h - 1);
+	LCD_batchAdd(&header, CMD_RAMWR, NULL, 0);
+
+	//every chunk points at the same pattern buffer
+	LCD_TRACE_TAG("fill");
+	LCD_waitFrame(LCD_startFrame(spi, &header, fill_pattern, size, LCD_FILL_PATTERN_SIZE, true));
+}
+
+void LCD_setPanelMode(spi_device_handle_t spi, const LCD_panel_mode_t mode)
+{
+	if (mode == panel_mode)
+	{
+		return;
+	}
+	LCD_TRACE_TAG("panel");
+
+	if (panel_mode == LCD_PANEL_SLEEP)
+	{
+		LCD_sendCommand(spi, CMD_SLPOUT);
+		//Required delay after exiting sleep
+		LCD_PORT_DELAY_MS(120);
+	}
+
+	switch (mode)
+	{
+	case LCD_PANEL_NORMAL:
+		LCD_sendCommand(spi, CMD_IDMOFF);
+		break;
+	case LCD_PANEL_IDLE:
+		LCD_sendCommand(spi, CMD_IDMON);
+		break;
+	case LCD_PANEL_SLEEP:
+		LCD_sendCommand(spi, CMD_IDMOFF);
+		LCD_sendCommand(spi, CMD_SLPIN);
+		//sleep out is not allowed for 120ms after sleep in
+		LCD_PORT_DELAY_MS(120);
+		break;
+	}
+
+	panel_mode = mode;
+}
+
+LCD_panel_mode_t LCD_getPanelMode(void)
+{
+	return panel_mode;
+}
+
+void LCD_setTearingEffect(spi_device_handle_t spi, const bool on)
+{
+	LCD_TRACE_TAG("panel");
+	if (on)
+	{
+		//mode 1, pulse on vertical blanking only
+		const uint8_t te_mode = 0x00;
+		LCD_sendCommand(spi, CMD_TEON);
+		LCD_sendData(spi, &te_mode, 1);
+	}
+	else
+	{
+		LCD_sendCommand(spi, CMD_TEOFF);
+	}
+}
+
+void LCD_setScrollArea(spi_device_handle_t spi, const uint16_t top, const uint16_t height)
 {
-	const int chunk_size = frame_size / chunk_number; //for chunk sends (should be divisibe by size)
+	const uint16_t bottom = LCD_GRAM_HEIGHT - top - height;
+	//top fixed, scroll and bottom fixed line counts, MSB first (6 bytes, too many for a batch)
+	const uint8_t vscrdef[6] = {top >> 8, top & 0xFF, height >> 8, height & 0xFF, bottom >> 8, bottom & 0xFF};
 
-	/* Activate mem write. */
-	LCD_sendCommand(spi, CMD_RAMWR);
+	assert(top + height <= LCD_GRAM_HEIGHT);
+	LCD_TRACE_TAG("scroll");
+	LCD_sendCommand(spi, CMD_VSCRDEF);
+	LCD_sendData(spi, vscrdef, sizeof(vscrdef));
+}
 
-	//send chunks
-	for (int i = 0; i < chunk_number; i ++)
+void LCD_setScrollStart(spi_device_handle_t spi, const uint16_t line)
+{
+	const uint8_t vscsad[2] = {line >> 8, line & 0xFF};
+	LCD_batch_t batch;
+	LCD_batchReset(&batch);
+	LCD_batchAdd(&batch, CMD_VSCSAD, vscsad, 2);
+
+	LCD_TRACE_TAG("scroll");
+	LCD_batchSubmit(spi, &batch);
+}
+
+void LCD_scrollStop(spi_device_handle_t spi)
+{
+	LCD_TRACE_TAG("scroll");
+	LCD_sendCommand(spi, CMD_NORON);
+}
+
+void LCD_batchReset(LCD_batch_t* batch)
+{
+	batch->count = 0;
+}
+
+void LCD_batchAdd(LCD_batch_t* batch, const uint8_t cmd, const uint8_t* data, const int len)
+{
+	assert(len <= 4);
+	assert(batch->count + ((len > 0) ? 2 : 1) <= LCD_BATCH_MAX);
+
+	//command and parameters both live in the transactions themselves
+	spi_transaction_t* t = &batch->trans[batch->count++];
+	memset(t, 0, sizeof(*t));
+	t->length = 8;
+	t->flags = SPI_TRANS_USE_TXDATA;
+	t->tx_data[0] = cmd;
+	t->user = (void*)LOW;
+
+	if (len > 0)
 	{
-		LCD_sendData(spi, buffer + (i * chunk_size), chunk_size);
+		t = &batch->trans[batch->count++];
+		memset(t, 0, sizeof(*t));
+		t->length = len * 8;
+		t->flags = SPI_TRANS_USE_TXDATA;
+		memcpy(t->tx_data, data, len);
+		t->user = (void*)HIGH;
 	}
 }
 
+void LCD_batchWindow(LCD_batch_t* batch, const uint8_t x, const uint8_t y, const uint8_t w, const uint8_t h)
+{
+	//start and end, MSB first
+	const uint8_t caset[4] = {(x >> 8) & 0xFF, x & 0xFF, ((x + w) >> 8) & 0xFF, (x + w) & 0xFF};
+	const uint8_t raset[4] = {(y >> 8) & 0xFF, y & 0xFF, ((y + h) >> 8) & 0xFF, (y + h) & 0xFF};
+
+	LCD_batchAdd(batch, CMD_CASET, caset, 4);
+	LCD_batchAdd(batch, CMD_RASET, raset, 4);
+}
+
+void LCD_batchSubmit(spi_device_handle_t spi, LCD_batch_t* batch)
+{
+	LCD_waitFrame(LCD_startFrame(spi, batch, NULL, 0, 1, false));
+}
+
 void LCD_setDrawingWindow(spi_device_handle_t spi, const uint8_t x, const uint8_t y, const uint8_t w, const uint8_t h)
 {
-	//set collumn address
-	LCD_sendCommand(spi, CMD_CASET);
-	uint8_t window_position_buffer[4];
-	window_position_buffer[0] = (x >> 8)        & 0x00FF; //collumn start MSB
-	window_position_buffer[1] = (x)             & 0x00FF; //collumn start LSB
-	window_position_buffer[2] = ((x + w) >> 8)  & 0x00FF; //collumn end MSB
-	window_position_buffer[3] = (x + w)         & 0x00FF; //collumn end LSB 
-	LCD_sendData(spi, &window_position_buffer, 4);
-
-	//setting row address
-	LCD_sendCommand(spi, CMD_RASET);
-	window_position_buffer[0] = (y >> 8)        & 0x00FF; //collumn start MSB
-	window_position_buffer[1] = (y)             & 0x00FF; //collumn start LSB
-	window_position_buffer[2] = ((y + h) >> 8)  & 0x00FF; //collumn end MSB
-	window_position_buffer[3] = (y + h)         & 0x00FF; //collumn end LSB 
-	LCD_sendData(spi, &window_position_buffer, 4);
-}
\ No newline at end of file
+	LCD_batch_t batch;
+	LCD_batchReset(&batch);
+	LCD_batchWindow(&batch, x, y, w, h);
+
+	LCD_TRACE_TAG("window");
+	LCD_batchSubmit(spi, &batch);
+}
@@ -11,7 +11,10 @@
 extern "C" {
 #endif
 
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
 #include "driver/spi_master.h"
+#include "display_trace.h"
 
 /************************************************
  *  DEFINITIONS
@@ -20,18 +23,13 @@ extern "C" {
 #define X_OFFSET    2 //slight offsets in actual position 
 #define Y_OFFSET    1
 
-#define TIME_DISPLAY_X_OFFSET   11
-#define TIME_DISPLAY_Y_OFFSET   44
-
-#define ICON_DISPLAY_X_OFFSET   49
-#define ICON_DISPLAY_Y_OFFSET   92
-
 // no MISO pin lcd does not send data
 #define PIN_DATA_NCOMMAND 12 //A0 D/C (high data low command)
 #define PIN_CHIP_SEL      13 //CS (active low)
 #define PIN_SDA           14 //SDA or MOSI
 #define PIN_SCK           27 //SCK
 #define PIN_RESET         0  //RST (active low)
+#define PIN_TE            -1 //TE tearing effect output, -1 when not wired (flushes are not paced)
 
 #define WIDTH             128
 #define HEIGHT            128
@@ -41,8 +39,49 @@ extern "C" {
 #define PIXEL_FORMAT      0x55
 #define PIXEL_SIZE        2
 #define GAMMA_CURVE       0x01
-#define MAX_TRANSFER_SIZE 3072  //frame_size / 16
+#define MAX_TRANSFER_SIZE 3072  //largest single transaction, chunk sizes derive from it (keep word aligned)
 #define FRAME_SIZE        32768 //height * width * pixel_size
+#define LCD_QUEUE_DEPTH   7     //transactions in flight, must match the device queue_size
+#define LCD_FILL_PATTERN_SIZE 512 //bytes of solid color repeated by LCD_fillRect (whole pixels)
+#define LCD_BATCH_MAX     6     //transactions in a command batch (window setup + RAMWR needs 5)
+#define LCD_GRAM_HEIGHT   162   //controller memory lines, the scroll areas must add up to this
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+/* Pre-built command sequence, each command is followed by its parameters as a separate data transaction. */
+typedef struct {
+	spi_transaction_t trans[LCD_BATCH_MAX];
+	int count;
+} LCD_batch_t;
+
+/* State of a frame being pushed through the SPI transaction queue. */
+typedef struct {
+	spi_device_handle_t spi;
+	const uint8_t* buffer;
+	int frame_size;
+	int chunk_size;
+	bool repeat;    //every chunk is sent from the start of buffer (solid fills)
+	LCD_batch_t header; //commands queued ahead of the data (window setup, RAMWR), empty when continuing a write
+	int total;      //items to send (header + data chunks)
+	int queued;
+	int completed;
+	spi_transaction_t trans[LCD_QUEUE_DEPTH];
+#if LCD_TRACE_ENABLE
+	int64_t trace_start[LCD_QUEUE_DEPTH];  //queue time of each transaction
+#endif
+} LCD_frame_t;
+
+/* Completion handle returned by LCD_sendFrameAsync. */
+typedef LCD_frame_t* LCD_frame_handle_t;
+
+/* Panel power modes. */
+typedef enum {
+	LCD_PANEL_NORMAL = 0, //full color
+	LCD_PANEL_IDLE,       //8 color idle mode, lower panel current
+	LCD_PANEL_SLEEP,      //display off, GRAM and interface keep working
+} LCD_panel_mode_t;
 
 /************************************************
  *  FUNCTIONS
@@ -60,15 +99,85 @@ void LCD_init(spi_device_handle_t spi);
 
 /** @brief Send A Frame of data to display
  *
- *  Send the contents of the buffer to the LCD via SPI
+ *  Send the contents of the buffer to the LCD via SPI, the data is split into
+ *  chunks sized by LCD_busChunkSize so several can be queued at once.
  *
  *  @param spi The device handle used for sending commands.
  *  @param buffer Source of display data
  *  @param frame_size Size of frame to be sent (used when sending portions of the display)
- *  @param chunk_number Number of chunks (data will be seperated into chunks in order to increase speed)
  *  @return Void.
  */
-void LCD_sendFrame(spi_device_handle_t spi, uint8_t* buffer, const int frame_size, const int chunk_number);
+void LCD_sendFrame(spi_device_handle_t spi, uint8_t* buffer, const int frame_size);
+
+/** @brief Start sending a frame without blocking
+ *
+ *  Queues the RAMWR command and as many chunks as the SPI queue holds, the remaining
+ *  chunks are queued by LCD_frameService as earlier ones complete. The buffer must
+ *  stay valid (and DMA capable) until the frame completes, and no other LCD call may
+ *  be made until then since polling transactions cannot run while the queue is busy.
+ *
+ *  @param spi The device handle used for sending commands.
+ *  @param buffer Source of display data
+ *  @param frame_size Size of frame to be sent
+ *  @return Handle used to service and wait on the frame.
+ */
+LCD_frame_handle_t LCD_sendFrameAsync(spi_device_handle_t spi, const uint8_t* buffer, const int frame_size);
+
+/** @brief Set a drawing window and start sending a frame without blocking
+ *
+ *  The CASET/RASET/RAMWR sequence is queued in the same burst as the first data
+ *  chunks instead of being sent as separate polling transactions.
+ *
+ *  @param spi The device handle used for sending commands.
+ *  @param x x coordinate of drawing window (top left)
+ *  @param y y coordinate of drawing window (top left)
+ *  @param w width of drawing window in pixels
+ *  @param h height of drawing window in pixels
+ *  @param buffer Source of display data
+ *  @param frame_size Size of frame to be sent
+ *  @return Handle used to service and wait on the frame.
+ */
+LCD_frame_handle_t LCD_sendWindowAsync(spi_device_handle_t spi, const uint8_t x, const uint8_t y, const uint8_t w, const uint8_t h,
+	const uint8_t* buffer, const int frame_size);
+
+/** @brief Continue a memory write without blocking
+ *
+ *  Same as LCD_sendFrameAsync but without the RAMWR command, the data is appended to the
+ *  write started by a previous frame (used to stream a window from several staging buffers).
+ *
+ *  @param spi The device handle used for sending commands.
+ *  @param buffer Source of display data
+ *  @param frame_size Size of data to be sent
+ *  @return Handle used to service and wait on the frame.
+ */
+LCD_frame_handle_t LCD_continueFrameAsync(spi_device_handle_t spi, const uint8_t* buffer, const int frame_size);
+
+/** @brief Reap finished chunks and queue the next ones
+ *
+ *  Call periodically (e.g. between render steps) with ticks_to_wait = 0 to keep the queue full.
+ *
+ *  @param frame Handle returned by LCD_sendFrameAsync
+ *  @param ticks_to_wait Max time to block per finished transaction
+ *  @return true once every chunk of the frame has been sent.
+ */
+bool LCD_frameService(LCD_frame_handle_t frame, TickType_t ticks_to_wait);
+
+/** @brief Block until a frame has been fully sent
+ *
+ *  @param frame Handle returned by LCD_sendFrameAsync
+ *  @return Void.
+ */
+void LCD_waitFrame(LCD_frame_handle_t frame);
+
+/** @brief SPI pre-transfer callback
+ *
+ *  Sets the D/C line from the transaction user field (0 command, 1 data).
+ *  Must be installed as pre_cb on the LCD device.
+ *
+ *  @param t Transaction about to be sent
+ *  @return Void.
+ */
+void LCD_spiPreTransferCallback(spi_transaction_t *t);
 
 /** @brief Send Data to Display
  *
@@ -94,6 +203,115 @@ void LCD_sendData(spi_device_handle_t spi, const uint8_t *data, const int len);
  */
 void LCD_setDrawingWindow(spi_device_handle_t spi, const uint8_t x, const uint8_t y, const uint8_t w, const uint8_t h);
 
+/** @brief Fill a rectangle with a solid color
+ *
+ *  Streams a small repeated pattern buffer instead of a frame sized one,
+ *  used for clears, bars and other solid regions.
+ *
+ *  @param spi The device handle used for sending commands.
+ *  @param x x coordinate of the rectangle (top left, panel coordinates)
+ *  @param y y coordinate of the rectangle (top left, panel coordinates)
+ *  @param w width of the rectangle in pixels
+ *  @param h height of the rectangle in pixels
+ *  @param color RGB565 color
+ *  @return Void.
+ */
+void LCD_fillRect(spi_device_handle_t spi, const uint8_t x, const uint8_t y, const uint8_t w, const uint8_t h, const uint16_t color);
+
+/** @brief Change the panel power mode
+ *
+ *  Leaving sleep waits the 120ms the controller needs before it is usable again.
+ *
+ *  @param spi The device handle used for sending commands.
+ *  @param mode Requested panel mode
+ *  @return Void.
+ */
+void LCD_setPanelMode(spi_device_handle_t spi, const LCD_panel_mode_t mode);
+
+/** @brief Get the panel power mode
+ *
+ *  @return Mode set by the last LCD_setPanelMode.
+ */
+LCD_panel_mode_t LCD_getPanelMode(void);
+
+/** @brief Enable or disable the tearing effect output
+ *
+ *  When enabled the TE pin pulses high during vertical blanking.
+ *
+ *  @param spi The device handle used for sending commands.
+ *  @param on true to enable the TE output
+ *  @return Void.
+ */
+void LCD_setTearingEffect(spi_device_handle_t spi, const bool on);
+
+/** @brief Define the vertical scroll area
+ *
+ *  Lines above and below the area stay fixed. Nothing moves until LCD_setScrollStart.
+ *
+ *  @param spi The device handle used for sending commands.
+ *  @param top First memory line of the scroll area (panel coordinates)
+ *  @param height Lines in the scroll area
+ *  @return Void.
+ */
+void LCD_setScrollArea(spi_device_handle_t spi, const uint16_t top, const uint16_t height);
+
+/** @brief Set the memory line shown at the top of the scroll area
+ *
+ *  Line top + n shows the area rotated up by n lines, lines wrap inside the area.
+ *
+ *  @param spi The device handle used for sending commands.
+ *  @param line Memory line (panel coordinates, inside the scroll area)
+ *  @return Void.
+ */
+void LCD_setScrollStart(spi_device_handle_t spi, const uint16_t line);
+
+/** @brief Leave scroll mode
+ *
+ *  Returns to normal display mode, memory lines are shown where they are stored again.
+ *
+ *  @param spi The device handle used for sending commands.
+ *  @return Void.
+ */
+void LCD_scrollStop(spi_device_handle_t spi);
+
+/** @brief Clear a command batch
+ *
+ *  @param batch Batch to clear
+ *  @return Void.
+ */
+void LCD_batchReset(LCD_batch_t* batch);
+
+/** @brief Append a command and its parameters to a batch
+ *
+ *  Parameters are copied into the transaction, no buffer has to outlive the batch.
+ *
+ *  @param batch Batch to append to
+ *  @param cmd Command byte
+ *  @param data Parameters (may be NULL when len is 0)
+ *  @param len Number of parameter bytes (at most 4)
+ *  @return Void.
+ */
+void LCD_batchAdd(LCD_batch_t* batch, const uint8_t cmd, const uint8_t* data, const int len);
+
+/** @brief Append a CASET/RASET window setup to a batch
+ *
+ *  @param batch Batch to append to
+ *  @param x x coordinate of drawing window (top left)
+ *  @param y y coordinate of drawing window (top left)
+ *  @param w width of drawing window minus one (same as LCD_setDrawingWindow)
+ *  @param h height of drawing window minus one
+ *  @return Void.
+ */
+void LCD_batchWindow(LCD_batch_t* batch, const uint8_t x, const uint8_t y, const uint8_t w, const uint8_t h);
+
+/** @brief Queue a whole batch in one burst and wait for it to finish
+ *
+ *  @param spi The device handle used for sending commands.
+ *  @param batch Batch to send
+ *  @return Void.
+ */
+void LCD_batchSubmit(spi_device_handle_t spi, LCD_batch_t* batch);
+
 /** @brief Send Command to Display
  *
  *  Send a command to the LCD display, used for initialization and sending general configuration instructions.
@@ -106,13 +324,25 @@ void LCD_sendCommand(spi_device_handle_t spi, const uint8_t cmd);
 
 /** @brief Draw a media icon
  *
- *  Wrapper function that draws a media control icon to the display
+ *  Wrapper function that draws a media control icon to the display.
+ *  Call from the dispatcher task (app_bus.h), the display is only drawn there.
  *
  *  @param icon_index Index of the desired icon to be drawn 
  *  @return Void.
  */
 void LCD_drawMediaIcon(uint8_t icon_index);
 
+/** @brief Slide in a media icon
+ *
+ *  Scrolls the new icon into place, falls back to LCD_drawMediaIcon while
+ *  another transition is running. Call from the dispatcher task.
+ *
+ *  @param icon_index Index of the desired icon to be drawn
+ *  @param forward true slides the new icon up from the bottom, false down from the top
+ *  @return Void.
+ */
+void LCD_slideMediaIcon(uint8_t icon_index, bool forward);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,56 @@
+/**
+ * @file display_port.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Hardware access points used by the LCD driver
+ *
+ * display_main.c only touches the SPI bus, the control pins and delays through
+ * these macros. By default they map straight onto the ESP-IDF drivers, a build
+ * that defines LCD_PORT_HEADER (e.g. -DLCD_PORT_HEADER="\"lcd_port_emu.h\"",
+ * see test/host) supplies its own versions instead, for example to feed the
+ * transactions into a software model of the ST7735S. Such a port has to call
+ * LCD_spiPreTransferCallback before each transaction itself, the same way the
+ * SPI master driver does.
+ *
+ * LCD_PORT_VERIFY is the LCD_bus_verify_cb_t handed to LCD_busCalibrate. This
+ * board has no read line, so the ESP-IDF port has none (NULL), a port that can
+ * see the panel memory supplies one.
+ */
+
+#pragma once
+
+#ifdef LCD_PORT_HEADER
+
+#include LCD_PORT_HEADER
+
+#else
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/spi_master.h"
+#include "driver/gpio.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+/* SPI transactions. */
+#define LCD_PORT_POLL_TRANS(spi, t)              spi_device_polling_transmit((spi), (t))
+#define LCD_PORT_QUEUE_TRANS(spi, t, ticks)      spi_device_queue_trans((spi), (t), (ticks))
+#define LCD_PORT_GET_RESULT(spi, t, ticks)       spi_device_get_trans_result((spi), (t), (ticks))
+
+/* Control pins. */
+#define LCD_PORT_CONFIG_OUTPUTS(conf)            gpio_config(conf)
+#define LCD_PORT_SET_LEVEL(pin, level)           gpio_set_level((pin), (level))
+
+/* Blocking delay. */
+#define LCD_PORT_DELAY_MS(ms)                    vTaskDelay((ms) / portTICK_PERIOD_MS)
+
+/* Calibration pattern check. */
+#define LCD_PORT_VERIFY                          NULL
+
+#endif
@@ -0,0 +1,110 @@
+/**
+ * @file display_rle.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Streaming decoder for run length encoded display assets
+ *
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <string.h>
+#include "esp_attr.h"
+#include "display_rle.h"
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+//staging buffers, one is decoded into while the other is being sent
+static DMA_ATTR uint8_t rle_tx[2][RLE_TX_SIZE];
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+void LCD_rleDecoderInit(LCD_rle_decoder_t* dec, const LCD_rle_asset_t* asset)
+{
+	dec->src = asset->data;
+	dec->end = asset->data + asset->size;
+	dec->count = 0;
+	dec->repeat = false;
+}
+
+int LCD_rleDecode(LCD_rle_decoder_t* dec, uint8_t* out, const int max_bytes)
+{
+	int written = 0;
+
+	while (written + PIXEL_SIZE <= max_bytes)
+	{
+		//fetch next packet header
+		if (dec->count == 0)
+		{
+			if (dec->src >= dec->end)
+			{
+				break;
+			}
+			const uint8_t header = *dec->src++;
+			dec->repeat = header & RLE_REPEAT_FLAG;
+			dec->count = (header & RLE_COUNT_MASK) + 1;
+		}
+
+		int pixels = (max_bytes - written) / PIXEL_SIZE;
+		if (pixels > dec->count)
+		{
+			pixels = dec->count;
+		}
+
+		if (dec->repeat)
+		{
+			for (int i = 0; i < pixels; i++)
+			{
+				out[written++] = dec->src[0];
+				out[written++] = dec->src[1];
+			}
+			dec->count -= pixels;
+			if (dec->count == 0)
+			{
+				dec->src += PIXEL_SIZE; //run finished, skip its pixel
+			}
+		}
+		else
+		{
+			memcpy(&out[written], dec->src, pixels * PIXEL_SIZE);
+			written += pixels * PIXEL_SIZE;
+			dec->src += pixels * PIXEL_SIZE;
+			dec->count -= pixels;
+		}
+	}
+
+	return written;
+}
+
+void LCD_sendRleFrame(spi_device_handle_t spi, const LCD_rle_asset_t* asset)
+{
+	LCD_rle_decoder_t dec;
+	LCD_frame_handle_t pending = NULL;
+	int buf = 0;
+	int len;
+
+	LCD_rleDecoderInit(&dec, asset);
+
+	while ((len = LCD_rleDecode(&dec, rle_tx[buf], RLE_TX_SIZE)) > 0)
+	{
+		if (pending)
+		{
+			LCD_waitFrame(pending);
+		}
+		pending = (pending == NULL)
+			? LCD_sendFrameAsync(spi, rle_tx[buf], len)
+			: LCD_continueFrameAsync(spi, rle_tx[buf], len);
+		buf ^= 1;
+	}
+
+	if (pending)
+	{
+		LCD_waitFrame(pending);
+	}
+}
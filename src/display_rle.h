@@ -0,0 +1,92 @@
+/**
+ * @file display_rle.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Run length encoded RGB565 assets and streaming decoder
+ *
+ * Encoding is a sequence of packets, each starting with a header byte:
+ *  - bit 7 set:   repeat, the next pixel (2 bytes) is repeated (header & 0x7F) + 1 times
+ *  - bit 7 clear: literal, (header + 1) pixels follow as is
+ * Pixels are stored in the same byte order that is sent to the display.
+ * Tables are generated from the PNG sources by tools/png_assets.py.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include "display_main.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define RLE_REPEAT_FLAG   0x80
+#define RLE_COUNT_MASK    0x7F
+#define RLE_MAX_RUN       128
+
+#define RLE_TX_SIZE       1024 //size of each staging buffer used by LCD_sendRleFrame
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+/* Compressed bitmap. */
+typedef struct {
+	uint8_t width;
+	uint8_t height;
+	uint16_t size;       //compressed size in bytes
+	const uint8_t* data;
+} LCD_rle_asset_t;
+
+/* Streaming decoder state, lets a bitmap be expanded a buffer at a time. */
+typedef struct {
+	const uint8_t* src;
+	const uint8_t* end;
+	uint8_t count;       //pixels left in the current packet
+	bool repeat;
+} LCD_rle_decoder_t;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+/** @brief Start decoding an asset
+ *
+ *  @param dec Decoder state to initialize
+ *  @param asset Compressed bitmap
+ *  @return Void.
+ */
+void LCD_rleDecoderInit(LCD_rle_decoder_t* dec, const LCD_rle_asset_t* asset);
+
+/** @brief Decode the next pixels of an asset
+ *
+ *  @param dec Decoder state
+ *  @param out Destination for raw pixel data
+ *  @param max_bytes Size of out, only whole pixels are written
+ *  @return Number of bytes written (0 once the asset is exhausted).
+ */
+int LCD_rleDecode(LCD_rle_decoder_t* dec, uint8_t* out, const int max_bytes);
+
+/** @brief Send a compressed frame to the display
+ *
+ *  Same contract as LCD_sendFrame (drawing window must already be set), the asset is
+ *  decoded straight into small DMA staging buffers while the previous one is being sent.
+ *
+ *  @param spi The device handle used for sending commands.
+ *  @param asset Compressed bitmap
+ *  @return Void.
+ */
+void LCD_sendRleFrame(spi_device_handle_t spi, const LCD_rle_asset_t* asset);
+
+#ifdef __cplusplus
+}
+#endif
@@ -17,35 +17,32 @@ extern "C" {
  ***********************************************/
 
 #include <inttypes.h>
+#include "display_assets.h"
 
 /************************************************
  *  Symbolic Constants
  ***********************************************/
 
-//maybe update width and heigh to be -1 if we never use true size
-#define NUM_WIDTH      25
-#define NUM_HEIGHT     42
-#define NUM_SIZE       2100
-#define NUM_CHUNKS     10
+/* Sizes come from the PNG sources through the generated display_assets.h. */
+#define NUM_WIDTH      DISPLAY_NUMBERS_WIDTH
+#define NUM_HEIGHT     DISPLAY_NUMBERS_HEIGHT
+#define NUM_SIZE       DISPLAY_NUMBERS_SIZE
 
-#define SC_WIDTH       9
-#define SC_HEIGHT      42
-#define SC_SIZE        756
-#define SC_CHUNKS      4
+#define SC_WIDTH       SEMI_COLON_WIDTH
+#define SC_HEIGHT      SEMI_COLON_HEIGHT
+#define SC_SIZE        SEMI_COLON_SIZE
 
-#define ICON_WIDTH     30
-#define ICON_HEIGHT    30
-#define ICON_SIZE      1800
-#define ICON_CHUNKS    8
+#define ICON_WIDTH     MEDIA_ICONS_WIDTH
+#define ICON_HEIGHT    MEDIA_ICONS_HEIGHT
+#define ICON_SIZE      MEDIA_ICONS_SIZE
 
 /************************************************
- *  Globals
+ *  Layout checks
  ***********************************************/
 
-extern uint8_t display_numbers[10][NUM_SIZE];
-extern uint8_t media_icons[7][ICON_SIZE];
-
-extern uint8_t semi_colon[SC_SIZE];
+_Static_assert(DISPLAY_NUMBERS_COUNT == 10, "display_numbers needs one frame per digit");
+_Static_assert(NUM_HEIGHT == SC_HEIGHT, "digits and colon share a row");
+_Static_assert(4 * NUM_WIDTH + SC_WIDTH <= WIDTH, "clock does not fit the screen width");
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,150 @@
+/**
+ * @file display_trace.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief SPI transaction tracing and per-frame counters for the LCD driver
+ *
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include "display_trace.h"
+
+#if LCD_TRACE_ENABLE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "esp_timer.h"
+
+_Static_assert((LCD_TRACE_DEPTH & (LCD_TRACE_DEPTH - 1)) == 0, "LCD_TRACE_DEPTH must be a power of two");
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static LCD_trace_entry_t ring[LCD_TRACE_DEPTH];
+static atomic_uint ring_head = 0;
+
+static const char* current_tag = "-";
+
+//counters, written from the task sending the frame
+static atomic_uint_least64_t total_bytes = 0;
+static atomic_uint total_transactions = 0;
+static int64_t reset_us = 0;
+
+static uint32_t frame_start_bytes;
+static uint32_t frame_start_transactions;
+static int64_t frame_start_us;
+static uint32_t frames = 0;
+static uint32_t frame_bytes = 0;
+static uint32_t frame_transactions = 0;
+static uint32_t frame_times[LCD_TRACE_FRAMES];
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+void LCD_traceSetTag(const char* tag)
+{
+	current_tag = tag;
+}
+
+void LCD_traceRecord(LCD_trace_type_t type, uint32_t len, int64_t start_us)
+{
+	const int64_t now = esp_timer_get_time();
+
+	//claim a slot, writers never wait on each other
+	const unsigned slot = atomic_fetch_add(&ring_head, 1) & (LCD_TRACE_DEPTH - 1);
+	LCD_trace_entry_t* e = &ring[slot];
+	e->type = type;
+	e->tag = current_tag;
+	e->len = len;
+	e->start_us = (uint32_t)start_us;
+	e->end_us = (uint32_t)now;
+
+	atomic_fetch_add(&total_bytes, len);
+	atomic_fetch_add(&total_transactions, 1);
+}
+
+void LCD_traceFrameBegin(void)
+{
+	frame_start_bytes = (uint32_t)atomic_load(&total_bytes);
+	frame_start_transactions = atomic_load(&total_transactions);
+	frame_start_us = esp_timer_get_time();
+}
+
+void LCD_traceFrameEnd(void)
+{
+	frame_bytes = (uint32_t)atomic_load(&total_bytes) - frame_start_bytes;
+	frame_transactions = atomic_load(&total_transactions) - frame_start_transactions;
+	frame_times[frames % LCD_TRACE_FRAMES] = (uint32_t)(esp_timer_get_time() - frame_start_us);
+	frames++;
+}
+
+static int LCD_traceCompare(const void* a, const void* b)
+{
+	const uint32_t x = *(const uint32_t*)a;
+	const uint32_t y = *(const uint32_t*)b;
+	return (x > y) - (x < y);
+}
+
+void LCD_traceGetStats(LCD_trace_stats_t* stats)
+{
+	uint32_t sorted[LCD_TRACE_FRAMES];
+	const int count = (frames < LCD_TRACE_FRAMES) ? frames : LCD_TRACE_FRAMES;
+	const int64_t elapsed = esp_timer_get_time() - reset_us;
+
+	memset(stats, 0, sizeof(*stats));
+	stats->bytes = atomic_load(&total_bytes);
+	stats->transactions = atomic_load(&total_transactions);
+	stats->frames = frames;
+	stats->frame_bytes = frame_bytes;
+	stats->frame_transactions = frame_transactions;
+	stats->bytes_per_sec = (elapsed > 0) ? (uint32_t)((stats->bytes * 1000000ULL) / elapsed) : 0;
+
+	if (count > 0)
+	{
+		memcpy(sorted, frame_times, count * sizeof(uint32_t));
+		qsort(sorted, count, sizeof(uint32_t), LCD_traceCompare);
+		stats->frame_p50_us = sorted[(count - 1) / 2];
+		stats->frame_p99_us = sorted[((count - 1) * 99) / 100];
+		stats->frame_max_us = sorted[count - 1];
+	}
+}
+
+void LCD_traceReset(void)
+{
+	atomic_store(&total_bytes, 0);
+	atomic_store(&total_transactions, 0);
+	frames = 0;
+	frame_bytes = 0;
+	frame_transactions = 0;
+	reset_us = esp_timer_get_time();
+}
+
+void LCD_traceDump(void)
+{
+	static const char* type_names[] = {"cmd", "data", "queued"};
+	LCD_trace_stats_t s;
+	LCD_traceGetStats(&s);
+
+	printf("lcd trace: %" PRIu64 " bytes, %" PRIu32 " transactions, %" PRIu32 " B/s\n", s.bytes, s.transactions, s.bytes_per_sec);
+	printf("lcd trace: %" PRIu32 " frames, last %" PRIu32 " bytes / %" PRIu32 " transactions, p50 %" PRIu32 " us, p99 %" PRIu32 " us, max %" PRIu32 " us\n",
+		s.frames, s.frame_bytes, s.frame_transactions, s.frame_p50_us, s.frame_p99_us, s.frame_max_us);
+
+	//oldest first
+	const unsigned head = atomic_load(&ring_head);
+	const unsigned count = (head < LCD_TRACE_DEPTH) ? head : LCD_TRACE_DEPTH;
+	for (unsigned i = head - count; i != head; i++)
+	{
+		const LCD_trace_entry_t* e = &ring[i & (LCD_TRACE_DEPTH - 1)];
+		printf("%10" PRIu32 " %6" PRIu32 " us %-6s %-8s %5" PRIu32 " B\n",
+			e->start_us, e->end_us - e->start_us, type_names[e->type], e->tag, e->len);
+	}
+}
+
+#endif
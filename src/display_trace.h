@@ -0,0 +1,143 @@
+/**
+ * @file display_trace.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief SPI transaction tracing and per-frame counters for the LCD driver
+ *
+ * Compiled out unless LCD_TRACE_ENABLE is set to 1. When enabled every SPI
+ * transaction sent by display_main.c is recorded into a lock-free ring buffer
+ * (type, length, start/end time and the operation that issued it) and rolling
+ * counters are kept per frame (one FB_flush). LCD_traceDump prints both to
+ * the serial console.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include <inttypes.h>
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#ifndef LCD_TRACE_ENABLE
+#define LCD_TRACE_ENABLE    0
+#endif
+
+#define LCD_TRACE_DEPTH     128  //transactions kept in the ring buffer (power of two)
+#define LCD_TRACE_FRAMES    64   //frame times kept for the percentiles
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+/* Transaction types. */
+typedef enum {
+	LCD_TRACE_CMD = 0,   //polling command byte
+	LCD_TRACE_DATA,      //polling data
+	LCD_TRACE_QUEUED,    //queued frame item (RAMWR or data chunk)
+} LCD_trace_type_t;
+
+/* Ring buffer entry, times are the low 32 bits of esp_timer_get_time(). */
+typedef struct {
+	uint8_t type;
+	const char* tag;
+	uint32_t len;
+	uint32_t start_us;
+	uint32_t end_us;
+} LCD_trace_entry_t;
+
+/* Rolling counters. */
+typedef struct {
+	uint64_t bytes;             //since the last LCD_traceReset
+	uint32_t transactions;
+	uint32_t frames;
+	uint32_t frame_bytes;       //last frame
+	uint32_t frame_transactions;
+	uint32_t frame_p50_us;      //over the last LCD_TRACE_FRAMES frames
+	uint32_t frame_p99_us;
+	uint32_t frame_max_us;
+	uint32_t bytes_per_sec;
+} LCD_trace_stats_t;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+#if LCD_TRACE_ENABLE
+
+#include "esp_timer.h"
+
+#define LCD_TRACE_NOW()                          esp_timer_get_time()
+#define LCD_TRACE_TAG(tag)                       LCD_traceSetTag(tag)
+#define LCD_TRACE_RECORD(type, len, start_us)    LCD_traceRecord((type), (len), (start_us))
+#define LCD_TRACE_FRAME_BEGIN()                  LCD_traceFrameBegin()
+#define LCD_TRACE_FRAME_END()                    LCD_traceFrameEnd()
+
+/** @brief Set the operation recorded with the following transactions
+ *
+ *  @param tag Static string naming the caller (e.g. "window", "fill")
+ *  @return Void.
+ */
+void LCD_traceSetTag(const char* tag);
+
+/** @brief Record a finished transaction
+ *
+ *  @param type Transaction type
+ *  @param len Length in bytes
+ *  @param start_us Time the transaction was issued, the end time is now
+ *  @return Void.
+ */
+void LCD_traceRecord(LCD_trace_type_t type, uint32_t len, int64_t start_us);
+
+/** @brief Mark the start of a frame (screen update)
+ *
+ *  @return Void.
+ */
+void LCD_traceFrameBegin(void);
+
+/** @brief Mark the end of a frame and update the frame counters
+ *
+ *  @return Void.
+ */
+void LCD_traceFrameEnd(void);
+
+/** @brief Get the rolling counters
+ *
+ *  @param stats Filled with the current counters
+ *  @return Void.
+ */
+void LCD_traceGetStats(LCD_trace_stats_t* stats);
+
+/** @brief Clear the counters (the ring buffer is kept)
+ *
+ *  @return Void.
+ */
+void LCD_traceReset(void);
+
+/** @brief Print the counters and the ring buffer to the console
+ *
+ *  @return Void.
+ */
+void LCD_traceDump(void);
+
+#else
+
+#define LCD_TRACE_NOW()                          0
+#define LCD_TRACE_TAG(tag)                       ((void)0)
+#define LCD_TRACE_RECORD(type, len, start_us)    ((void)(start_us))
+#define LCD_TRACE_FRAME_BEGIN()                  ((void)0)
+#define LCD_TRACE_FRAME_END()                    ((void)0)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,374 @@
+/**
+ * @file display_ui.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Retained widgets (clock, icon, battery gauge, text label) on the framebuffer
+ *
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <string.h>
+#include <assert.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
+#include "display_anim.h"
+#include "display_ui.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+//framebuffer slots used by each widget type
+#define UI_CLOCK_SLOTS    (UI_CLOCK_DIGITS + 1)
+#define UI_ICON_SLOTS     1
+#define UI_BATTERY_SLOTS  4  //frame, interior, level, terminal
+#define UI_LABEL_SLOTS    1
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+typedef enum {
+	UI_WIDGET_CLOCK = 0,
+	UI_WIDGET_ICON,
+	UI_WIDGET_BATTERY,
+	UI_WIDGET_LABEL,
+} UI_widget_type_t;
+
+/* Widget, the union holds the properties of its type. */
+typedef struct {
+	UI_widget_type_t type;
+	UI_layout_t layout;
+	FB_rect_t bounds;
+	uint8_t slot;    //first framebuffer slot
+	bool shown;      //has drawn something, transitions need an old content to replace
+	union {
+		struct {
+			const LCD_glyph_t* digits;
+			const LCD_glyph_t* colon;
+			const LCD_palette_t* pal;
+			int8_t value[UI_CLOCK_DIGITS];
+		} clock;
+		struct {
+			const LCD_rle_asset_t* icons;
+			uint8_t count;
+			int8_t index;
+		} icon;
+		struct {
+			int8_t percent;
+		} battery;
+		struct {
+			const FONT_t* font;
+			const LCD_palette_t* pal;
+			uint8_t scale;
+			char text[FB_TEXT_MAX];
+		} label;
+	};
+} UI_widget_t;
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static UI_widget_t widgets[UI_MAX_WIDGETS];
+static int widget_count = 0;
+static int next_slot = 0;
+static uint16_t background_color;
+
+static SemaphoreHandle_t ui_mutex = NULL;
+static StaticSemaphore_t ui_mutex_buf;
+
+static UI_stats_t stats;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+//Bounds of a w x h widget placed by its layout
+static FB_rect_t UI_place(const UI_layout_t* layout, int w, int h)
+{
+	int x;
+
+	switch (layout->align)
+	{
+	case UI_ALIGN_CENTER:
+		x = (WIDTH - w) / 2 + layout->x;
+		break;
+	case UI_ALIGN_RIGHT:
+		x = WIDTH - w - layout->x;
+		break;
+	default:
+		x = layout->x;
+		break;
+	}
+
+	assert(x >= 0 && x + w <= WIDTH && layout->y + h <= HEIGHT);
+	FB_rect_t r = {x, layout->y, w, h};
+	return r;
+}
+
+//Move a widget, the framebuffer damages the old and new slot bounds when the slots are rewritten
+static void UI_setBounds(UI_widget_t* w, const FB_rect_t bounds)
+{
+	if (w->bounds.x != bounds.x || w->bounds.y != bounds.y || w->bounds.w != bounds.w || w->bounds.h != bounds.h)
+	{
+		if (w->bounds.w != 0)
+		{
+			stats.relayouts++;
+		}
+		w->bounds = bounds;
+	}
+}
+
+static int UI_add(UI_widget_type_t type, const UI_layout_t* layout, int slots)
+{
+	xSemaphoreTake(ui_mutex, portMAX_DELAY);
+	assert(widget_count < UI_MAX_WIDGETS);
+	assert(next_slot + slots <= FB_MAX_SLOTS);
+
+	const int id = widget_count++;
+	UI_widget_t* w = &widgets[id];
+	memset(w, 0, sizeof(*w));
+	w->type = type;
+	w->layout = *layout;
+	w->slot = next_slot;
+	next_slot += slots;
+	xSemaphoreGive(ui_mutex);
+	return id;
+}
+
+//Start a transition over a widget if asked for and possible, caller sets the new slots next
+static bool UI_beginTransition(const UI_widget_t* w, UI_transition_t transition)
+{
+	if (transition == UI_TRANSITION_NONE || !w->shown)
+	{
+		return false;
+	}
+	return ANIM_begin(w->bounds, (transition == UI_TRANSITION_UP) ? ANIM_SCROLL_UP : ANIM_SCROLL_DOWN);
+}
+
+void UI_init(int first_slot, uint16_t background)
+{
+	if (ui_mutex == NULL)
+	{
+		ui_mutex = xSemaphoreCreateMutexStatic(&ui_mutex_buf);
+	}
+
+	xSemaphoreTake(ui_mutex, portMAX_DELAY);
+	widget_count = 0;
+	next_slot = first_slot;
+	background_color = background;
+	memset(&stats, 0, sizeof(stats));
+	xSemaphoreGive(ui_mutex);
+}
+
+int UI_addClock(const UI_layout_t* layout, const LCD_glyph_t* digits, const LCD_glyph_t* colon, const LCD_palette_t* pal)
+{
+	assert(digits[0].height == colon->height);
+
+	const int id = UI_add(UI_WIDGET_CLOCK, layout, UI_CLOCK_SLOTS);
+	UI_widget_t* w = &widgets[id];
+	w->clock.digits = digits;
+	w->clock.colon = colon;
+	w->clock.pal = pal;
+	memset(w->clock.value, -1, sizeof(w->clock.value));
+	UI_setBounds(w, UI_place(layout, UI_CLOCK_DIGITS * digits[0].width + colon->width, colon->height));
+	return id;
+}
+
+int UI_addIcon(const UI_layout_t* layout, const LCD_rle_asset_t* icons, int count)
+{
+	const int id = UI_add(UI_WIDGET_ICON, layout, UI_ICON_SLOTS);
+	UI_widget_t* w = &widgets[id];
+	w->icon.icons = icons;
+	w->icon.count = count;
+	w->icon.index = -1;
+	UI_setBounds(w, UI_place(layout, icons[0].width, icons[0].height));
+	return id;
+}
+
+int UI_addBattery(const UI_layout_t* layout)
+{
+	const int id = UI_add(UI_WIDGET_BATTERY, layout, UI_BATTERY_SLOTS);
+	UI_widget_t* w = &widgets[id];
+	w->battery.percent = -1;
+	UI_setBounds(w, UI_place(layout, UI_BATTERY_WIDTH, UI_BATTERY_HEIGHT));
+	return id;
+}
+
+int UI_addLabel(const UI_layout_t* layout, const FONT_t* font, uint8_t scale, const LCD_palette_t* pal)
+{
+	const int id = UI_add(UI_WIDGET_LABEL, layout, UI_LABEL_SLOTS);
+	UI_widget_t* w = &widgets[id];
+	w->label.font = font;
+	w->label.scale = scale;
+	w->label.pal = pal;
+	return id;
+}
+
+void UI_setTime(int id, int hour, int minute, UI_transition_t transition)
+{
+	UI_widget_t* w = &widgets[id];
+	const int8_t value[UI_CLOCK_DIGITS] = {hour / 10, hour % 10, minute / 10, minute % 10};
+
+	assert(w->type == UI_WIDGET_CLOCK);
+	xSemaphoreTake(ui_mutex, portMAX_DELAY);
+	if (memcmp(value, w->clock.value, sizeof(value)) == 0)
+	{
+		stats.unchanged++;
+		xSemaphoreGive(ui_mutex);
+		return;
+	}
+
+	//the scroll moves the whole clock, so every digit is part of the transition
+	const bool animate = UI_beginTransition(w, transition);
+	const int digit_w = w->clock.digits[0].width;
+	for (int i = 0; i < UI_CLOCK_DIGITS; i++)
+	{
+		//unchanged digits leave their slot as is, only changed ones get flushed
+		if (value[i] != w->clock.value[i])
+		{
+			const int x = w->bounds.x + i * digit_w + ((i >= 2) ? w->clock.colon->width : 0);
+			FB_setGlyph(w->slot + i, x, w->bounds.y, &w->clock.digits[value[i]], w->clock.pal);
+		}
+	}
+	FB_setGlyph(w->slot + UI_CLOCK_DIGITS, w->bounds.x + 2 * digit_w, w->bounds.y, w->clock.colon, w->clock.pal);
+
+	memcpy(w->clock.value, value, sizeof(value));
+	w->shown = true;
+	stats.updates++;
+	if (animate)
+	{
+		ANIM_start(ANIM_DEFAULT_MS);
+	}
+	xSemaphoreGive(ui_mutex);
+}
+
+void UI_setIcon(int id, int index, UI_transition_t transition)
+{
+	UI_widget_t* w = &widgets[id];
+
+	assert(w->type == UI_WIDGET_ICON && index >= 0 && index < w->icon.count);
+	xSemaphoreTake(ui_mutex, portMAX_DELAY);
+	if (index == w->icon.index)
+	{
+		stats.unchanged++;
+		xSemaphoreGive(ui_mutex);
+		return;
+	}
+
+	const bool animate = UI_beginTransition(w, transition);
+	FB_setRle(w->slot, w->bounds.x, w->bounds.y, &w->icon.icons[index]);
+
+	w->icon.index = index;
+	w->shown = true;
+	stats.updates++;
+	if (animate)
+	{
+		ANIM_start(ANIM_DEFAULT_MS);
+	}
+	xSemaphoreGive(ui_mutex);
+}
+
+void UI_setBattery(int id, int percent)
+{
+	UI_widget_t* w = &widgets[id];
+
+	assert(w->type == UI_WIDGET_BATTERY);
+	percent = (percent > 100) ? 100 : ((percent < 0) ? -1 : percent);
+
+	xSemaphoreTake(ui_mutex, portMAX_DELAY);
+	if (percent == w->battery.percent)
+	{
+		stats.unchanged++;
+		xSemaphoreGive(ui_mutex);
+		return;
+	}
+
+	if (percent < 0)
+	{
+		for (int i = 0; i < UI_BATTERY_SLOTS; i++)
+		{
+			FB_clearSlot(w->slot + i);
+		}
+	}
+	else
+	{
+		//body with a 1 pixel frame, terminal nub on the right
+		const FB_rect_t b = w->bounds;
+		const int body_w = b.w - 2;
+		const int inner_w = body_w - 4;
+		const FB_rect_t frame = {b.x, b.y, body_w, b.h};
+		const FB_rect_t interior = {b.x + 1, b.y + 1, body_w - 2, b.h - 2};
+		const FB_rect_t level = {b.x + 2, b.y + 2, (inner_w * percent + 50) / 100, b.h - 4};
+		const FB_rect_t terminal = {b.x + body_w, b.y + b.h / 4, 2, b.h / 2};
+
+		FB_setFill(w->slot, frame, UI_BATTERY_FRAME);
+		FB_setFill(w->slot + 1, interior, background_color);
+		FB_setFill(w->slot + 2, level, (percent <= UI_BATTERY_LOW) ? UI_BATTERY_LOW_LEVEL : UI_BATTERY_LEVEL);
+		FB_setFill(w->slot + 3, terminal, UI_BATTERY_FRAME);
+	}
+
+	w->battery.percent = percent;
+	w->shown = (percent >= 0);
+	stats.updates++;
+	xSemaphoreGive(ui_mutex);
+}
+
+void UI_setText(int id, const char* text)
+{
+	UI_widget_t* w = &widgets[id];
+
+	assert(w->type == UI_WIDGET_LABEL);
+	xSemaphoreTake(ui_mutex, portMAX_DELAY);
+	if (w->shown && strncmp(text, w->label.text, FB_TEXT_MAX - 1) == 0)
+	{
+		stats.unchanged++;
+		xSemaphoreGive(ui_mutex);
+		return;
+	}
+
+	strncpy(w->label.text, text, FB_TEXT_MAX - 1);
+	w->label.text[FB_TEXT_MAX - 1] = '\0';
+
+	//centered and right aligned labels move with their width
+	const int text_w = FONT_measure(w->label.font, w->label.text, w->label.scale);
+	UI_setBounds(w, UI_place(&w->layout, (text_w < WIDTH) ? text_w : WIDTH, w->label.font->height * w->label.scale));
+	FB_setText(w->slot, w->bounds.x, w->bounds.y, w->label.text, w->label.font, w->label.scale, w->label.pal);
+
+	w->shown = true;
+	stats.updates++;
+	xSemaphoreGive(ui_mutex);
+}
+
+FB_rect_t UI_getBounds(int id)
+{
+	return widgets[id].bounds;
+}
+
+void UI_commit(void)
+{
+	const int64_t start = esp_timer_get_time();
+	FB_flush();
+	const uint32_t elapsed = (uint32_t)(esp_timer_get_time() - start);
+
+	xSemaphoreTake(ui_mutex, portMAX_DELAY);
+	stats.commits++;
+	stats.last_commit_us = elapsed;
+	if (elapsed > stats.max_commit_us)
+	{
+		stats.max_commit_us = elapsed;
+	}
+	xSemaphoreGive(ui_mutex);
+}
+
+void UI_getStats(UI_stats_t* stats_out)
+{
+	xSemaphoreTake(ui_mutex, portMAX_DELAY);
+	memcpy(stats_out, &stats, sizeof(*stats_out));
+	xSemaphoreGive(ui_mutex);
+}
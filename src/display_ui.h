@@ -0,0 +1,185 @@
+/**
+ * @file display_ui.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Retained widgets (clock, icon, battery gauge, text label) on the framebuffer
+ *
+ * Widgets live in a static arena and are placed by a small anchor layout
+ * (horizontal alignment plus a top edge), so screen positions are computed
+ * from asset and text sizes instead of kept as offsets. Each widget owns a
+ * run of framebuffer slots, a property change only rewrites the slots it
+ * affects and the framebuffer turns the old and new slot bounds into damage
+ * rects. Nothing is allocated after UI_init.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include "display_fb.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define UI_MAX_WIDGETS       8
+#define UI_CLOCK_DIGITS      4   //H H : M M, the colon has its own slot
+
+#define UI_BATTERY_WIDTH     20  //body plus terminal
+#define UI_BATTERY_HEIGHT    8
+#define UI_BATTERY_LOW       20  //percent drawn in the low color at or below
+#define UI_BATTERY_FRAME     0xFFFF
+#define UI_BATTERY_LEVEL     0x07E0
+#define UI_BATTERY_LOW_LEVEL 0xF800
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+/* Horizontal placement on the screen. */
+typedef enum {
+	UI_ALIGN_LEFT = 0,
+	UI_ALIGN_CENTER,
+	UI_ALIGN_RIGHT,
+} UI_align_t;
+
+/* How a property change reaches the screen. */
+typedef enum {
+	UI_TRANSITION_NONE = 0,
+	UI_TRANSITION_UP,    //scroll the new content in from the bottom (display_anim)
+	UI_TRANSITION_DOWN,  //scroll the new content in from the top
+} UI_transition_t;
+
+/* Where a widget goes, re-evaluated whenever its size changes. */
+typedef struct {
+	UI_align_t align;
+	int8_t x;     //margin from the aligned edge, shift when centered
+	uint8_t y;    //top edge
+} UI_layout_t;
+
+/* Counters since UI_init. */
+typedef struct {
+	uint32_t updates;        //property changes that touched a slot
+	uint32_t unchanged;      //property changes that matched what is shown
+	uint32_t relayouts;      //widgets whose bounds moved
+	uint32_t commits;
+	uint32_t last_commit_us; //layout, rasterizing and sending of the last commit
+	uint32_t max_commit_us;
+} UI_stats_t;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+/** @brief Initialize the widget arena
+ *
+ *  Call after FB_init. Widgets take framebuffer slots from first_slot upwards.
+ *
+ *  @param first_slot First framebuffer slot the widgets may use
+ *  @param background RGB565 screen background (battery gauge interior)
+ *  @return Void.
+ */
+void UI_init(int first_slot, uint16_t background);
+
+/** @brief Add a clock widget
+ *
+ *  @param layout Placement
+ *  @param digits Glyphs for 0 - 9, all the same size
+ *  @param colon Glyph between hours and minutes, same height as the digits
+ *  @param pal Palette built for the glyphs
+ *  @return Widget id.
+ */
+int UI_addClock(const UI_layout_t* layout, const LCD_glyph_t* digits, const LCD_glyph_t* colon, const LCD_palette_t* pal);
+
+/** @brief Add an icon widget showing one of a set of same sized bitmaps
+ *
+ *  @param layout Placement
+ *  @param icons Compressed bitmaps
+ *  @param count Number of bitmaps
+ *  @return Widget id.
+ */
+int UI_addIcon(const UI_layout_t* layout, const LCD_rle_asset_t* icons, int count);
+
+/** @brief Add a battery gauge, hidden until UI_setBattery gets a level
+ *
+ *  @param layout Placement
+ *  @return Widget id.
+ */
+int UI_addBattery(const UI_layout_t* layout);
+
+/** @brief Add a single line text label
+ *
+ *  @param layout Placement, centered and right aligned labels move as the text changes
+ *  @param font Font to draw with
+ *  @param scale Integer scale (1 - FONT_MAX_SCALE)
+ *  @param pal Palette from FONT_makePalette
+ *  @return Widget id.
+ */
+int UI_addLabel(const UI_layout_t* layout, const FONT_t* font, uint8_t scale, const LCD_palette_t* pal);
+
+/** @brief Show a time on a clock widget
+ *
+ *  @param id Clock widget
+ *  @param hour 0 - 23
+ *  @param minute 0 - 59
+ *  @param transition How a changed time comes in, the first time shown is always instant
+ *  @return Void.
+ */
+void UI_setTime(int id, int hour, int minute, UI_transition_t transition);
+
+/** @brief Show a bitmap of an icon widget
+ *
+ *  @param id Icon widget
+ *  @param index Bitmap index
+ *  @param transition How a changed icon comes in, the first icon shown is always instant
+ *  @return Void.
+ */
+void UI_setIcon(int id, int index, UI_transition_t transition);
+
+/** @brief Set a battery gauge level
+ *
+ *  @param id Battery widget
+ *  @param percent 0 - 100, negative hides the gauge
+ *  @return Void.
+ */
+void UI_setBattery(int id, int percent);
+
+/** @brief Set the text of a label
+ *
+ *  @param id Label widget
+ *  @param text UTF-8 string, truncated to FB_TEXT_MAX - 1 bytes
+ *  @return Void.
+ */
+void UI_setText(int id, const char* text);
+
+/** @brief Current bounds of a widget
+ *
+ *  @param id Widget
+ *  @return Bounds in screen coordinates (empty while the widget has nothing to draw).
+ */
+FB_rect_t UI_getBounds(int id);
+
+/** @brief Send everything that changed since the last commit
+ *
+ *  @return Void.
+ */
+void UI_commit(void);
+
+/** @brief Get the widget counters
+ *
+ *  @param stats Filled with a snapshot of the counters
+ *  @return Void.
+ */
+void UI_getStats(UI_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,232 @@
+/**
+ * @file display_vsync.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Vertical sync from the ST7735S TE line, with a timer fallback
+ *
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <string.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "driver/gpio.h"
+#include "display_main.h"
+#include "display_vsync.h"
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static const char* TAG = "display_vsync";
+
+static LCD_vsync_source_t source = LCD_VSYNC_OFF;
+static int te_pin = -1;
+static SemaphoreHandle_t vsync_sem = NULL;
+static StaticSemaphore_t vsync_sem_buf;
+static esp_timer_handle_t vsync_timer;
+
+static volatile int64_t last_edge_us = 0;  //written by the TE isr
+static int64_t anchor_us = 0;              //timer grid origin
+static uint32_t period_us = LCD_VSYNC_DEFAULT_US;
+static int misses = 0;
+
+static LCD_vsync_stats_t stats;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+//One edge per arm, the isr disarms itself so TE costs nothing between waits
+static void IRAM_ATTR LCD_vsyncIsr(void* arg)
+{
+	BaseType_t woken = pdFALSE;
+
+	gpio_intr_disable(te_pin);
+	last_edge_us = esp_timer_get_time();
+	xSemaphoreGiveFromISR(vsync_sem, &woken);
+	if (woken)
+	{
+		portYIELD_FROM_ISR();
+	}
+}
+
+static void LCD_vsyncTimerCallback(void* arg)
+{
+	xSemaphoreGive(vsync_sem);
+}
+
+//Arm TE and wait for the next edge
+static bool LCD_vsyncWaitEdge(void)
+{
+	xSemaphoreTake(vsync_sem, 0); //drop a stale give
+	gpio_intr_enable(te_pin);
+	if (xSemaphoreTake(vsync_sem, pdMS_TO_TICKS(LCD_VSYNC_TIMEOUT_MS)) == pdTRUE)
+	{
+		return true;
+	}
+	gpio_intr_disable(te_pin);
+	return false;
+}
+
+//No TE to sync to, waiting on a guess of the scan position cannot prevent tearing
+static void LCD_vsyncFallback(void)
+{
+#if LCD_VSYNC_TIMER_FALLBACK
+	//keep the phase of the last edge, it is the best guess of the scan position
+	anchor_us = (last_edge_us != 0) ? last_edge_us : esp_timer_get_time();
+	source = LCD_VSYNC_TIMER;
+#else
+	source = LCD_VSYNC_OFF;
+#endif
+}
+
+esp_err_t LCD_vsyncInit(spi_device_handle_t spi, int te_gpio)
+{
+	esp_err_t ret;
+
+	memset(&stats, 0, sizeof(stats));
+	source = LCD_VSYNC_OFF;
+	period_us = LCD_VSYNC_DEFAULT_US;
+	last_edge_us = 0;
+	misses = 0;
+	vsync_sem = xSemaphoreCreateBinaryStatic(&vsync_sem_buf);
+
+	const esp_timer_create_args_t timer_args = {
+		.callback = LCD_vsyncTimerCallback,
+		.name = "vsync",
+	};
+	ret = esp_timer_create(&timer_args, &vsync_timer);
+	if (ret != ESP_OK)
+	{
+		return ret;
+	}
+
+	if (te_gpio < 0)
+	{
+		ESP_LOGI(TAG, "TE not wired, %s", LCD_VSYNC_TIMER_FALLBACK ? "pacing with a timer" : "flushes are not paced");
+		LCD_vsyncFallback();
+		return ESP_OK;
+	}
+
+	gpio_config_t io_conf = {
+		.pin_bit_mask = 1ULL << te_gpio,
+		.mode = GPIO_MODE_INPUT,
+		.intr_type = GPIO_INTR_POSEDGE,
+	};
+	ret = gpio_config(&io_conf);
+	if (ret != ESP_OK)
+	{
+		return ret;
+	}
+
+	//install gpio isr service, someone else may have done it already
+	ret = gpio_install_isr_service(0);
+	if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE)
+	{
+		return ret;
+	}
+	te_pin = te_gpio;
+	gpio_intr_disable(te_pin);
+	gpio_isr_handler_add(te_pin, LCD_vsyncIsr, NULL);
+
+	LCD_setTearingEffect(spi, true);
+
+	//two edges prove the line is wired and give the refresh period
+	int64_t first = 0;
+	if (LCD_vsyncWaitEdge())
+	{
+		first = last_edge_us;
+	}
+	if (first == 0 || !LCD_vsyncWaitEdge())
+	{
+		ESP_LOGW(TAG, "no TE edges on GPIO %d, %s", te_gpio, LCD_VSYNC_TIMER_FALLBACK ? "pacing with a timer" : "flushes are not paced");
+		gpio_isr_handler_remove(te_pin);
+		LCD_setTearingEffect(spi, false);
+		LCD_vsyncFallback();
+		return ESP_OK;
+	}
+
+	period_us = (uint32_t)(last_edge_us - first);
+	source = LCD_VSYNC_TE;
+	ESP_LOGI(TAG, "TE on GPIO %d, refresh period %" PRIu32 " us", te_gpio, period_us);
+	return ESP_OK;
+}
+
+int64_t LCD_vsyncDeadline(void)
+{
+	const int64_t now = esp_timer_get_time();
+	const int64_t base = (source == LCD_VSYNC_TE) ? last_edge_us : anchor_us;
+
+	if (now < base)
+	{
+		return base;
+	}
+	return base + ((now - base) / period_us + 1) * period_us;
+}
+
+int64_t LCD_vsyncWait(void)
+{
+	//a sleeping panel scans nothing out, there is nothing to tear
+	if (source == LCD_VSYNC_OFF || LCD_getPanelMode() == LCD_PANEL_SLEEP)
+	{
+		return esp_timer_get_time();
+	}
+	stats.waits++;
+
+	if (source == LCD_VSYNC_TE)
+	{
+		if (LCD_vsyncWaitEdge())
+		{
+			misses = 0;
+			return last_edge_us;
+		}
+
+		stats.timeouts++;
+		if (++misses >= LCD_VSYNC_MAX_MISSES)
+		{
+			ESP_LOGW(TAG, "TE stopped, %s", LCD_VSYNC_TIMER_FALLBACK ? "pacing with a timer" : "flushes are not paced");
+			gpio_isr_handler_remove(te_pin);
+			LCD_vsyncFallback();
+		}
+		return esp_timer_get_time();
+	}
+
+	//timer grid, one shot so an idle watch is not woken every frame
+	const int64_t next = LCD_vsyncDeadline();
+	const int64_t delay = next - esp_timer_get_time();
+	xSemaphoreTake(vsync_sem, 0);
+	esp_timer_start_once(vsync_timer, (delay > 0) ? delay : 1);
+	xSemaphoreTake(vsync_sem, portMAX_DELAY);
+	return next;
+}
+
+void LCD_vsyncFrameDone(int64_t sync_us)
+{
+	const uint32_t elapsed = (uint32_t)(esp_timer_get_time() - sync_us);
+
+	stats.frames++;
+	if (elapsed > stats.max_frame_us)
+	{
+		stats.max_frame_us = elapsed;
+	}
+	//the scan caught up with the write, the frame may have torn
+	if (elapsed > period_us)
+	{
+		stats.overruns++;
+	}
+}
+
+void LCD_vsyncGetStats(LCD_vsync_stats_t* stats_out)
+{
+	memcpy(stats_out, &stats, sizeof(*stats_out));
+	stats_out->source = source;
+	stats_out->period_us = period_us;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file display_vsync.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Vertical sync from the ST7735S TE line, with a timer fallback
+ *
+ * Flushes wait for the start of vertical blanking before sending, so the
+ * write pointer trails the panel scan instead of crossing it mid frame. The
+ * TE pin is only armed while someone waits, so an idle watch takes no
+ * interrupts. Without TE (PIN_TE is -1, or the line stops pulsing) there is
+ * nothing to sync to and waits return at once, unless LCD_VSYNC_TIMER_FALLBACK
+ * is set: then waits land on a fixed timer grid, with no tearing guarantee but
+ * a fixed frame deadline to budget against, at the cost of up to a period per
+ * wait.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include <inttypes.h>
+#include "esp_err.h"
+#include "driver/spi_master.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#ifndef LCD_VSYNC_TIMER_FALLBACK
+#define LCD_VSYNC_TIMER_FALLBACK 0    //pace with a timer when TE is missing (opt in, it only adds latency)
+#endif
+
+#define LCD_VSYNC_DEFAULT_US   16667  //timer period, about the panel refresh with the default frame rate control
+#define LCD_VSYNC_TIMEOUT_MS   50     //a TE edge later than this counts as missing
+#define LCD_VSYNC_MAX_MISSES   3      //consecutive missing edges before giving up on TE
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+/* Where vsync comes from. */
+typedef enum {
+	LCD_VSYNC_OFF = 0,  //not initialized or no TE, waits return at once
+	LCD_VSYNC_TE,       //TE pin interrupt
+	LCD_VSYNC_TIMER,    //fixed timer grid (LCD_VSYNC_TIMER_FALLBACK)
+} LCD_vsync_source_t;
+
+/* Counters since LCD_vsyncInit. */
+typedef struct {
+	LCD_vsync_source_t source;
+	uint32_t period_us;     //measured from TE at init, LCD_VSYNC_DEFAULT_US otherwise
+	uint32_t waits;
+	uint32_t timeouts;      //TE edges that never came
+	uint32_t frames;        //frames reported with LCD_vsyncFrameDone
+	uint32_t overruns;      //frames still sending when the next vsync was due
+	uint32_t max_frame_us;
+} LCD_vsync_stats_t;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+/** @brief Enable the TE output and measure the refresh period
+ *
+ *  Call after LCD_init and before FB_init. If te_gpio is -1 or no TE edges
+ *  arrive, waits return at once (or use the timer with LCD_VSYNC_TIMER_FALLBACK).
+ *
+ *  @param spi The device handle used for sending commands.
+ *  @param te_gpio GPIO wired to TE, -1 if not wired
+ *  @return ESP_OK on success.
+ */
+esp_err_t LCD_vsyncInit(spi_device_handle_t spi, int te_gpio);
+
+/** @brief Block until the next vertical blanking
+ *
+ *  Returns at once while the panel sleeps (nothing is scanned out) or without a vsync source.
+ *
+ *  @return Time of the vsync (esp_timer microseconds).
+ */
+int64_t LCD_vsyncWait(void);
+
+/** @brief Expected time of the next vsync
+ *
+ *  @return Time in esp_timer microseconds.
+ */
+int64_t LCD_vsyncDeadline(void);
+
+/** @brief Report that a frame started at a vsync has been sent
+ *
+ *  @param sync_us Value returned by the LCD_vsyncWait the frame started on
+ *  @return Void.
+ */
+void LCD_vsyncFrameDone(int64_t sync_us);
+
+/** @brief Get the vsync counters
+ *
+ *  @param stats Filled with a snapshot of the counters
+ *  @return Void.
+ */
+void LCD_vsyncGetStats(LCD_vsync_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,342 @@
+/**
+ * @file hid_ble.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief BLE HID-over-GATT transport
+ *
+ * Built on the esp_hid component, which owns the HID, battery and device
+ * information services. This file only handles what is ours: advertising
+ * (fast for a while, then slow to save power), bonding without IO, asking for
+ * a short connection interval with slave latency so the link is both quick to
+ * answer a press and cheap while idle, and forwarding link events to the
+ * sender.
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+/* ESP related*/
+#include "esp_log.h"
+#include "esp_err.h"
+#include "esp_bt.h"
+#include "esp_bt_main.h"
+#include "esp_gap_ble_api.h"
+#include "esp_gatts_api.h"
+#include "esp_hidd.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include <string.h>
+#include <inttypes.h>
+
+/* Inter-compoent. */
+#include "hid_transport.h"
+#include "hid_sender.h"
+#include "mem_stats.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+/* Advertising intervals in 0.625 ms units. */
+#define HID_BLE_ADV_FAST_MIN       0x0020    //20 ms
+#define HID_BLE_ADV_FAST_MAX       0x0030    //30 ms
+#define HID_BLE_ADV_SLOW_MIN       0x0640    //1 s
+#define HID_BLE_ADV_SLOW_MAX       0x0780    //1.2 s
+#define HID_BLE_ADV_FAST_MS        30000     //fast advertising after boot or a disconnect
+
+/* Requested connection parameters, intervals in 1.25 ms units, timeout in 10 ms units. */
+#define HID_BLE_CONN_INT_MIN       6         //7.5 ms
+#define HID_BLE_CONN_INT_MAX       12        //15 ms
+#define HID_BLE_CONN_LATENCY       30        //connection events the device may skip while idle
+#define HID_BLE_CONN_TIMEOUT       400       //4 s
+
+#define HID_BLE_APPEARANCE         ESP_HID_APPEARANCE_GENERIC
+#define HID_BLE_SERVICE_UUID       0x1812
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+/* Connection counters since boot, logged on every disconnect. */
+typedef struct {
+    uint32_t connects;
+    uint32_t disconnects;
+    uint32_t param_updates;
+    uint32_t notify_errors;
+    uint16_t conn_interval;     //1.25 ms units, as granted by the host
+    uint16_t conn_latency;
+    uint16_t conn_timeout;
+    int64_t adv_to_connect_us;  //advertising start to connection, last connection
+} HID_ble_stats_t;
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static const char* TAG = "hid_ble";
+
+static esp_hidd_dev_t* hid_dev = NULL;
+static esp_timer_handle_t adv_timer;
+static bool adv_slow = false;
+static int64_t adv_start_us;
+
+static esp_hid_raw_report_map_t report_maps[1];
+
+static esp_hid_device_config_t hid_config = {
+    .vendor_id = 0x16C0,
+    .product_id = 0x05DF,
+    .version = 0x0100,
+    .device_name = HID_DEVICE_NAME,
+    .manufacturer_name = "Espressif",
+    .serial_number = "1234567890",
+    .report_maps = report_maps,
+    .report_maps_len = 1,
+};
+
+static uint8_t hid_service_uuid128[] = {
+    /* LSB <--------------------------------------------------------------------------------> MSB */
+    0xfb, 0x34, 0x9b, 0x5f, 0x80, 0x00, 0x00, 0x80, 0x00, 0x10, 0x00, 0x00,
+    HID_BLE_SERVICE_UUID & 0xFF, HID_BLE_SERVICE_UUID >> 8, 0x00, 0x00,
+};
+
+static esp_ble_adv_data_t adv_data = {
+    .set_scan_rsp = false,
+    .include_name = true,
+    .include_txpower = true,
+    .min_interval = HID_BLE_CONN_INT_MIN,
+    .max_interval = HID_BLE_CONN_INT_MAX,
+    .appearance = HID_BLE_APPEARANCE,
+    .service_uuid_len = sizeof(hid_service_uuid128),
+    .p_service_uuid = hid_service_uuid128,
+    .flag = ESP_BLE_ADV_FLAG_GEN_DISC | ESP_BLE_ADV_FLAG_BREDR_NOT_SPT,
+};
+
+static esp_ble_adv_params_t adv_params = {
+    .adv_int_min = HID_BLE_ADV_FAST_MIN,
+    .adv_int_max = HID_BLE_ADV_FAST_MAX,
+    .adv_type = ADV_TYPE_IND,
+    .own_addr_type = BLE_ADDR_TYPE_PUBLIC,
+    .channel_map = ADV_CHNL_ALL,
+    .adv_filter_policy = ADV_FILTER_ALLOW_SCAN_ANY_CON_ANY,
+};
+
+static HID_ble_stats_t stats;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+static void HIDBle_startAdvertising(bool slow)
+{
+    adv_slow = slow;
+    adv_params.adv_int_min = slow ? HID_BLE_ADV_SLOW_MIN : HID_BLE_ADV_FAST_MIN;
+    adv_params.adv_int_max = slow ? HID_BLE_ADV_SLOW_MAX : HID_BLE_ADV_FAST_MAX;
+
+    esp_err_t ret = esp_ble_gap_start_advertising(&adv_params);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "failed to start advertising: %s", esp_err_to_name(ret));
+        return;
+    }
+    if (!slow) {
+        adv_start_us = esp_timer_get_time();
+        esp_timer_stop(adv_timer);
+        esp_timer_start_once(adv_timer, HID_BLE_ADV_FAST_MS * 1000ULL);
+    }
+}
+
+//Fast advertising window is over, the restart happens on ADV_STOP_COMPLETE
+static void HIDBle_advTimerCallback(void* arg)
+{
+    ESP_LOGI(TAG, "no host yet, slowing advertising down");
+    adv_slow = true;
+    esp_ble_gap_stop_advertising();
+}
+
+static void HIDBle_logStats(void)
+{
+    ESP_LOGI(TAG, "%"PRIu32" connects, %"PRIu32" disconnects, %"PRIu32" param updates, %"PRIu32" notify errors",
+             stats.connects, stats.disconnects, stats.param_updates, stats.notify_errors);
+    ESP_LOGI(TAG, "interval %u.%02u ms, latency %u, timeout %u ms, advertising to connect %lld ms",
+             stats.conn_interval * 125 / 100, stats.conn_interval * 125 % 100, stats.conn_latency,
+             stats.conn_timeout * 10, stats.adv_to_connect_us / 1000);
+}
+
+/* BLE GAP callback handler */
+static void HIDBle_gapCallback(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t *param)
+{
+    switch (event) {
+    case ESP_GAP_BLE_ADV_DATA_SET_COMPLETE_EVT:
+        HIDBle_startAdvertising(false);
+        break;
+    case ESP_GAP_BLE_ADV_START_COMPLETE_EVT:
+        if (param->adv_start_cmpl.status != ESP_BT_STATUS_SUCCESS) {
+            ESP_LOGE(TAG, "advertising start failed, status:%d", param->adv_start_cmpl.status);
+        }
+        break;
+    case ESP_GAP_BLE_ADV_STOP_COMPLETE_EVT:
+        if (adv_slow) {
+            HIDBle_startAdvertising(true);
+        }
+        break;
+    case ESP_GAP_BLE_SEC_REQ_EVT:
+        esp_ble_gap_security_rsp(param->ble_security.ble_req.bd_addr, true);
+        break;
+    case ESP_GAP_BLE_AUTH_CMPL_EVT:
+        if (param->ble_security.auth_cmpl.success) {
+            ESP_LOGI(TAG, "bonded with %02x:%02x:%02x:%02x:%02x:%02x",
+                     param->ble_security.auth_cmpl.bd_addr[0], param->ble_security.auth_cmpl.bd_addr[1],
+                     param->ble_security.auth_cmpl.bd_addr[2], param->ble_security.auth_cmpl.bd_addr[3],
+                     param->ble_security.auth_cmpl.bd_addr[4], param->ble_security.auth_cmpl.bd_addr[5]);
+        } else {
+            ESP_LOGE(TAG, "authentication failed, reason:0x%x", param->ble_security.auth_cmpl.fail_reason);
+        }
+        break;
+    case ESP_GAP_BLE_UPDATE_CONN_PARAMS_EVT:
+        stats.param_updates++;
+        stats.conn_interval = param->update_conn_params.conn_int;
+        stats.conn_latency = param->update_conn_params.latency;
+        stats.conn_timeout = param->update_conn_params.timeout;
+        ESP_LOGI(TAG, "connection params: interval %u, latency %u, timeout %u, status %d",
+                 param->update_conn_params.conn_int, param->update_conn_params.latency,
+                 param->update_conn_params.timeout, param->update_conn_params.status);
+        break;
+    default:
+        break;
+    }
+}
+
+/* GATT server events go to esp_hid, connect and notify confirmations are looked at first. */
+static void HIDBle_gattsCallback(esp_gatts_cb_event_t event, esp_gatt_if_t gatts_if, esp_ble_gatts_cb_param_t *param)
+{
+    switch (event) {
+    case ESP_GATTS_CONNECT_EVT: {
+        //short interval so a press goes out right away, slave latency so idle costs little
+        esp_ble_conn_update_params_t conn_params = {
+            .min_int = HID_BLE_CONN_INT_MIN,
+            .max_int = HID_BLE_CONN_INT_MAX,
+            .latency = HID_BLE_CONN_LATENCY,
+            .timeout = HID_BLE_CONN_TIMEOUT,
+        };
+        memcpy(conn_params.bda, param->connect.remote_bda, sizeof(esp_bd_addr_t));
+        esp_ble_gap_update_conn_params(&conn_params);
+        break;
+    }
+    case ESP_GATTS_CONF_EVT:
+        //input reports are notifications, the stack confirms each one once it is sent
+        if (param->conf.status != ESP_GATT_OK) {
+            stats.notify_errors++;
+        }
+        HIDSender_reportSent(param->conf.status == ESP_GATT_OK);
+        break;
+    default:
+        break;
+    }
+    esp_hidd_gatts_event_handler(event, gatts_if, param);
+}
+
+/* esp_hid device event handler. */
+static void HIDBle_hiddCallback(void *handler_args, esp_event_base_t base, int32_t id, void *event_data)
+{
+    esp_hidd_event_data_t *param = (esp_hidd_event_data_t *)event_data;
+
+    switch ((esp_hidd_event_t)id) {
+    case ESP_HIDD_START_EVENT:
+        ESP_LOGI(TAG, "hid service started, advertising");
+        esp_ble_gap_config_adv_data(&adv_data);
+        break;
+    case ESP_HIDD_CONNECT_EVENT:
+        esp_timer_stop(adv_timer);
+        stats.connects++;
+        stats.adv_to_connect_us = esp_timer_get_time() - adv_start_us;
+        ESP_LOGI(TAG, "connected");
+        HIDSender_setConnected(true);
+        MEM_report("ble open");
+        break;
+    case ESP_HIDD_PROTOCOL_MODE_EVENT:
+        ESP_LOGI(TAG, "%s protocol", param->protocol_mode.protocol_mode == ESP_HID_PROTOCOL_MODE_BOOT ? "boot" : "report");
+        HIDSender_setProtocolMode(param->protocol_mode.protocol_mode == ESP_HID_PROTOCOL_MODE_BOOT ? HID_PROTOCOL_BOOT
+                                                                                                   : HID_PROTOCOL_REPORT);
+        break;
+    case ESP_HIDD_DISCONNECT_EVENT:
+        stats.disconnects++;
+        ESP_LOGI(TAG, "disconnected, reason:0x%x", param->disconnect.reason);
+        HIDSender_setConnected(false);
+        //a new connection starts in report protocol
+        HIDSender_setProtocolMode(HID_PROTOCOL_REPORT);
+        HIDBle_logStats();
+        MEM_report("ble close");
+        HIDBle_startAdvertising(false);
+        break;
+    case ESP_HIDD_STOP_EVENT:
+        ESP_LOGI(TAG, "hid service stopped");
+        break;
+    default:
+        break;
+    }
+}
+
+static esp_err_t HIDBle_send(uint8_t report_id, uint8_t* data, uint16_t len)
+{
+    return esp_hidd_dev_input_set(hid_dev, 0, report_id, data, len);
+}
+
+static esp_err_t HIDBle_init(const uint8_t* report_map, int report_map_len)
+{
+    esp_err_t ret;
+
+    memset(&stats, 0, sizeof(stats));
+    report_maps[0].data = report_map;
+    report_maps[0].len = report_map_len;
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = HIDBle_advTimerCallback,
+        .name = "hid_ble_adv",
+    };
+    ret = esp_timer_create(&timer_args, &adv_timer);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "failed to create timer: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+#if CONFIG_IDF_TARGET_ESP32
+    ESP_ERROR_CHECK(esp_bt_controller_mem_release(ESP_BT_MODE_CLASSIC_BT));
+#endif
+
+    esp_bt_controller_config_t bt_cfg = BT_CONTROLLER_INIT_CONFIG_DEFAULT();
+
+    /* Init and enable bt stack and bluedroid. */
+    ESP_ERROR_CHECK(esp_bt_controller_init(&bt_cfg));
+    ESP_ERROR_CHECK(esp_bt_controller_enable(ESP_BT_MODE_BLE));
+    ESP_ERROR_CHECK(esp_bluedroid_init());
+    ESP_ERROR_CHECK(esp_bluedroid_enable());
+
+    ESP_ERROR_CHECK(esp_ble_gap_register_callback(HIDBle_gapCallback));
+    ESP_ERROR_CHECK(esp_ble_gap_set_device_name(HID_DEVICE_NAME));
+
+    /* Bond, no display or keyboard so just works pairing. */
+    esp_ble_auth_req_t auth_req = ESP_LE_AUTH_BOND;
+    esp_ble_io_cap_t iocap = ESP_IO_CAP_NONE;
+    uint8_t key_mask = ESP_BLE_ENC_KEY_MASK | ESP_BLE_ID_KEY_MASK;
+    esp_ble_gap_set_security_param(ESP_BLE_SM_AUTHEN_REQ_MODE, &auth_req, sizeof(auth_req));
+    esp_ble_gap_set_security_param(ESP_BLE_SM_IOCAP_MODE, &iocap, sizeof(iocap));
+    esp_ble_gap_set_security_param(ESP_BLE_SM_SET_INIT_KEY, &key_mask, sizeof(key_mask));
+    esp_ble_gap_set_security_param(ESP_BLE_SM_SET_RSP_KEY, &key_mask, sizeof(key_mask));
+
+    ESP_ERROR_CHECK(esp_ble_gatts_register_callback(HIDBle_gattsCallback));
+
+    /* Advertising starts from ESP_HIDD_START_EVENT once the services are up. */
+    ESP_LOGI(TAG, "starting hid device");
+    ret = esp_hidd_dev_init(&hid_config, ESP_HID_TRANSPORT_BLE, HIDBle_hiddCallback, &hid_dev);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "failed to start hid device: %s", esp_err_to_name(ret));
+    }
+    return ret;
+}
+
+const HID_transport_t hid_ble_transport = {
+    .name = "ble",
+    .init = HIDBle_init,
+    .send = HIDBle_send,
+    .activity = NULL,
+};
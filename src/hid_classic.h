@@ -0,0 +1,69 @@
+/**
+ * @file hid_classic.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Classic BT HID transport
+ *
+ * Bluedroid HID device profile on the ESP32's BR/EDR controller. Exposed to
+ * the rest of the app as hid_classic_transport, see hid_transport.h.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+//BT & HID related
+#include "esp_hidd_api.h"
+#include "esp_gap_bt_api.h"
+#include "esp_err.h"
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+/* SDP record and L2CAP QoS handed to esp_bt_hid_device_register_app, the sender keeps the report state. */
+typedef struct {
+    esp_hidd_app_param_t app_param;
+    esp_hidd_qos_param_t in_qos;
+    esp_hidd_qos_param_t out_qos;
+} HID_config_t;
+
+/************************************************
+ *  Functions
+ ***********************************************/
+
+/** @brief Bluetooth GAP (generic access profile) event handler.
+ *
+ *  Handles authentification, GAP pin input, and SSP related events
+ *
+ *  @param event GAP event
+ *  @param param optional parameter passed with event
+ *  @return Void.
+ */
+void esp_bt_gap_cb(esp_bt_gap_cb_event_t event, esp_bt_gap_cb_param_t *param);
+
+/** @brief Bluetooth HID device event handler.
+ *
+ *  Handles initialization, app registration, device connect/disconnection, get/send HID report
+ *
+ *  @param event HID event
+ *  @param param optional parameter passed with event
+ *  @return void
+ */
+void esp_bt_hidd_cb(esp_hidd_cb_event_t event, esp_hidd_cb_param_t *param);
+
+/** @brief Connection closed, report memory use.
+ *
+ *  @return Void.
+ */
+void bt_app_shut_down(void);
+
+#ifdef __cplusplus
+}
+#endif
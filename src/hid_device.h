@@ -16,40 +16,17 @@ extern "C" {
  *  Includes
  ***********************************************/
 
-//BLE & HID related
-#include "esp_hidd_api.h"
-#include "esp_bt_main.h"
-#include "esp_bt_device.h"
-#include "esp_bt.h"
 #include "esp_err.h"
-#include "esp_gap_bt_api.h"
-
-//ESP includes
-#include "esp_sntp.h"
-#include "esp_system.h"
-#include "esp_log.h"
-
-/************************************************
- *  TYPE DEFINITIONS
- ***********************************************/
-
-/* Configuration struct containing all global data needed for the HID protocol. */
-typedef struct {
-    esp_hidd_app_param_t app_param;
-    esp_hidd_qos_param_t both_qos;
-    uint8_t protocol_mode;
-    SemaphoreHandle_t mouse_mutex;
-    uint8_t buffer[REPORT_BUFFER_SIZE];
-} HID_config_t;
+#include <inttypes.h>
 
 /************************************************
  *  Functions
  ***********************************************/
 
-/** @brief Initialize display device
+/** @brief Initialize the push buttons
  *
- *  Initialize GPIO and send all necessary commands
- *  for display startup
+ *  Configure the push buttons, gestures are posted to the message bus
+ *  and handled by the dispatcher. BUS_init must have been called.
  *
  *  @return Void.
  */
@@ -57,44 +34,22 @@ void GPIO_init(void);
 
 /** @brief Initialize Bluetooth for display device
  *
- *  Initialize BT stack, global configurations and settings
+ *  Initialize NVS, the report sender and the transport this build uses
+ *  (Classic HID or HID-over-GATT), which starts connecting to a host.
  *
  *  @return Void.
  */
 void HIDDevice_BT_init(void);
 
-/** @brief Bluetooth GAP (generic access profile) event handler.
- *
- *  Handles authentification, GAP pin input, and SSP related events
- *
- *  @param event GAP event
- *  @param param optional parameter passed with event
- *  @return Void.
- */
-void esp_bt_gap_cb(esp_bt_gap_cb_event_t event, esp_bt_gap_cb_param_t *param);
-
-/** @brief Bluetooth HID device event handler.
- *
- *  Handles initialization, app registration, device connect/disconnection, get/send HID report
- *
- *  @param event HID event
- *  @param param optional parameter passed with event
- *  @return void
- */
-void esp_bt_hidd_cb(esp_hidd_cb_event_t event, esp_hidd_cb_param_t *param);
-
 /** @brief Send HID report
  *
- *  @param data HID report data
- *  @return Void.
- */
-void send_media_report(uint8_t *data);
-
-/** @brief Cleanup and app shut down.
+ *  Queues the consumer usage of every CTRL_ bit for the sender task and
+ *  returns right away. Several bits are sent back to back as one batch.
  *
+ *  @param data CTRL_ bitmask
  *  @return Void.
  */
-void bt_app_shut_down(void);
+void send_media_report(uint8_t *data);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,368 @@
+/**
+ * @file hid_hosts.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Bonded host cache in NVS and fast reconnect
+ *
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <string.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_gap_bt_api.h"
+#include "esp_hidd_api.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "nvs.h"
+#include "hid_hosts.h"
+#include "mem_stats.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define HID_HOSTS_NVS_NAMESPACE  "hid_hosts"
+#define HID_HOSTS_NVS_KEY        "hosts"
+#define HID_HOSTS_BOND_MAX       16
+#define HID_HOSTS_TASK_STACK     2560
+#define HID_HOSTS_TASK_PRIORITY  4
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+typedef enum {
+    HOSTS_IDLE = 0,      //discoverable, or nothing started yet
+    HOSTS_PAGING,        //waiting for the page of hosts[page_index - 1]
+    HOSTS_BACKOFF,       //waiting for the next round
+    HOSTS_CONNECTED,
+} HID_hosts_state_t;
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static const char* TAG = "hid_hosts";
+
+static HID_host_t hosts[HID_HOSTS_MAX];   //most recent first
+static int host_count = 0;
+static nvs_handle_t nvs;
+static esp_timer_handle_t page_timer;
+static TaskHandle_t hosts_task = NULL;
+static SemaphoreHandle_t hosts_mutex = NULL;
+static StaticTask_t hosts_task_buf;
+static StackType_t hosts_task_stack[HID_HOSTS_TASK_STACK];
+static StaticSemaphore_t hosts_mutex_buf;
+
+static HID_hosts_state_t state = HOSTS_IDLE;
+static int page_index;
+static int page_round;
+static int64_t reconnect_start_us;
+static int64_t hidden_end_us;    //paging gives up and goes discoverable here
+
+static HID_hosts_stats_t stats;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+static void HIDHosts_save(void)
+{
+    esp_err_t ret = nvs_set_blob(nvs, HID_HOSTS_NVS_KEY, hosts, host_count * sizeof(HID_host_t));
+    if (ret == ESP_OK) {
+        ret = nvs_commit(nvs);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "failed to save hosts: %s", esp_err_to_name(ret));
+    }
+}
+
+static int HIDHosts_find(const uint8_t* addr)
+{
+    for (int i = 0; i < host_count; i++) {
+        if (memcmp(hosts[i].addr, addr, ESP_BD_ADDR_LEN) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+//Move a host to the front, adding it (and dropping the oldest) if it is new
+static void HIDHosts_moveToFront(const uint8_t* addr)
+{
+    HID_host_t host;
+    int i = HIDHosts_find(addr);
+
+    if (i < 0) {
+        memset(&host, 0, sizeof(host));
+        memcpy(host.addr, addr, ESP_BD_ADDR_LEN);
+        i = (host_count < HID_HOSTS_MAX) ? host_count++ : HID_HOSTS_MAX - 1;
+    } else {
+        host = hosts[i];
+    }
+
+    memmove(&hosts[1], &hosts[0], i * sizeof(HID_host_t));
+    hosts[0] = host;
+}
+
+static void HIDHosts_remove(int i)
+{
+    memmove(&hosts[i], &hosts[i + 1], (host_count - i - 1) * sizeof(HID_host_t));
+    host_count--;
+}
+
+static void HIDHosts_fallback(void)
+{
+    esp_timer_stop(page_timer);
+    state = HOSTS_IDLE;
+    stats.fallbacks++;
+    ESP_LOGI(TAG, "no cached host answered, making self discoverable");
+    esp_bt_gap_set_scan_mode(ESP_BT_CONNECTABLE, ESP_BT_GENERAL_DISCOVERABLE);
+}
+
+//Arm the page timer, cut short so it fires by the end of the non discoverable window
+static void HIDHosts_arm(int64_t timeout_us)
+{
+    const int64_t left_us = hidden_end_us - esp_timer_get_time();
+    esp_timer_start_once(page_timer, (timeout_us < left_us) ? timeout_us : left_us);
+}
+
+//Page the next host, or wait out the backoff once a round is done
+static void HIDHosts_pageNext(void)
+{
+    if (esp_timer_get_time() >= hidden_end_us) {
+        HIDHosts_fallback();
+        return;
+    }
+
+    if (page_index >= host_count) {
+        page_round++;
+        page_index = 0;
+        if (host_count == 0 || page_round >= HID_HOSTS_ROUNDS) {
+            HIDHosts_fallback();
+            return;
+        }
+
+        int backoff_ms = HID_HOSTS_BACKOFF_MS << (page_round - 1);
+        if (backoff_ms > HID_HOSTS_BACKOFF_MAX_MS) {
+            backoff_ms = HID_HOSTS_BACKOFF_MAX_MS;
+        }
+        state = HOSTS_BACKOFF;
+        HIDHosts_arm(backoff_ms * 1000LL);
+        return;
+    }
+
+    HID_host_t* host = &hosts[page_index++];
+    ESP_LOGI(TAG, "paging %02x:%02x:%02x:%02x:%02x:%02x (round %d)", host->addr[0], host->addr[1],
+             host->addr[2], host->addr[3], host->addr[4], host->addr[5], page_round);
+
+    state = HOSTS_PAGING;
+    stats.pages++;
+    if (esp_bt_hid_device_connect(host->addr) != ESP_OK) {
+        //treat it as a page that failed right away
+        host->failures++;
+        stats.page_failures++;
+        HIDHosts_pageNext();
+        return;
+    }
+    HIDHosts_arm(HID_HOSTS_PAGE_TIMEOUT_MS * 1000LL);
+}
+
+static void HIDHosts_pageFailed(void)
+{
+    esp_timer_stop(page_timer);
+    if (page_index > 0 && hosts[page_index - 1].failures < UINT8_MAX) {
+        hosts[page_index - 1].failures++;
+    }
+    stats.page_failures++;
+    HIDHosts_pageNext();
+}
+
+static void HIDHosts_timerCallback(void* arg)
+{
+    xTaskNotifyGive(hosts_task);
+}
+
+//Page timeouts and backoffs, done in a task so the esp_timer task never waits on hosts_mutex or the stack
+static void HIDHosts_task(void* arg)
+{
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        xSemaphoreTake(hosts_mutex, portMAX_DELAY);
+        //a connection or a restart since the timer fired leaves the timer armed again or the state moved on
+        if (!esp_timer_is_active(page_timer)) {
+            if (state == HOSTS_PAGING) {
+                ESP_LOGW(TAG, "page timed out");
+                HIDHosts_pageFailed();
+            } else if (state == HOSTS_BACKOFF) {
+                HIDHosts_pageNext();
+            }
+        }
+        xSemaphoreGive(hosts_mutex);
+    }
+}
+
+//Start paging from the most recent host, mutex held
+static void HIDHosts_startPaging(void)
+{
+    reconnect_start_us = esp_timer_get_time();
+    hidden_end_us = reconnect_start_us + HID_HOSTS_HIDDEN_MAX_MS * 1000LL;
+    page_index = 0;
+    page_round = 0;
+
+    if (host_count == 0) {
+        state = HOSTS_IDLE;
+        esp_bt_gap_set_scan_mode(ESP_BT_CONNECTABLE, ESP_BT_GENERAL_DISCOVERABLE);
+        return;
+    }
+
+    //a host may still connect on its own while we page
+    esp_bt_gap_set_scan_mode(ESP_BT_CONNECTABLE, ESP_BT_NON_DISCOVERABLE);
+    HIDHosts_pageNext();
+}
+
+esp_err_t HIDHosts_init(void)
+{
+    esp_bd_addr_t bonded[HID_HOSTS_BOND_MAX];
+    int bonded_count = HID_HOSTS_BOND_MAX;
+    size_t size = sizeof(hosts);
+
+    hosts_mutex = xSemaphoreCreateMutexStatic(&hosts_mutex_buf);
+    memset(&stats, 0, sizeof(stats));
+
+    esp_err_t ret = nvs_open(HID_HOSTS_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "failed to open nvs: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ret = nvs_get_blob(nvs, HID_HOSTS_NVS_KEY, hosts, &size);
+    if (ret == ESP_OK && size % sizeof(HID_host_t) == 0) {
+        host_count = size / sizeof(HID_host_t);
+    } else if (ret != ESP_ERR_NVS_NOT_FOUND) {
+        ESP_LOGW(TAG, "discarding cached hosts: %s", esp_err_to_name(ret));
+    }
+
+    //keys may have been erased since, paging those hosts would only fail
+    if (esp_bt_gap_get_bond_device_list(&bonded_count, bonded) == ESP_OK) {
+        for (int i = host_count - 1; i >= 0; i--) {
+            bool found = false;
+            for (int b = 0; b < bonded_count && !found; b++) {
+                found = memcmp(hosts[i].addr, bonded[b], ESP_BD_ADDR_LEN) == 0;
+            }
+            if (!found) {
+                HIDHosts_remove(i);
+            }
+        }
+    }
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = HIDHosts_timerCallback,
+        .name = "hid_hosts",
+    };
+    ret = esp_timer_create(&timer_args, &page_timer);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "failed to create timer: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    hosts_task = xTaskCreateStatic(HIDHosts_task, "hid_hosts", HID_HOSTS_TASK_STACK, NULL, HID_HOSTS_TASK_PRIORITY,
+                                   hosts_task_stack, &hosts_task_buf);
+    MEM_registerTask(hosts_task);
+
+    ESP_LOGI(TAG, "%d cached hosts", host_count);
+    return ESP_OK;
+}
+
+void HIDHosts_reconnect(const uint8_t* hint)
+{
+    xSemaphoreTake(hosts_mutex, portMAX_DELAY);
+    if (state != HOSTS_CONNECTED) {
+        if (hint != NULL) {
+            HIDHosts_moveToFront(hint);
+        }
+        esp_timer_stop(page_timer);
+        HIDHosts_startPaging();
+    }
+    xSemaphoreGive(hosts_mutex);
+}
+
+void HIDHosts_connected(const uint8_t* addr)
+{
+    const int64_t now = esp_timer_get_time();
+
+    xSemaphoreTake(hosts_mutex, portMAX_DELAY);
+    esp_timer_stop(page_timer);
+
+    if (stats.boot_to_connect_us == 0) {
+        stats.boot_to_connect_us = now;
+    }
+    stats.reconnect_us = now - reconnect_start_us;
+
+    HIDHosts_moveToFront(addr);
+    hosts[0].failures = 0;
+    hosts[0].last_seen = (uint32_t)time(NULL);
+    hosts[0].connects++;
+    state = HOSTS_CONNECTED;
+    HIDHosts_save();
+    xSemaphoreGive(hosts_mutex);
+
+    ESP_LOGI(TAG, "connected %" PRId64 " ms after reconnect started", stats.reconnect_us / 1000);
+    esp_bt_gap_read_rssi_delta((uint8_t*)addr);
+}
+
+void HIDHosts_disconnected(void)
+{
+    xSemaphoreTake(hosts_mutex, portMAX_DELAY);
+    if (state == HOSTS_PAGING) {
+        HIDHosts_pageFailed();
+    } else if (state == HOSTS_CONNECTED) {
+        //rssi readings since the connection
+        HIDHosts_save();
+        HIDHosts_startPaging();
+    }
+    xSemaphoreGive(hosts_mutex);
+}
+
+void HIDHosts_setRssi(const uint8_t* addr, int8_t rssi_delta)
+{
+    xSemaphoreTake(hosts_mutex, portMAX_DELAY);
+    const int i = HIDHosts_find(addr);
+    if (i >= 0) {
+        hosts[i].rssi_delta = rssi_delta;
+    }
+    xSemaphoreGive(hosts_mutex);
+}
+
+void HIDHosts_forgetCurrent(void)
+{
+    xSemaphoreTake(hosts_mutex, portMAX_DELAY);
+    if (state == HOSTS_CONNECTED && host_count > 0) {
+        HIDHosts_remove(0);
+        HIDHosts_save();
+    }
+    state = HOSTS_IDLE;
+    xSemaphoreGive(hosts_mutex);
+}
+
+int HIDHosts_get(HID_host_t* out)
+{
+    xSemaphoreTake(hosts_mutex, portMAX_DELAY);
+    const int count = host_count;
+    memcpy(out, hosts, count * sizeof(HID_host_t));
+    xSemaphoreGive(hosts_mutex);
+    return count;
+}
+
+void HIDHosts_getStats(HID_hosts_stats_t* out)
+{
+    xSemaphoreTake(hosts_mutex, portMAX_DELAY);
+    *out = stats;
+    xSemaphoreGive(hosts_mutex);
+}
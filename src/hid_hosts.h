@@ -0,0 +1,135 @@
+/**
+ * @file hid_hosts.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Bonded host cache in NVS and fast reconnect
+ *
+ * The last HID_HOSTS_MAX hosts that connected are kept in NVS, most recent
+ * first, with when they were last seen and how good the link was. At boot and
+ * after a disconnect the device pages them itself (connectable but not
+ * discoverable, so a host can still come in) and only falls back to general
+ * discoverable mode once every round of pages has failed, or after
+ * HID_HOSTS_HIDDEN_MAX_MS, whichever comes first. Rounds are spaced with an
+ * exponential backoff.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "esp_bt_defs.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define HID_HOSTS_MAX              4
+#define HID_HOSTS_PAGE_TIMEOUT_MS  6000  //guard above the controller page timeout (5.12 s)
+#define HID_HOSTS_BACKOFF_MS       500   //wait before the second round, doubled every round
+#define HID_HOSTS_BACKOFF_MAX_MS   8000
+#define HID_HOSTS_ROUNDS           4     //rounds over the cache before going discoverable
+#define HID_HOSTS_HIDDEN_MAX_MS    30000 //longest a reconnect stays non discoverable, every round can take ~25 s with a full cache
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+/* Cached host, persisted as is. */
+typedef struct {
+    esp_bd_addr_t addr;
+    int8_t rssi_delta;          //last RSSI relative to the controller golden range, 0 inside it
+    uint8_t failures;           //pages failed since the last connection
+    uint32_t last_seen;         //wall clock seconds at the last connection
+    uint32_t connects;
+} HID_host_t;
+
+/* Reconnect counters since boot. */
+typedef struct {
+    uint32_t pages;             //connect attempts started by the device
+    uint32_t page_failures;
+    uint32_t fallbacks;         //times every round failed and the device went discoverable
+    int64_t boot_to_connect_us; //boot to the first connection, 0 until connected
+    int64_t reconnect_us;       //reconnect start to connection, last reconnect
+} HID_hosts_stats_t;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+/** @brief Load the cache from NVS
+ *
+ *  NVS must be initialized and the Bluetooth stack enabled, hosts that are no
+ *  longer bonded are dropped.
+ *
+ *  @return ESP_OK on success.
+ */
+esp_err_t HIDHosts_init(void);
+
+/** @brief Page the cached hosts, going discoverable if none answers
+ *
+ *  Call once the HID app is registered, disconnects are handled by
+ *  HIDHosts_disconnected.
+ *
+ *  @param hint Host the stack reports as plugged (register_app.in_use), paged first, NULL if none
+ *  @return Void.
+ */
+void HIDHosts_reconnect(const uint8_t* hint);
+
+/** @brief Report a connection, call from ESP_HIDD_OPEN_EVT
+ *
+ *  Moves the host to the front of the cache and stops paging.
+ *
+ *  @param addr Connected host
+ *  @return Void.
+ */
+void HIDHosts_connected(const uint8_t* addr);
+
+/** @brief Report a failed page or a disconnect
+ *
+ *  While paging this moves on to the next host. After a connection the
+ *  host's link quality is saved and paging starts over.
+ *
+ *  @return Void.
+ */
+void HIDHosts_disconnected(void);
+
+/** @brief Update the link quality, call from ESP_BT_GAP_READ_RSSI_DELTA_EVT
+ *
+ *  @param addr Host the reading is for
+ *  @param rssi_delta RSSI relative to the golden range
+ *  @return Void.
+ */
+void HIDHosts_setRssi(const uint8_t* addr, int8_t rssi_delta);
+
+/** @brief Drop the connected host, call when it unplugs the virtual cable
+ *
+ *  @return Void.
+ */
+void HIDHosts_forgetCurrent(void);
+
+/** @brief Get a copy of the cache
+ *
+ *  @param hosts Filled with up to HID_HOSTS_MAX hosts, most recent first
+ *  @return Number of hosts.
+ */
+int HIDHosts_get(HID_host_t* hosts);
+
+/** @brief Get the reconnect counters
+ *
+ *  @param stats Filled with the current counters
+ *  @return Void.
+ */
+void HIDHosts_getStats(HID_hosts_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
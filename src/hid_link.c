@@ -0,0 +1,216 @@
+/**
+ * @file hid_link.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Link policy and power mode tracking for the Classic BT HID link
+ *
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "hid_link.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define HID_LINK_SERVICE_GUARANTEED  0x02
+#define HID_LINK_NO_DELAY_BOUND      0xFFFFFFFF
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static const char* TAG = "hid_link";
+
+static esp_timer_handle_t idle_timer;
+static int64_t idle_us;
+static portMUX_TYPE link_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static bool connected = false;
+static bool relaxed = false;
+static esp_bd_addr_t host_addr;
+static esp_bt_pm_mode_t mode = ESP_BT_PM_MD_ACTIVE;
+static int64_t mode_since_us;
+static int64_t exit_requested_us;      //activity in sniff, 0 when not waiting for active mode
+
+static HID_link_stats_t stats;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+//Time in the current mode, link_lock held
+static void HIDLink_account(int64_t now)
+{
+    if (connected && mode < HID_LINK_MODES) {
+        stats.mode_us[mode] += now - mode_since_us;
+    }
+    mode_since_us = now;
+}
+
+static void HIDLink_setPoll(const uint8_t* addr, uint32_t t_poll)
+{
+    esp_err_t ret = esp_bt_gap_set_qos((uint8_t*)addr, t_poll);
+
+    taskENTER_CRITICAL(&link_lock);
+    stats.qos_requests++;
+    if (ret != ESP_OK) {
+        stats.qos_errors++;
+    }
+    taskEXIT_CRITICAL(&link_lock);
+
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "failed to set poll interval: %s", esp_err_to_name(ret));
+    }
+}
+
+static void HIDLink_idleCallback(void* arg)
+{
+    esp_bd_addr_t addr;
+    bool relax;
+
+    taskENTER_CRITICAL(&link_lock);
+    relax = connected && !relaxed;
+    relaxed = relaxed || relax;
+    memcpy(addr, host_addr, sizeof(addr));
+    taskEXIT_CRITICAL(&link_lock);
+
+    if (relax) {
+        HIDLink_setPoll(addr, HID_LINK_TPOLL_IDLE);
+    }
+}
+
+esp_err_t HIDLink_init(int idle_ms)
+{
+    idle_us = idle_ms * 1000LL;
+    memset(&stats, 0, sizeof(stats));
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = HIDLink_idleCallback,
+        .name = "hid_link",
+    };
+    esp_err_t ret = esp_timer_create(&timer_args, &idle_timer);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "failed to create timer: %s", esp_err_to_name(ret));
+    }
+    return ret;
+}
+
+void HIDLink_fillQos(esp_hidd_qos_param_t* qos)
+{
+    memset(qos, 0, sizeof(*qos));
+    qos->service_type = HID_LINK_SERVICE_GUARANTEED;
+    qos->token_rate = HID_LINK_REPORT_BYTES * HID_LINK_REPORTS_PER_S;
+    qos->token_bucket_size = HID_LINK_REPORT_BYTES * 4;    //a press/release burst
+    qos->peak_bandwidth = qos->token_rate * 2;
+    qos->access_latency = HID_LINK_ACCESS_LATENCY_US;
+    qos->delay_variation = HID_LINK_NO_DELAY_BOUND;
+}
+
+void HIDLink_connected(const uint8_t* addr)
+{
+    taskENTER_CRITICAL(&link_lock);
+    memcpy(host_addr, addr, sizeof(host_addr));
+    connected = true;
+    relaxed = false;
+    mode = ESP_BT_PM_MD_ACTIVE;
+    mode_since_us = esp_timer_get_time();
+    exit_requested_us = 0;
+    taskEXIT_CRITICAL(&link_lock);
+
+    HIDLink_setPoll(addr, HID_LINK_TPOLL_ACTIVE);
+    esp_timer_stop(idle_timer);
+    esp_timer_start_once(idle_timer, idle_us);
+}
+
+void HIDLink_disconnected(void)
+{
+    esp_timer_stop(idle_timer);
+
+    taskENTER_CRITICAL(&link_lock);
+    HIDLink_account(esp_timer_get_time());
+    connected = false;
+    taskEXIT_CRITICAL(&link_lock);
+
+    HIDLink_logStats();
+}
+
+void HIDLink_activity(void)
+{
+    esp_bd_addr_t addr;
+    bool wake;
+
+    taskENTER_CRITICAL(&link_lock);
+    if (!connected) {
+        taskEXIT_CRITICAL(&link_lock);
+        return;
+    }
+    if (mode == ESP_BT_PM_MD_SNIFF && exit_requested_us == 0) {
+        exit_requested_us = esp_timer_get_time();
+    }
+    wake = relaxed;
+    relaxed = false;
+    memcpy(addr, host_addr, sizeof(addr));
+    taskEXIT_CRITICAL(&link_lock);
+
+    //the report that follows takes the link out of sniff, a short poll keeps it there
+    if (wake) {
+        HIDLink_setPoll(addr, HID_LINK_TPOLL_ACTIVE);
+    }
+    esp_timer_stop(idle_timer);
+    esp_timer_start_once(idle_timer, idle_us);
+}
+
+void HIDLink_modeChanged(esp_bt_pm_mode_t new_mode)
+{
+    const int64_t now = esp_timer_get_time();
+
+    taskENTER_CRITICAL(&link_lock);
+    HIDLink_account(now);
+    mode = new_mode;
+    stats.mode_changes++;
+    if (new_mode == ESP_BT_PM_MD_ACTIVE && exit_requested_us != 0) {
+        const int64_t latency = now - exit_requested_us;
+        stats.sniff_exits++;
+        stats.exit_latency_sum_us += latency;
+        if (latency > stats.exit_latency_max_us) {
+            stats.exit_latency_max_us = latency;
+        }
+        exit_requested_us = 0;
+    }
+    taskEXIT_CRITICAL(&link_lock);
+}
+
+void HIDLink_getStats(HID_link_stats_t* out)
+{
+    taskENTER_CRITICAL(&link_lock);
+    HIDLink_account(esp_timer_get_time());
+    *out = stats;
+    taskEXIT_CRITICAL(&link_lock);
+}
+
+void HIDLink_logStats(void)
+{
+    HID_link_stats_t s;
+    int64_t total = 0;
+
+    HIDLink_getStats(&s);
+    for (int i = 0; i < HID_LINK_MODES; i++) {
+        total += s.mode_us[i];
+    }
+
+    ESP_LOGI(TAG, "link: active %" PRId64 " ms, sniff %" PRId64 " ms (%" PRId64 "%%), hold %" PRId64 " ms, park %" PRId64 " ms, %" PRIu32 " changes",
+             s.mode_us[ESP_BT_PM_MD_ACTIVE] / 1000, s.mode_us[ESP_BT_PM_MD_SNIFF] / 1000,
+             total > 0 ? s.mode_us[ESP_BT_PM_MD_SNIFF] * 100 / total : 0, s.mode_us[ESP_BT_PM_MD_HOLD] / 1000,
+             s.mode_us[ESP_BT_PM_MD_PARK] / 1000, s.mode_changes);
+    ESP_LOGI(TAG, "sniff exits %" PRIu32 ", latency max %" PRId64 " us, avg %" PRId64 " us",
+             s.sniff_exits, s.exit_latency_max_us,
+             s.sniff_exits ? s.exit_latency_sum_us / s.sniff_exits : (int64_t)0);
+}
@@ -0,0 +1,127 @@
+/**
+ * @file hid_link.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Link policy and power mode tracking for the Classic BT HID link
+ *
+ * Bluedroid's power manager puts the HID link in sniff mode on its own once
+ * the link goes quiet, and brings it back to active mode when a report is
+ * sent. There is no public API to request sniff directly, so this module works
+ * around that: it advertises real QoS for the interrupt channel (the host
+ * picks its sniff interval within the access latency), relaxes the poll
+ * interval once the link has been idle for a while, and asks for a short poll
+ * interval again as soon as a button is touched, before the report itself is
+ * ready. Mode changes (ESP_BT_GAP_MODE_CHG_EVT) are timed: the share of the
+ * connection spent in sniff and the sniff exit latency after a press are
+ * what the policy trades against each other. Radio current is not measured
+ * here, it needs a meter on the board.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include <inttypes.h>
+#include "esp_err.h"
+#include "esp_hidd_api.h"
+#include "esp_gap_bt_api.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define HID_LINK_IDLE_MS            2000    //default time without activity before the poll interval is relaxed
+#define HID_LINK_TPOLL_ACTIVE       0x0010  //poll interval in slots (0.625 ms) while in use
+#define HID_LINK_TPOLL_IDLE         0x0190  //poll interval in slots once idle
+
+/* Interrupt channel QoS, sized for the largest input report (keyboard + report ID). */
+#define HID_LINK_REPORT_BYTES       9
+#define HID_LINK_REPORTS_PER_S      100
+#define HID_LINK_ACCESS_LATENCY_US  50000   //what we let the host add, bounds its sniff interval
+
+#define HID_LINK_MODES              4       //indexed by esp_bt_pm_mode_t
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+/* Time per link mode and the cost of leaving sniff. */
+typedef struct {
+    int64_t mode_us[HID_LINK_MODES];  //while connected, indexed by esp_bt_pm_mode_t
+    uint32_t mode_changes;
+    uint32_t sniff_exits;             //returns to active mode after activity in sniff
+    int64_t exit_latency_max_us;      //activity to active mode
+    int64_t exit_latency_sum_us;
+    uint32_t qos_requests;
+    uint32_t qos_errors;
+} HID_link_stats_t;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+/** @brief Create the idle timer
+ *
+ *  @param idle_ms Time without activity before the link is relaxed
+ *  @return ESP_OK on success.
+ */
+esp_err_t HIDLink_init(int idle_ms);
+
+/** @brief Fill the QoS for the interrupt channel
+ *
+ *  @param qos Outgoing (input report) QoS passed to esp_bt_hid_device_register_app
+ *  @return Void.
+ */
+void HIDLink_fillQos(esp_hidd_qos_param_t* qos);
+
+/** @brief Start managing a link, call from ESP_HIDD_OPEN_EVT
+ *
+ *  @param addr Connected host
+ *  @return Void.
+ */
+void HIDLink_connected(const uint8_t* addr);
+
+/** @brief Stop managing the link, call from ESP_HIDD_CLOSE_EVT
+ *
+ *  @return Void.
+ */
+void HIDLink_disconnected(void);
+
+/** @brief Note user activity, the link is asked to be responsive again
+ *
+ *  Call as early as possible (on the button event) so the sniff exit overlaps
+ *  with building the report.
+ *
+ *  @return Void.
+ */
+void HIDLink_activity(void);
+
+/** @brief Record a mode change, call from ESP_BT_GAP_MODE_CHG_EVT
+ *
+ *  @param mode New power mode of the link
+ *  @return Void.
+ */
+void HIDLink_modeChanged(esp_bt_pm_mode_t mode);
+
+/** @brief Get time per mode and the sniff exit latency
+ *
+ *  @param stats Filled with the current statistics
+ *  @return Void.
+ */
+void HIDLink_getStats(HID_link_stats_t* stats);
+
+/** @brief Log the link statistics to the console
+ *
+ *  @return Void.
+ */
+void HIDLink_logStats(void);
+
+#ifdef __cplusplus
+}
+#endif
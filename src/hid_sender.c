@@ -0,0 +1,596 @@
+/**
+ * @file hid_sender.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Non-blocking HID report pipeline
+ *
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "power_mgmt.h"
+#include "hid_sender.h"
+#include "hid_transport.h"
+#include "mem_stats.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define HID_SENDER_TASK_STACK     2048
+#define HID_SENDER_TASK_PRIORITY  10
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+typedef enum {
+    HID_EVT_PRESS = 0,   //action, value: 1 when more actions of the same batch follow
+    HID_EVT_SENT,        //value: 1 on success
+    HID_EVT_TIMER,
+    HID_EVT_LINK,        //value: 1 when connected
+    HID_EVT_PROTOCOL,    //value: protocol mode
+} HID_sender_evt_type_t;
+
+typedef struct {
+    uint8_t type;
+    uint8_t value;
+    HID_action_t action;
+    int64_t time_us;
+} HID_sender_evt_t;
+
+typedef enum {
+    HID_STATE_IDLE = 0,
+    HID_STATE_PRESS_SENT,     //waiting for the press confirmation
+    HID_STATE_HOLDING,        //release timer running
+    HID_STATE_RELEASE_SENT,   //waiting for the release confirmation
+    HID_STATE_BATCH,          //taps going out back to back
+} HID_sender_state_t;
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static const char* TAG = "hid_sender";
+
+static QueueHandle_t evt_queue = NULL;
+static StaticQueue_t evt_queue_buf;
+static uint8_t evt_storage[HID_SENDER_QUEUE_DEPTH * sizeof(HID_sender_evt_t)];
+static StaticTask_t sender_task_buf;
+static StackType_t sender_task_stack[HID_SENDER_TASK_STACK];
+static esp_timer_handle_t hid_timer = NULL;
+static const HID_transport_t* transport = NULL;
+
+//owned by the sender task
+static HID_sender_state_t state = HID_STATE_IDLE;
+static bool connected = false;
+static uint8_t protocol_mode = HID_PROTOCOL_REPORT;
+static HID_sender_evt_t cur;
+static int hold_ms;
+static int64_t deadline_us;
+static int64_t busy_since_us;
+static int in_flight = 0;        //unconfirmed reports of the current batch
+static int batch_left = 0;       //actions of the current batch still pending
+static HID_action_t release_action;  //batch tap whose release the stack refused
+static int release_actions;          //actions that release lets go of, 2 for a packed press
+static bool release_pending = false;
+static int release_tries = 0;
+
+static HID_sender_evt_t pending[HID_SENDER_PENDING];
+static int pending_head = 0;
+static int pending_count = 0;
+
+static HID_sender_stats_t stats;
+static portMUX_TYPE stats_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+static void HIDSender_post(uint8_t type, uint8_t value)
+{
+    HID_sender_evt_t evt = {.type = type, .value = value, .time_us = esp_timer_get_time()};
+    xQueueSend(evt_queue, &evt, 0);
+}
+
+static void HIDSender_timerCallback(void* arg)
+{
+    HIDSender_post(HID_EVT_TIMER, 0);
+}
+
+//Restart the single timer, used as the ack timeout or the release time depending on state
+static void HIDSender_armTimer(int ms)
+{
+    deadline_us = esp_timer_get_time() + ms * 1000LL;
+    esp_timer_stop(hid_timer);
+    esp_timer_start_once(hid_timer, ms * 1000ULL);
+}
+
+static void HIDSender_count(uint32_t* counter)
+{
+    taskENTER_CRITICAL(&stats_lock);
+    (*counter)++;
+    taskEXIT_CRITICAL(&stats_lock);
+}
+
+static bool HIDSender_isVolumeKey(const HID_action_t* action)
+{
+    return action->kind == HID_ACTION_CONSUMER
+        && (action->usage == HID_USAGE_VOLUME_UP || action->usage == HID_USAGE_VOLUME_DOWN);
+}
+
+//Build the report for an action, a release is the same report with nothing down
+static int HIDSender_encode(const HID_action_t* action, bool press, uint8_t* id, uint8_t* report)
+{
+    switch (action->kind) {
+    case HID_ACTION_KEY:
+        memset(report, 0, HID_KEYBOARD_REPORT_SIZE);
+        if (press) {
+            report[0] = action->modifiers;
+            report[2] = action->usage;
+        }
+        *id = HID_REPORT_ID_KEYBOARD;
+        return HID_KEYBOARD_REPORT_SIZE;
+    case HID_ACTION_VOLUME:
+        report[0] = action->usage;
+        *id = HID_REPORT_ID_VOLUME;
+        return HID_VOLUME_REPORT_SIZE;
+    default:
+        memset(report, 0, HID_CONSUMER_REPORT_SIZE);
+        if (press) {
+            report[0] = action->usage & 0xFF;
+            report[1] = action->usage >> 8;
+        }
+        *id = HID_REPORT_ID_CONSUMER;
+        return HID_CONSUMER_REPORT_SIZE;
+    }
+}
+
+static esp_err_t HIDSender_transmit(uint8_t id, uint8_t* report, int len)
+{
+    if (protocol_mode != HID_PROTOCOL_REPORT) {
+        ESP_LOGE(TAG, "invalid protocol mode");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    POWER_requestWake(POWER_SRC_BT);
+    esp_err_t ret = transport->send(id, report, len);
+    if (ret == ESP_OK) {
+        HIDSender_count(&stats.reports_sent);
+    }
+    return ret;
+}
+
+static esp_err_t HIDSender_sendReport(const HID_action_t* action, bool press)
+{
+    uint8_t report[HID_KEYBOARD_REPORT_SIZE];
+    uint8_t id;
+
+    const int len = HIDSender_encode(action, press, &id, report);
+    return HIDSender_transmit(id, report, len);
+}
+
+//Two consumer taps can share the report's two usage slots, the same usage twice would be one key
+static bool HIDSender_packs(const HID_action_t* a, const HID_action_t* b)
+{
+    return a->kind == HID_ACTION_CONSUMER && b->kind == HID_ACTION_CONSUMER && a->usage != b->usage;
+}
+
+//Press two consumer usages in one report, one release (all slots empty) lets go of both
+static esp_err_t HIDSender_sendPacked(const HID_action_t* a, const HID_action_t* b)
+{
+    uint8_t report[HID_CONSUMER_REPORT_SIZE] = {a->usage & 0xFF, a->usage >> 8, b->usage & 0xFF, b->usage >> 8};
+
+    esp_err_t ret = HIDSender_transmit(HID_REPORT_ID_CONSUMER, report, HID_CONSUMER_REPORT_SIZE);
+    if (ret == ESP_OK) {
+        HIDSender_count(&stats.packed);
+    }
+    return ret;
+}
+
+static void HIDSender_idle(void)
+{
+    if (state != HID_STATE_IDLE) {
+        const int64_t busy = esp_timer_get_time() - busy_since_us;
+        taskENTER_CRITICAL(&stats_lock);
+        stats.busy_us += busy;
+        taskEXIT_CRITICAL(&stats_lock);
+    }
+    state = HID_STATE_IDLE;
+}
+
+static HID_sender_evt_t HIDSender_popPending(void)
+{
+    HID_sender_evt_t press = pending[pending_head];
+    pending_head = (pending_head + 1) % HID_SENDER_PENDING;
+    pending_count--;
+    return press;
+}
+
+static void HIDSender_startPair(const HID_sender_evt_t* press)
+{
+    cur = *press;
+    hold_ms = HID_SENDER_HOLD_MS;
+
+    if (HIDSender_sendReport(&cur.action, true) != ESP_OK) {
+        HIDSender_count(&stats.send_errors);
+        return;
+    }
+
+    HIDSender_count(&stats.pairs_sent);
+    if (cur.action.kind == HID_ACTION_VOLUME) {
+        //nothing to release, done once confirmed
+        HIDSender_count(&stats.actions_sent);
+        state = HID_STATE_RELEASE_SENT;
+    } else {
+        state = HID_STATE_PRESS_SENT;
+    }
+    HIDSender_armTimer(HID_SENDER_ACK_TIMEOUT_MS);
+}
+
+//Send the release of a press carrying actions, they count as sent once it is out. A refused
+//release is kept for another try until HID_SENDER_RELEASE_TRIES, returns true if it went out
+static bool HIDSender_sendRelease(const HID_action_t* action, int actions)
+{
+    if (HIDSender_sendReport(action, false) == ESP_OK) {
+        release_pending = false;
+        release_tries = 0;
+        taskENTER_CRITICAL(&stats_lock);
+        stats.actions_sent += actions;
+        taskEXIT_CRITICAL(&stats_lock);
+        return true;
+    }
+
+    HIDSender_count(&stats.send_errors);
+    if (++release_tries < HID_SENDER_RELEASE_TRIES) {
+        release_action = *action;
+        release_actions = actions;
+        release_pending = true;
+    } else {
+        ESP_LOGE(TAG, "release of usage 0x%04x refused %d times, giving up", action->usage, release_tries);
+        release_pending = false;
+        release_tries = 0;
+    }
+    return false;
+}
+
+static void HIDSender_release(void)
+{
+    if (!HIDSender_sendRelease(&cur.action, 1)) {
+        if (release_pending) {
+            //key is still down, stay holding and try again shortly
+            HIDSender_armTimer(HID_SENDER_ACK_TIMEOUT_MS);
+        } else {
+            HIDSender_idle();
+        }
+        return;
+    }
+
+    state = HID_STATE_RELEASE_SENT;
+    HIDSender_armTimer(HID_SENDER_ACK_TIMEOUT_MS);
+}
+
+//Send batch taps until the window is full, the batch ends once everything is confirmed
+static void HIDSender_fillBatch(void)
+{
+    bool sent = false;
+
+    //a refused release goes out before any new press
+    if (release_pending && in_flight < HID_SENDER_WINDOW && HIDSender_sendRelease(&release_action, release_actions)) {
+        in_flight++;
+        sent = true;
+    }
+
+    while (!release_pending && batch_left > 0 && in_flight + 2 <= HID_SENDER_WINDOW) {
+        const HID_sender_evt_t tap = HIDSender_popPending();
+        esp_err_t ret;
+        int actions = 1;
+        batch_left--;
+
+        if (batch_left > 0 && HIDSender_packs(&tap.action, &pending[pending_head].action)) {
+            const HID_sender_evt_t second = HIDSender_popPending();
+            batch_left--;
+            actions = 2;
+            ret = HIDSender_sendPacked(&tap.action, &second.action);
+        } else {
+            ret = HIDSender_sendReport(&tap.action, true);
+        }
+        if (ret != ESP_OK) {
+            HIDSender_count(&stats.send_errors);
+            continue;
+        }
+        in_flight++;
+        sent = true;
+
+        if (tap.action.kind == HID_ACTION_VOLUME) {
+            //nothing to release
+            HIDSender_count(&stats.actions_sent);
+        } else if (HIDSender_sendRelease(&tap.action, actions)) {
+            in_flight++;
+        }
+    }
+
+    if (in_flight == 0 && batch_left == 0 && !release_pending) {
+        esp_timer_stop(hid_timer);
+        HIDSender_idle();
+    } else if (sent || release_pending) {
+        //a refused release is retried on the next confirmation or when this expires
+        HIDSender_armTimer(HID_SENDER_ACK_TIMEOUT_MS);
+    }
+}
+
+//Start queued actions until something is in flight
+static void HIDSender_next(void)
+{
+    while (state == HID_STATE_IDLE && pending_count > 0) {
+        busy_since_us = esp_timer_get_time();
+        if (pending_count > 1) {
+            HIDSender_count(&stats.batches);
+            batch_left = pending_count;
+            in_flight = 0;
+            state = HID_STATE_BATCH;
+            HIDSender_fillBatch();
+        } else {
+            const HID_sender_evt_t press = HIDSender_popPending();
+            HIDSender_startPair(&press);
+        }
+    }
+}
+
+static void HIDSender_onPress(const HID_sender_evt_t* evt)
+{
+    if (!connected) {
+        HIDSender_count(&stats.dropped);
+        return;
+    }
+
+    //fold repeated volume presses into the key that is already down
+    if (HIDSender_isVolumeKey(&evt->action) && evt->action.usage == cur.action.usage
+        && (state == HID_STATE_PRESS_SENT || state == HID_STATE_HOLDING)) {
+        HIDSender_count(&stats.coalesced);
+        hold_ms = HID_SENDER_REPEAT_MS;
+        if (state == HID_STATE_HOLDING) {
+            HIDSender_armTimer(hold_ms);
+        }
+        return;
+    }
+
+    if (pending_count == HID_SENDER_PENDING) {
+        ESP_LOGW(TAG, "pending actions full, dropping 0x%04x", evt->action.usage);
+        HIDSender_count(&stats.dropped);
+        return;
+    }
+    pending[(pending_head + pending_count) % HID_SENDER_PENDING] = *evt;
+    pending_count++;
+}
+
+//Report confirmed (or timed out), move the pair or batch along
+static void HIDSender_onSent(bool success, bool timed_out)
+{
+    if (timed_out) {
+        HIDSender_count(&stats.ack_timeouts);
+    } else if (!success) {
+        HIDSender_count(&stats.send_errors);
+    }
+
+    if (state == HID_STATE_PRESS_SENT) {
+        if (!timed_out) {
+            const int64_t latency = esp_timer_get_time() - cur.time_us;
+            taskENTER_CRITICAL(&stats_lock);
+            stats.latency_sum_us += latency;
+            if (latency > stats.latency_max_us) {
+                stats.latency_max_us = latency;
+            }
+            taskEXIT_CRITICAL(&stats_lock);
+        }
+        //release even if the press failed so a key is never left down
+        state = HID_STATE_HOLDING;
+        HIDSender_armTimer(hold_ms);
+    } else if (state == HID_STATE_RELEASE_SENT) {
+        esp_timer_stop(hid_timer);
+        HIDSender_idle();
+    } else if (state == HID_STATE_BATCH) {
+        if (in_flight > 0) {
+            in_flight--;
+        }
+        HIDSender_fillBatch();
+    }
+}
+
+static void HIDSender_onTimer(void)
+{
+    //stale expiry from a timer that has since been re-armed
+    if (esp_timer_get_time() < deadline_us) {
+        return;
+    }
+
+    switch (state) {
+    case HID_STATE_HOLDING:
+        HIDSender_release();
+        break;
+    case HID_STATE_PRESS_SENT:
+    case HID_STATE_RELEASE_SENT:
+        ESP_LOGW(TAG, "no confirmation for usage 0x%04x", cur.action.usage);
+        HIDSender_onSent(false, true);
+        break;
+    case HID_STATE_BATCH:
+        //nothing in flight when the timer only paced a release retry
+        if (in_flight > 0) {
+            ESP_LOGW(TAG, "%d batch reports never confirmed", in_flight);
+            taskENTER_CRITICAL(&stats_lock);
+            stats.ack_timeouts += in_flight;
+            taskEXIT_CRITICAL(&stats_lock);
+            in_flight = 0;
+        }
+        HIDSender_fillBatch();
+        break;
+    default:
+        break;
+    }
+}
+
+static void HIDSender_onLink(bool up)
+{
+    connected = up;
+    if (!up) {
+        esp_timer_stop(hid_timer);
+        taskENTER_CRITICAL(&stats_lock);
+        stats.dropped += pending_count;
+        taskEXIT_CRITICAL(&stats_lock);
+        pending_count = 0;
+        batch_left = 0;
+        in_flight = 0;
+        //the host lets go of every key when the link drops
+        release_pending = false;
+        release_tries = 0;
+        HIDSender_idle();
+    }
+}
+
+static void HIDSender_handle(const HID_sender_evt_t* evt)
+{
+    switch (evt->type) {
+    case HID_EVT_PRESS:
+        HIDSender_onPress(evt);
+        break;
+    case HID_EVT_SENT:
+        HIDSender_onSent(evt->value, false);
+        break;
+    case HID_EVT_TIMER:
+        HIDSender_onTimer();
+        break;
+    case HID_EVT_LINK:
+        HIDSender_onLink(evt->value);
+        break;
+    case HID_EVT_PROTOCOL:
+        protocol_mode = evt->value;
+        break;
+    default:
+        break;
+    }
+}
+
+static void HIDSender_task(void* arg)
+{
+    HID_sender_evt_t evt;
+    bool more;
+
+    for (;;) {
+        xQueueReceive(evt_queue, &evt, portMAX_DELAY);
+
+        //drain everything queued so far, waiting for the rest of a batch that is still being posted
+        do {
+            HIDSender_handle(&evt);
+            more = (evt.type == HID_EVT_PRESS && evt.value);
+        } while (xQueueReceive(evt_queue, &evt, more ? pdMS_TO_TICKS(HID_SENDER_ACK_TIMEOUT_MS) : 0) == pdTRUE);
+
+        HIDSender_next();
+    }
+}
+
+static bool HIDSender_valid(const HID_action_t* action)
+{
+    switch (action->kind) {
+    case HID_ACTION_CONSUMER:
+        return action->usage <= HID_CONSUMER_USAGE_MAX;
+    case HID_ACTION_KEY:
+        return action->usage <= HID_KEY_USAGE_MAX;
+    case HID_ACTION_VOLUME:
+        return action->usage <= HID_VOLUME_MAX;
+    default:
+        return false;
+    }
+}
+
+static esp_err_t HIDSender_queue(const HID_action_t* action, bool more)
+{
+    HID_sender_evt_t evt = {.type = HID_EVT_PRESS, .value = more, .action = *action, .time_us = esp_timer_get_time()};
+    if (xQueueSend(evt_queue, &evt, 0) != pdTRUE) {
+        HIDSender_count(&stats.dropped);
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+esp_err_t HIDSender_init(const HID_transport_t* link)
+{
+    transport = link;
+    evt_queue = xQueueCreateStatic(HID_SENDER_QUEUE_DEPTH, sizeof(HID_sender_evt_t), evt_storage, &evt_queue_buf);
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = HIDSender_timerCallback,
+        .name = "hid_sender",
+    };
+    esp_err_t ret = esp_timer_create(&timer_args, &hid_timer);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "failed to create timer: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    memset(&stats, 0, sizeof(stats));
+    MEM_registerTask(xTaskCreateStatic(HIDSender_task, "hid_sender", HID_SENDER_TASK_STACK, NULL, HID_SENDER_TASK_PRIORITY,
+                                       sender_task_stack, &sender_task_buf));
+    return ESP_OK;
+}
+
+esp_err_t HIDSender_send(const HID_action_t* action)
+{
+    if (!HIDSender_valid(action)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return HIDSender_queue(action, false);
+}
+
+esp_err_t HIDSender_sendBatch(const HID_action_t* actions, int count)
+{
+    if (count <= 0 || count > HID_SENDER_QUEUE_DEPTH) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int i = 0; i < count; i++) {
+        if (!HIDSender_valid(&actions[i])) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    if (uxQueueSpacesAvailable(evt_queue) < count) {
+        HIDSender_count(&stats.dropped);
+        return ESP_ERR_NO_MEM;
+    }
+
+    for (int i = 0; i < count; i++) {
+        esp_err_t ret = HIDSender_queue(&actions[i], i < count - 1);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+    return ESP_OK;
+}
+
+void HIDSender_reportSent(bool success)
+{
+    HIDSender_post(HID_EVT_SENT, success);
+}
+
+void HIDSender_setConnected(bool is_connected)
+{
+    HIDSender_post(HID_EVT_LINK, is_connected);
+}
+
+void HIDSender_setProtocolMode(uint8_t mode)
+{
+    HIDSender_post(HID_EVT_PROTOCOL, mode);
+}
+
+void HIDSender_getStats(HID_sender_stats_t* out)
+{
+    taskENTER_CRITICAL(&stats_lock);
+    *out = stats;
+    taskEXIT_CRITICAL(&stats_lock);
+}
@@ -0,0 +1,174 @@
+/**
+ * @file hid_sender.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Non-blocking HID report pipeline
+ *
+ * Callers only queue actions (a consumer usage, a key or an absolute volume).
+ * A sender task turns a lone action into a press/release pair: the press is
+ * sent right away, the release is scheduled by a timer once the stack confirms
+ * the press (the transport calls HIDSender_reportSent), and the next pair starts once the
+ * release is confirmed. Repeated volume presses while a volume key is still
+ * held extend the hold instead of queueing new pairs, so the host sees one held
+ * key and auto-repeats it.
+ *
+ * Actions that are queued together (HIDSender_sendBatch, or several sends that
+ * land before the task runs) are sent as taps: press and release reports go
+ * out back to back, up to HID_SENDER_WINDOW reports in flight, without holds.
+ * Two consumer taps in a row with different usages share a report: both go
+ * down in the consumer report's two usage slots and come up with one release,
+ * so the host sees them pressed together (in queue order within the report)
+ * and the pair costs two reports instead of four.
+ *
+ * A release the stack refuses is sent again (after the next confirmation or
+ * HID_SENDER_ACK_TIMEOUT_MS) before anything else goes out, so a key is not
+ * left down on the host.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "hid_transport.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define HID_SENDER_QUEUE_DEPTH    16
+#define HID_SENDER_PENDING        16    //actions held back while a pair or batch is in flight
+#define HID_SENDER_WINDOW         8     //unconfirmed reports allowed while sending a batch
+#define HID_SENDER_HOLD_MS        20    //press to release time for a single press
+#define HID_SENDER_REPEAT_MS      250   //volume hold extension per repeated press
+#define HID_SENDER_ACK_TIMEOUT_MS 100   //give up waiting for HIDSender_reportSent
+#define HID_SENDER_RELEASE_TRIES  3     //sends of a release the stack refuses before the key is given up on
+
+/* Report IDs of the composite descriptor in hid_transport.c. */
+#define HID_REPORT_ID_CONSUMER    1     //two 16 bit consumer usages
+#define HID_REPORT_ID_KEYBOARD    2     //modifiers, reserved, six key usages
+#define HID_REPORT_ID_VOLUME      3     //absolute volume 0 - 100
+#define HID_CONSUMER_REPORT_SIZE  4
+#define HID_KEYBOARD_REPORT_SIZE  8
+#define HID_VOLUME_REPORT_SIZE    1
+
+#define HID_CONSUMER_USAGE_MAX    0x3FF
+#define HID_KEY_USAGE_MAX         0x65
+#define HID_VOLUME_MAX            100
+
+/* Consumer page usages (HID usage tables, page 0x0C). */
+#define HID_USAGE_NEXT_TRACK      0x00B5
+#define HID_USAGE_PREV_TRACK      0x00B6
+#define HID_USAGE_STOP            0x00B7
+#define HID_USAGE_PLAY_PAUSE      0x00CD
+#define HID_USAGE_MUTE            0x00E2
+#define HID_USAGE_VOLUME_UP       0x00E9
+#define HID_USAGE_VOLUME_DOWN     0x00EA
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+typedef enum {
+    HID_ACTION_CONSUMER = 0,    //usage: consumer usage, press and release
+    HID_ACTION_KEY,             //usage: keyboard usage, press and release with modifiers
+    HID_ACTION_VOLUME,          //usage: absolute volume, a single report
+} HID_action_kind_t;
+
+/* Something to send to the host. */
+typedef struct {
+    uint8_t kind;               //HID_action_kind_t
+    uint8_t modifiers;          //keyboard modifier bits, HID_ACTION_KEY only
+    uint16_t usage;
+} HID_action_t;
+
+/* Delivery and latency counters since HIDSender_init. */
+typedef struct {
+    uint32_t actions_sent;      //actions whose reports were all handed to the stack
+    uint32_t reports_sent;
+    uint32_t batches;           //groups of actions sent back to back
+    uint32_t packed;            //batch press reports carrying two consumer usages
+    uint32_t pairs_sent;        //press/release pairs started
+    uint32_t coalesced;         //volume presses folded into a held key
+    uint32_t dropped;           //presses lost to a full queue or no connection
+    uint32_t send_errors;       //failed sends or negative confirmations
+    uint32_t ack_timeouts;      //reports never confirmed
+    int64_t latency_max_us;     //button to confirmed press
+    int64_t latency_sum_us;
+    int64_t busy_us;            //time with reports in flight, actions_sent / busy_us is the throughput
+} HID_sender_stats_t;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+/** @brief Create the report queue, release timer and sender task
+ *
+ *  @param transport Link the reports are sent over, must outlive the sender
+ *  @return ESP_OK on success.
+ */
+esp_err_t HIDSender_init(const HID_transport_t* transport);
+
+/** @brief Queue an action
+ *
+ *  Never blocks, safe to call from any task.
+ *
+ *  @param action Action to send
+ *  @return ESP_OK, ESP_ERR_INVALID_ARG for a usage the descriptor cannot carry,
+ *          or ESP_ERR_NO_MEM when the queue is full.
+ */
+esp_err_t HIDSender_send(const HID_action_t* action);
+
+/** @brief Queue several actions to be sent back to back
+ *
+ *  The actions reach the sender task together so they go out as taps in
+ *  one burst instead of one press/release round trip each. Never blocks.
+ *
+ *  @param actions Actions in the order the host should see them
+ *  @param count Number of actions, at most HID_SENDER_QUEUE_DEPTH
+ *  @return ESP_OK, ESP_ERR_INVALID_ARG for a bad action or count, or
+ *          ESP_ERR_NO_MEM when the queue has no room for all of them.
+ */
+esp_err_t HIDSender_sendBatch(const HID_action_t* actions, int count);
+
+/** @brief Report the result of a send, called by the transport once the report is out
+ *
+ *  @param success true if the stack delivered the report
+ *  @return Void.
+ */
+void HIDSender_reportSent(bool success);
+
+/** @brief Update the link state, call from the open/close events
+ *
+ *  Disconnecting drops every queued press.
+ *
+ *  @param connected true once a host is connected
+ *  @return Void.
+ */
+void HIDSender_setConnected(bool connected);
+
+/** @brief Update the protocol mode, called by the transport when the host sets it
+ *
+ *  @param protocol_mode HID_PROTOCOL_REPORT or HID_PROTOCOL_BOOT
+ *  @return Void.
+ */
+void HIDSender_setProtocolMode(uint8_t protocol_mode);
+
+/** @brief Get the delivery and latency counters
+ *
+ *  @param stats Filled with the current counters
+ *  @return Void.
+ */
+void HIDSender_getStats(HID_sender_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,86 @@
+/**
+ * @file hid_transport.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief HID transports and the report map they share
+ *
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include "sdkconfig.h"
+#include "hid_transport.h"
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+// Composite HID report descriptor, report IDs match HID_REPORT_ID_ in hid_sender.h:
+// 1: two 16 bit consumer usages (any usage up to 0x3FF, e.g. media keys)
+// 2: boot style keyboard, modifiers, reserved byte and six key usages
+// 3: absolute volume (0 - 100)
+const uint8_t hid_report_map[] = {
+    0x05, 0x0c,                    // USAGE_PAGE (Consumer Devices)
+	0x09, 0x01,                    // USAGE (Consumer Control)
+	0xa1, 0x01,                    // COLLECTION (Application)
+	0x85, 0x01,                    //   REPORT_ID (1)
+	0x15, 0x00,                    //   LOGICAL_MINIMUM (0)
+	0x26, 0xff, 0x03,              //   LOGICAL_MAXIMUM (1023)
+	0x19, 0x00,                    //   USAGE_MINIMUM (Unassigned)
+	0x2a, 0xff, 0x03,              //   USAGE_MAXIMUM (1023)
+	0x75, 0x10,                    //   REPORT_SIZE (16)
+	0x95, 0x02,                    //   REPORT_COUNT (2)
+	0x81, 0x00,                    //   INPUT (Data,Ary,Abs)  - usages currently down
+	0xc0,                          // END_COLLECTION
+
+	0x05, 0x01,                    // USAGE_PAGE (Generic Desktop)
+	0x09, 0x06,                    // USAGE (Keyboard)
+	0xa1, 0x01,                    // COLLECTION (Application)
+	0x85, 0x02,                    //   REPORT_ID (2)
+	0x05, 0x07,                    //   USAGE_PAGE (Keyboard)
+	0x19, 0xe0,                    //   USAGE_MINIMUM (Left Control)
+	0x29, 0xe7,                    //   USAGE_MAXIMUM (Right GUI)
+	0x15, 0x00,                    //   LOGICAL_MINIMUM (0)
+	0x25, 0x01,                    //   LOGICAL_MAXIMUM (1)
+	0x75, 0x01,                    //   REPORT_SIZE (1)
+	0x95, 0x08,                    //   REPORT_COUNT (8)
+	0x81, 0x02,                    //   INPUT (Data,Var,Abs)  - modifier bits
+	0x75, 0x08,                    //   REPORT_SIZE (8)
+	0x95, 0x01,                    //   REPORT_COUNT (1)
+	0x81, 0x01,                    //   INPUT (Cnst,Ary,Abs)  - reserved byte
+	0x19, 0x00,                    //   USAGE_MINIMUM (Reserved)
+	0x29, 0x65,                    //   USAGE_MAXIMUM (Keyboard Application)
+	0x25, 0x65,                    //   LOGICAL_MAXIMUM (101)
+	0x95, 0x06,                    //   REPORT_COUNT (6)
+	0x81, 0x00,                    //   INPUT (Data,Ary,Abs)  - keys currently down
+	0xc0,                          // END_COLLECTION
+
+	0x05, 0x0c,                    // USAGE_PAGE (Consumer Devices)
+	0x09, 0x01,                    // USAGE (Consumer Control)
+	0xa1, 0x01,                    // COLLECTION (Application)
+	0x85, 0x03,                    //   REPORT_ID (3)
+	0x09, 0xe0,                    //   USAGE (Volume)
+	0x15, 0x00,                    //   LOGICAL_MINIMUM (0)
+	0x25, 0x64,                    //   LOGICAL_MAXIMUM (100)
+	0x75, 0x08,                    //   REPORT_SIZE (8)
+	0x95, 0x01,                    //   REPORT_COUNT (1)
+	0x81, 0x02,                    //   INPUT (Data,Var,Abs)
+	0xc0                           // END_COLLECTION
+};
+
+const int hid_report_map_len = sizeof(hid_report_map);
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+const HID_transport_t* HIDTransport_default(void)
+{
+#if CONFIG_BT_CLASSIC_ENABLED && !CONFIG_BTDM_CTRL_MODE_BLE_ONLY
+    return &hid_classic_transport;
+#else
+    return &hid_ble_transport;
+#endif
+}
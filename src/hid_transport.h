@@ -0,0 +1,78 @@
+/**
+ * @file hid_transport.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief HID transports and the report map they share
+ *
+ * The sender builds reports and hands them to a transport: Classic BT HID
+ * (hid_classic.c) on the ESP32 board, BLE HID-over-GATT (hid_ble.c) on the
+ * BLE only ESP32-C3. Both register the same report map, so report IDs and
+ * layouts never differ between links. A transport confirms each report later
+ * through HIDSender_reportSent and reports link and protocol changes through
+ * HIDSender_setConnected / HIDSender_setProtocolMode, so a fake transport is
+ * enough to drive the sender on a host.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include <inttypes.h>
+#include "esp_err.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define HID_DEVICE_NAME           "HID Media Controller"
+
+/* Protocol modes as in HID Set_Protocol, transports map their own enums to these. */
+#define HID_PROTOCOL_BOOT         0
+#define HID_PROTOCOL_REPORT       1
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+/* Link that carries reports to the host. */
+typedef struct {
+    const char* name;
+    esp_err_t (*init)(const uint8_t* report_map, int report_map_len);    //brings up the stack and starts connecting
+    esp_err_t (*send)(uint8_t report_id, uint8_t* data, uint16_t len);   //interrupt/input report without the ID byte
+    void (*activity)(void);                                              //user activity, NULL if the link does not care
+} HID_transport_t;
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+/* Composite report map, IDs match HID_REPORT_ID_ in hid_sender.h. */
+extern const uint8_t hid_report_map[];
+extern const int hid_report_map_len;
+
+/* Backends, only those the Bluetooth config enables are built. */
+extern const HID_transport_t hid_classic_transport;
+extern const HID_transport_t hid_ble_transport;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+/** @brief Transport for this build
+ *
+ *  Classic HID when the controller runs BR/EDR, HID-over-GATT when it only
+ *  runs BLE (ESP32-C3, or an ESP32 configured BLE only).
+ *
+ *  @return Transport.
+ */
+const HID_transport_t* HIDTransport_default(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -34,11 +34,27 @@
 
 //Display related
 #include "display_main.h"
-#include "display_templates.h"
+#include "display_bus.h"
+#include "display_port.h"
+#include "display_vsync.h"
+#include "watch_face.h"
 
 //BT related
 #include "hid_device.h"
 
+//Timekeeping
+#include "watch_clock.h"
+
+//Power
+#include "power_mgmt.h"
+#include "battery.h"
+
+//Memory
+#include "mem_stats.h"
+
+//App core
+#include "app_bus.h"
+
 /************************************************
  *  GLOBALS
  ***********************************************/
@@ -49,70 +65,12 @@ static spi_device_handle_t spi;
  *  FUNCTIONS
  ***********************************************/
 
-void LCD_drawMediaIcon(uint8_t icon_index)
+//Minute tick from the clock, runs in the esp_timer task
+static void vClockTick(const struct tm* now, void* arg)
 {
-    LCD_setDrawingWindow(
-        spi,
-        ICON_DISPLAY_X_OFFSET, //x pos
-        ICON_DISPLAY_Y_OFFSET, //y pos
-        ICON_WIDTH - 1,        //width
-        ICON_HEIGHT - 1        //height
-    );
-    LCD_sendFrame(
-        spi,
-        &media_icons[icon_index],
-        ICON_SIZE,
-        ICON_CHUNKS
-    );
-};
-
-void vTaskUpdateDisplayTime( void * pvParameters )
-{
-	//TODO: atm static initialized in future can do with pushbuttons
-	static int hour = 5;
-	static int mins = 40;
-
-	//have a 1 min delay then imcrement mins,
-	for ( ;; )
-	{
-		//populate array of values
-		int time[5] = {hour / 10, hour % 10, 0, mins / 10, mins % 10}; // [H,H, (blank), M,M]
-
-		for (int i = 0; i < 5; i++)
-		{
-			LCD_setDrawingWindow(
-				spi,
-				TIME_DISPLAY_X_OFFSET + ((i < 3) ? (i * NUM_WIDTH) : ((i-1) * NUM_WIDTH) + SC_WIDTH), //x pos
-				TIME_DISPLAY_Y_OFFSET,                                                                //y pos
-				(i == 2) ? SC_WIDTH - 1 : NUM_WIDTH - 1,                                              //width
-				NUM_HEIGHT - 1                                                                        //height
-			);
-			LCD_sendFrame(
-				spi,
-				(i == 2) ? &semi_colon : &display_numbers[time[i]],
-				(i == 2) ? SC_SIZE : NUM_SIZE,
-				NUM_CHUNKS
-			);
-		}
-		vTaskDelay(60000 / portTICK_PERIOD_MS);
-		if (mins == 59) 
-		{
-			mins = 0;
-			if (hour == 23)
-			{
-				hour = 0;
-			}
-			else 
-			{
-				hour++;
-			}
-		}
-		else 
-		{
-			mins++;
-		}
-	}
-};
+	const BUS_msg_t msg = {.type = BUS_MSG_CLOCK_TICK};
+	BUS_post(&msg);
+}
 
 void app_main(void)
 {
@@ -121,40 +79,30 @@ void app_main(void)
 	**********************************/
 	esp_err_t ret;
 
-	spi_bus_config_t bus_config = {
-		.mosi_io_num = PIN_SDA,
-		.miso_io_num = -1,
-		.sclk_io_num = PIN_SCK,
-		.max_transfer_sz = MAX_TRANSFER_SIZE + 8
-	};
-	//Init bus
-	ret = spi_bus_initialize(HOST_DEVICE, &bus_config, SPI_DMA_CH_AUTO);
+	//everything below posts to the bus or subscribes to it
+	ESP_ERROR_CHECK(BUS_init());
+
+	ret = LCD_busInit(&spi, LCD_BUS_DEFAULT_HZ);
 	ESP_ERROR_CHECK(ret);
 
-	spi_device_interface_config_t dev_config = {
-		.mode = 0,   //SPI mode 0
-		.clock_speed_hz = 10000000,  //10MHz clock (max 15)
-		.spics_io_num = PIN_CHIP_SEL, //CS pin
-		.queue_size = 7, //TODO: stable queue size?
-	};
+	LCD_init(spi);
+#if LCD_BUS_CALIBRATE
+	//before anything else holds the handle, the calibration replaces it (keeps the clock on failure)
+	ESP_ERROR_CHECK_WITHOUT_ABORT(LCD_busCalibrate(&spi, LCD_PORT_VERIFY, NULL));
+#endif
+	ESP_ERROR_CHECK(LCD_vsyncInit(spi, PIN_TE));
+
+	//clears the screen, the face's handlers are the only ones drawing from here on
+	ESP_ERROR_CHECK(FACE_init(spi));
 
-	//Attach device to bus
-	ret = spi_bus_add_device(HOST_DEVICE, &dev_config, &spi);
-    ESP_ERROR_CHECK(ret);
+	//the gauge stays hidden until the first reading, for good on boards without battery sense
+	ESP_ERROR_CHECK_WITHOUT_ABORT(BATTERY_init());
 
-	LCD_init(spi);
-	
-	uint8_t* frame_buffer = malloc(FRAME_SIZE);
-	//populate buffer
-	for (int i = 0; i < FRAME_SIZE; i++)
-	{
-		//frame_buffer[i] = 128 + 127 * sin((3.14159 * (i) /  64.0) + 1);
-		frame_buffer[i] = 125;
-	}
-	//make white
-	LCD_setDrawingWindow(spi,X_OFFSET,Y_OFFSET,WIDTH - 1, HEIGHT - 1);
-	LCD_sendFrame(spi, frame_buffer, FRAME_SIZE, 128);
-	free(frame_buffer);
+	/******************************
+		Power Management
+	*******************************/
+
+	ESP_ERROR_CHECK(POWER_init());
 
 	/******************************
 		BL Initialization
@@ -162,21 +110,16 @@ void app_main(void)
 
 	HIDDevice_BT_init();
 
-	/****************
-		Task Creation
-	*****************/
+	/******************************
+		Clock Initialization
+	*******************************/
 
-	BaseType_t xRet;
-	// may not need handle tbd...
-	TaskHandle_t xHandle = NULL;
+	//TODO: atm static initialized in future can do with pushbuttons or sntp
+	ESP_ERROR_CHECK(CLOCK_init(5, 40));
 
-	xRet = xTaskCreate(
-		vTaskUpdateDisplayTime,
-		"UPDATE_DISPLAY_TIME",
-		configMINIMAL_STACK_SIZE,
-		NULL,
-		1,
-		NULL
-	);
+	//first draw, then once a minute
+	ESP_ERROR_CHECK(CLOCK_subscribe(vClockTick, NULL));
+	vClockTick(NULL, NULL);
 
+	MEM_report("boot");
 }
\ No newline at end of file
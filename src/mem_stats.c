@@ -0,0 +1,81 @@
+/**
+ * @file mem_stats.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Heap high-water marks and task stack headroom
+ *
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "mem_stats.h"
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static const char* TAG = "mem_stats";
+
+static TaskHandle_t tasks[MEM_MAX_TASKS];
+static int task_count = 0;
+static portMUX_TYPE mem_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static size_t baseline = 0;
+static uint32_t reports = 0;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+static void MEM_readHeap(MEM_heap_t* heap, uint32_t caps)
+{
+	heap->free = heap_caps_get_free_size(caps);
+	heap->min_free = heap_caps_get_minimum_free_size(caps);
+	heap->largest = heap_caps_get_largest_free_block(caps);
+}
+
+void MEM_registerTask(TaskHandle_t task)
+{
+	portENTER_CRITICAL(&mem_lock);
+	if (task != NULL && task_count < MEM_MAX_TASKS)
+	{
+		tasks[task_count++] = task;
+	}
+	portEXIT_CRITICAL(&mem_lock);
+}
+
+void MEM_getStats(MEM_stats_t* out)
+{
+	MEM_readHeap(&out->internal, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+	MEM_readHeap(&out->dma, MALLOC_CAP_DMA);
+	out->drift = (baseline == 0) ? 0 : (int32_t)out->internal.free - (int32_t)baseline;
+	out->reports = reports;
+}
+
+void MEM_report(const char* where)
+{
+	MEM_stats_t s;
+	MEM_getStats(&s);
+
+	if (baseline == 0)
+	{
+		baseline = s.internal.free;
+	}
+	reports++;
+
+	ESP_LOGI(TAG, "%s: internal free %zu (min %zu, largest %zu, drift %"PRId32"), dma free %zu (min %zu, largest %zu)",
+		where, s.internal.free, s.internal.min_free, s.internal.largest, s.drift,
+		s.dma.free, s.dma.min_free, s.dma.largest);
+
+	for (int i = 0; i < task_count; i++)
+	{
+		//bytes on this port, StackType_t is a byte
+		ESP_LOGI(TAG, "  %s: %u bytes of stack never used",
+			pcTaskGetName(tasks[i]), (unsigned)uxTaskGetStackHighWaterMark(tasks[i]));
+	}
+}
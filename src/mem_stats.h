@@ -0,0 +1,82 @@
+/**
+ * @file mem_stats.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Heap high-water marks and task stack headroom
+ *
+ * Tasks, queues, semaphores and display buffers are all allocated statically,
+ * so after boot the heap should only move with the Bluetooth stack. Reports
+ * are logged at boot and on every connect/disconnect, a free size that keeps
+ * drifting away from the boot baseline across cycles is a leak.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include <stddef.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define MEM_MAX_TASKS  8
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+/* Snapshot of one heap capability. */
+typedef struct {
+	size_t free;
+	size_t min_free;  //high-water mark since boot
+	size_t largest;   //largest free block, fragmentation shows up here first
+} MEM_heap_t;
+
+/* Heap snapshot. */
+typedef struct {
+	MEM_heap_t internal;
+	MEM_heap_t dma;
+	int32_t drift;    //internal free bytes compared to the first report
+	uint32_t reports;
+} MEM_stats_t;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+/** @brief Add a task to the stack headroom report
+ *
+ *  @param task Task handle, tasks past MEM_MAX_TASKS are ignored
+ *  @return Void.
+ */
+void MEM_registerTask(TaskHandle_t task);
+
+/** @brief Get the current heap statistics
+ *
+ *  @param out Filled with the current statistics
+ *  @return Void.
+ */
+void MEM_getStats(MEM_stats_t* out);
+
+/** @brief Log the heap and the stack headroom of the registered tasks
+ *
+ *  The first call sets the baseline the drift is measured from.
+ *
+ *  @param where Label for the log line (e.g. "boot", "bt open")
+ *  @return Void.
+ */
+void MEM_report(const char* where);
+
+#ifdef __cplusplus
+}
+#endif
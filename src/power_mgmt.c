@@ -0,0 +1,250 @@
+/**
+ * @file power_mgmt.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Wake window scheduler, automatic light sleep and panel power modes
+ *
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <string.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_pm.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "driver/gpio.h"
+#include "display_fb.h"
+#include "app_bus.h"
+#include "power_mgmt.h"
+#include "mem_stats.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define POWER_TASK_STACK     2048
+#define POWER_TASK_PRIORITY  2
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static const char* TAG = "power_mgmt";
+
+static esp_pm_lock_handle_t awake_lock;
+static esp_timer_handle_t window_timer;
+static TaskHandle_t power_task = NULL;
+static SemaphoreHandle_t power_mutex = NULL;
+static StaticTask_t power_task_buf;
+static StackType_t power_task_stack[POWER_TASK_STACK];
+static StaticSemaphore_t power_mutex_buf;
+
+static bool window_open = false;
+static int64_t window_end_us = 0;
+static int64_t last_input_us = 0;
+static LCD_panel_mode_t panel_mode = LCD_PANEL_NORMAL;
+
+//accounting
+static int64_t last_account_us = 0;
+static POWER_stats_t stats;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+//Charge the time since the last call to the current modes. Caller must hold power_mutex
+static void POWER_account(void)
+{
+	const int64_t now = esp_timer_get_time();
+	const int64_t elapsed = now - last_account_us;
+
+	if (window_open)
+	{
+		stats.awake_us += elapsed;
+	}
+	else
+	{
+		stats.sleep_us += elapsed;
+	}
+	stats.panel_us[panel_mode] += elapsed;
+	last_account_us = now;
+}
+
+//Caller must hold power_mutex. The dispatcher owns the panel, the mode change is posted to it
+//so callers (button, HID sender) never wait on the frame buffer or the SPI bus
+static void POWER_setPanel(LCD_panel_mode_t mode)
+{
+	if (mode != panel_mode)
+	{
+		const BUS_msg_t msg = {.type = BUS_MSG_PANEL, .data.panel = mode};
+		if (BUS_post(&msg) != ESP_OK)
+		{
+			//bus full, the mode is left as it was so the next request posts it again
+			return;
+		}
+		POWER_account();
+		panel_mode = mode;
+	}
+}
+
+//Dispatcher handler, applies a posted panel mode between frames
+static void POWER_panelHandler(const BUS_msg_t* msg, void* arg)
+{
+	FB_setPanelMode(msg->data.panel);
+}
+
+static void POWER_windowTimerCallback(void* arg)
+{
+	xTaskNotifyGive(power_task);
+}
+
+//Closes wake windows, done in a task so the esp_timer task never waits on power_mutex
+static void POWER_task(void* arg)
+{
+	for (;;)
+	{
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+		xSemaphoreTake(power_mutex, portMAX_DELAY);
+		const int64_t now = esp_timer_get_time();
+		if (window_open && now >= window_end_us)
+		{
+			//idle mode between windows, sleep mode once the user has gone away
+			POWER_setPanel((now - last_input_us >= POWER_DISPLAY_SLEEP_MS * 1000LL) ? LCD_PANEL_SLEEP : LCD_PANEL_IDLE);
+
+			POWER_account();
+			window_open = false;
+			esp_pm_lock_release(awake_lock);
+		}
+		xSemaphoreGive(power_mutex);
+	}
+}
+
+esp_err_t POWER_init(void)
+{
+	esp_err_t ret;
+
+	const esp_pm_config_t pm_config = {
+		.max_freq_mhz = POWER_MAX_FREQ_MHZ,
+		.min_freq_mhz = POWER_MIN_FREQ_MHZ,
+		.light_sleep_enable = true,
+	};
+	ret = esp_pm_configure(&pm_config);
+	if (ret != ESP_OK)
+	{
+		ESP_LOGE(TAG, "failed to configure pm: %s", esp_err_to_name(ret));
+		return ret;
+	}
+
+	ret = esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "wake_window", &awake_lock);
+	if (ret != ESP_OK)
+	{
+		return ret;
+	}
+
+	const esp_timer_create_args_t timer_args = {
+		.callback = POWER_windowTimerCallback,
+		.name = "wake_window",
+	};
+	ret = esp_timer_create(&timer_args, &window_timer);
+	if (ret != ESP_OK)
+	{
+		return ret;
+	}
+
+	ESP_ERROR_CHECK(esp_sleep_enable_gpio_wakeup());
+
+	ret = BUS_subscribe(BUS_MSG_PANEL, POWER_panelHandler, NULL);
+	if (ret != ESP_OK)
+	{
+		return ret;
+	}
+
+	power_mutex = xSemaphoreCreateMutexStatic(&power_mutex_buf);
+	power_task = xTaskCreateStatic(POWER_task, "power_mgmt", POWER_TASK_STACK, NULL, POWER_TASK_PRIORITY,
+		power_task_stack, &power_task_buf);
+	MEM_registerTask(power_task);
+
+	last_account_us = esp_timer_get_time();
+	last_input_us = last_account_us;
+	memset(&stats, 0, sizeof(stats));
+
+	return ESP_OK;
+}
+
+void POWER_enableGpioWakeup(int gpio_num)
+{
+	//buttons are active low, wakeup has to be level triggered
+	ESP_ERROR_CHECK(gpio_wakeup_enable(gpio_num, GPIO_INTR_LOW_LEVEL));
+}
+
+void POWER_requestWake(POWER_source_t src)
+{
+	xSemaphoreTake(power_mutex, portMAX_DELAY);
+	const int64_t now = esp_timer_get_time();
+
+	if (!window_open)
+	{
+		POWER_account();
+		esp_pm_lock_acquire(awake_lock);
+		window_open = true;
+	}
+	stats.wakes[src]++;
+
+	if (src == POWER_SRC_BUTTON)
+	{
+		last_input_us = now;
+		POWER_setPanel(LCD_PANEL_NORMAL);
+	}
+	else if (panel_mode == LCD_PANEL_IDLE)
+	{
+		//background work only restores color, a sleeping panel stays asleep
+		POWER_setPanel(LCD_PANEL_NORMAL);
+	}
+
+	//join the open window, push its end out
+	window_end_us = now + (POWER_WINDOW_MS * 1000LL);
+	esp_timer_stop(window_timer);
+	esp_timer_start_once(window_timer, POWER_WINDOW_MS * 1000ULL);
+	xSemaphoreGive(power_mutex);
+}
+
+void POWER_getStats(POWER_stats_t* out)
+{
+	xSemaphoreTake(power_mutex, portMAX_DELAY);
+	POWER_account();
+	*out = stats;
+	xSemaphoreGive(power_mutex);
+
+	const float total = (float)(out->awake_us + out->sleep_us);
+	if (total <= 0)
+	{
+		return;
+	}
+
+	out->cpu_avg_ma = (out->awake_us * POWER_CURRENT_CPU_ACTIVE + out->sleep_us * POWER_CURRENT_CPU_SLEEP) / total;
+	out->panel_avg_ma = (out->panel_us[LCD_PANEL_NORMAL] * POWER_CURRENT_PANEL_NORMAL
+		+ out->panel_us[LCD_PANEL_IDLE] * POWER_CURRENT_PANEL_IDLE
+		+ out->panel_us[LCD_PANEL_SLEEP] * POWER_CURRENT_PANEL_SLEEP) / total;
+	out->total_avg_ma = out->cpu_avg_ma + out->panel_avg_ma;
+}
+
+void POWER_logStats(void)
+{
+	POWER_stats_t s;
+	POWER_getStats(&s);
+
+	ESP_LOGI(TAG, "cpu: awake %lld ms, sleep allowed %lld ms, avg %.2f mA",
+		s.awake_us / 1000, s.sleep_us / 1000, s.cpu_avg_ma);
+	ESP_LOGI(TAG, "panel: normal %lld ms, idle %lld ms, sleep %lld ms, avg %.2f mA",
+		s.panel_us[LCD_PANEL_NORMAL] / 1000, s.panel_us[LCD_PANEL_IDLE] / 1000, s.panel_us[LCD_PANEL_SLEEP] / 1000, s.panel_avg_ma);
+	ESP_LOGI(TAG, "wakes: display %"PRIu32", bt %"PRIu32", button %"PRIu32", estimated total %.2f mA",
+		s.wakes[POWER_SRC_DISPLAY], s.wakes[POWER_SRC_BT], s.wakes[POWER_SRC_BUTTON], s.total_avg_ma);
+}
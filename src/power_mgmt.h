@@ -0,0 +1,113 @@
+/**
+ * @file power_mgmt.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Wake window scheduler, automatic light sleep and panel power modes
+ *
+ * Display refreshes, HID sends and button presses all open (or join) a shared
+ * wake window. Light sleep is blocked while a window is open, between windows
+ * the CPU is free to light sleep and the panel drops to idle mode, or to sleep
+ * mode once there has been no user input for a while.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include <inttypes.h>
+#include "esp_err.h"
+#include "display_main.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define POWER_WINDOW_MS            200    //how long a wake window stays open after the last request
+#define POWER_DISPLAY_SLEEP_MS     30000  //panel goes to sleep mode after this long without input
+
+#define POWER_MAX_FREQ_MHZ         160
+#define POWER_MIN_FREQ_MHZ         40
+
+/* Rough current estimates (mA) used for the average current report. */
+#define POWER_CURRENT_CPU_ACTIVE   30.0f  //CPU awake, radio in modem sleep
+#define POWER_CURRENT_CPU_SLEEP    0.8f   //light sleep
+#define POWER_CURRENT_PANEL_NORMAL 6.0f
+#define POWER_CURRENT_PANEL_IDLE   2.0f
+#define POWER_CURRENT_PANEL_SLEEP  0.02f
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+/* Reasons for opening a wake window. */
+typedef enum {
+	POWER_SRC_DISPLAY = 0,
+	POWER_SRC_BT,
+	POWER_SRC_BUTTON,
+	POWER_SRC_COUNT,
+} POWER_source_t;
+
+/* Time spent per mode since POWER_init and the resulting current estimate. */
+typedef struct {
+	int64_t awake_us;                   //inside wake windows
+	int64_t sleep_us;                   //between windows (light sleep allowed)
+	int64_t panel_us[3];                //indexed by LCD_panel_mode_t
+	uint32_t wakes[POWER_SRC_COUNT];
+	float cpu_avg_ma;
+	float panel_avg_ma;
+	float total_avg_ma;
+} POWER_stats_t;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+/** @brief Initialize power management
+ *
+ *  Enables dynamic frequency scaling with automatic light sleep and GPIO wakeup.
+ *  The framebuffer and the bus must be initialized first, panel mode changes
+ *  are posted to the dispatcher which applies them through the framebuffer.
+ *
+ *  @return ESP_OK on success.
+ */
+esp_err_t POWER_init(void);
+
+/** @brief Allow a GPIO to wake the CPU from light sleep
+ *
+ *  @param gpio_num Pin to wake on (active low)
+ *  @return Void.
+ */
+void POWER_enableGpioWakeup(int gpio_num);
+
+/** @brief Open or extend a wake window
+ *
+ *  Call before doing work, light sleep stays blocked until POWER_WINDOW_MS after the
+ *  last request. Button requests also wake the panel from sleep mode.
+ *
+ *  @param src Reason for the request
+ *  @return Void.
+ */
+void POWER_requestWake(POWER_source_t src);
+
+/** @brief Get time per mode and the estimated average current
+ *
+ *  @param stats Filled with the current statistics
+ *  @return Void.
+ */
+void POWER_getStats(POWER_stats_t* stats);
+
+/** @brief Log the power statistics to the console
+ *
+ *  @return Void.
+ */
+void POWER_logStats(void);
+
+#ifdef __cplusplus
+}
+#endif
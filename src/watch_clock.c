@@ -0,0 +1,125 @@
+/**
+ * @file watch_clock.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Wall clock timekeeping and minute tick notifications
+ *
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <string.h>
+#include <sys/time.h>
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "watch_clock.h"
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+typedef struct {
+	CLOCK_tick_cb_t cb;
+	void* arg;
+} CLOCK_subscriber_t;
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static const char* TAG = "watch_clock";
+
+static esp_timer_handle_t tick_timer = NULL;
+
+static CLOCK_subscriber_t subscribers[CLOCK_MAX_SUBSCRIBERS];
+static int subscriber_count = 0;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+//Microseconds from now until just after the next minute boundary
+static uint64_t CLOCK_usUntilNextMinute(void)
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+
+	const uint64_t into_minute = (uint64_t)(tv.tv_sec % 60) * 1000000 + tv.tv_usec;
+	return (60 * 1000000ULL) - into_minute + CLOCK_WAKE_MARGIN_US;
+}
+
+static void CLOCK_notify(void)
+{
+	struct tm now;
+	CLOCK_getTime(&now);
+
+	for (int i = 0; i < subscriber_count; i++)
+	{
+		subscribers[i].cb(&now, subscribers[i].arg);
+	}
+}
+
+//Re-arm from the current time each tick, lateness of this tick never carries over
+static void CLOCK_tickCallback(void* arg)
+{
+	esp_timer_start_once(tick_timer, CLOCK_usUntilNextMinute());
+	CLOCK_notify();
+}
+
+esp_err_t CLOCK_init(int hour, int mins)
+{
+	const esp_timer_create_args_t timer_args = {
+		.callback = CLOCK_tickCallback,
+		.name = "clock_tick",
+	};
+
+	esp_err_t ret = esp_timer_create(&timer_args, &tick_timer);
+	if (ret != ESP_OK)
+	{
+		ESP_LOGE(TAG, "failed to create tick timer: %s", esp_err_to_name(ret));
+		return ret;
+	}
+
+	CLOCK_setTime(hour, mins);
+	return ESP_OK;
+}
+
+void CLOCK_setTime(int hour, int mins)
+{
+	struct tm now;
+	CLOCK_getTime(&now);
+	now.tm_hour = hour;
+	now.tm_min = mins;
+	now.tm_sec = 0;
+
+	struct timeval tv = {.tv_sec = mktime(&now), .tv_usec = 0};
+	settimeofday(&tv, NULL);
+	ESP_LOGI(TAG, "time set to %02d:%02d", hour, mins);
+
+	//realign the tick with the new time
+	esp_timer_stop(tick_timer);
+	esp_timer_start_once(tick_timer, CLOCK_usUntilNextMinute());
+	CLOCK_notify();
+}
+
+void CLOCK_getTime(struct tm* now)
+{
+	time_t t;
+	time(&t);
+	localtime_r(&t, now);
+}
+
+esp_err_t CLOCK_subscribe(CLOCK_tick_cb_t cb, void* arg)
+{
+	if (subscriber_count == CLOCK_MAX_SUBSCRIBERS)
+	{
+		return ESP_ERR_NO_MEM;
+	}
+
+	subscribers[subscriber_count].cb = cb;
+	subscribers[subscriber_count].arg = arg;
+	subscriber_count++;
+	return ESP_OK;
+}
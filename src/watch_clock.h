@@ -0,0 +1,80 @@
+/**
+ * @file watch_clock.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Wall clock timekeeping and minute tick notifications
+ *
+ * Time is kept by the system clock (gettimeofday/settimeofday), an esp_timer
+ * is re-armed after every tick for the next minute boundary computed from the
+ * current time, so render or scheduling delays never accumulate.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include <time.h>
+#include "esp_err.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define CLOCK_MAX_SUBSCRIBERS  4
+#define CLOCK_WAKE_MARGIN_US   1000 //wake just after the boundary so the new minute is already visible
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+/* Minute tick callback, runs in the esp_timer task so it should only notify/queue work. */
+typedef void (*CLOCK_tick_cb_t)(const struct tm* now, void* arg);
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+/** @brief Initialize the clock
+ *
+ *  Sets the wall clock and starts the minute tick timer.
+ *
+ *  @param hour Current hour (0-23)
+ *  @param mins Current minute (0-59)
+ *  @return ESP_OK on success.
+ */
+esp_err_t CLOCK_init(int hour, int mins);
+
+/** @brief Set the wall clock
+ *
+ *  Subscribers are notified right away and the next tick is realigned.
+ *
+ *  @param hour Current hour (0-23)
+ *  @param mins Current minute (0-59)
+ *  @return Void.
+ */
+void CLOCK_setTime(int hour, int mins);
+
+/** @brief Get the current local time
+ *
+ *  @param now Filled with the current time
+ *  @return Void.
+ */
+void CLOCK_getTime(struct tm* now);
+
+/** @brief Get notified on every minute boundary
+ *
+ *  @param cb Callback run on each tick
+ *  @param arg Passed back to cb
+ *  @return ESP_OK, or ESP_ERR_NO_MEM when all subscriber slots are used.
+ */
+esp_err_t CLOCK_subscribe(CLOCK_tick_cb_t cb, void* arg);
+
+#ifdef __cplusplus
+}
+#endif
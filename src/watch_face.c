@@ -0,0 +1,162 @@
+/**
+ * @file watch_face.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Watch face widgets and the display handlers on the app bus
+ *
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <stdatomic.h>
+#include <time.h>
+#include "display_main.h"
+#include "display_fb.h"
+#include "display_anim.h"
+#include "display_ui.h"
+#include "display_font.h"
+#include "display_assets.h"
+#include "watch_clock.h"
+#include "battery.h"
+#include "power_mgmt.h"
+#include "app_bus.h"
+#include "watch_face.h"
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+//clock digits are palette indexed, rebuilding this recolors the clock
+static LCD_palette_t clock_palette;
+
+//text drawn on the background
+static LCD_palette_t text_palette;
+
+//screen layout, widgets are placed from these when they are added
+static const UI_layout_t battery_layout = {UI_ALIGN_RIGHT, 4, 4};
+static const UI_layout_t date_layout    = {UI_ALIGN_CENTER, 0, 26};
+static const UI_layout_t clock_layout   = {UI_ALIGN_LEFT, 11, 44};
+static const UI_layout_t icon_layout    = {UI_ALIGN_CENTER, 0, 92};
+
+static FACE_widgets_t widgets;
+static atomic_bool animated = true;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+static UI_transition_t FACE_transition(UI_transition_t transition)
+{
+	return atomic_load(&animated) ? transition : UI_TRANSITION_NONE;
+}
+
+void LCD_drawMediaIcon(uint8_t icon_index)
+{
+	UI_setIcon(widgets.icon, icon_index, UI_TRANSITION_NONE);
+	POWER_requestWake(POWER_SRC_DISPLAY);
+	UI_commit();
+}
+
+void LCD_slideMediaIcon(uint8_t icon_index, bool forward)
+{
+	//falls back to a plain redraw while another transition is running
+	UI_setIcon(widgets.icon, icon_index, FACE_transition(forward ? UI_TRANSITION_UP : UI_TRANSITION_DOWN));
+	POWER_requestWake(POWER_SRC_DISPLAY);
+	UI_commit();
+}
+
+//Display handler, redraws the time and date
+static void FACE_time(const BUS_msg_t* msg, void* arg)
+{
+	struct tm now;
+
+	CLOCK_getTime(&now);
+
+	//a changed time rolls in from the bottom
+	UI_setTime(widgets.clock, now.tm_hour, now.tm_min, FACE_transition(UI_TRANSITION_UP));
+
+	//date line above the clock
+	char date[FB_TEXT_MAX];
+	strftime(date, sizeof(date), "%a %d %b", &now);
+	UI_setText(widgets.date, date);
+
+	int battery_mv;
+	if (BATTERY_readMv(&battery_mv) == ESP_OK)
+	{
+		UI_setBattery(widgets.battery, BATTERY_percent(battery_mv));
+	}
+
+	POWER_requestWake(POWER_SRC_DISPLAY);
+	UI_commit();
+
+	if (now.tm_min % FACE_BUS_LOG_MINUTES == 0)
+	{
+		BUS_logStats();
+	}
+}
+
+//Display handler, media icon picked with the buttons
+static void FACE_icon(const BUS_msg_t* msg, void* arg)
+{
+	LCD_slideMediaIcon(msg->data.icon.index, msg->data.icon.forward);
+}
+
+//Transition finished, runs in the animation task
+static void FACE_animDone(void* arg)
+{
+	const BUS_msg_t msg = {.type = BUS_MSG_REDRAW};
+	BUS_post(&msg);
+}
+
+//Display handler, sends what changed under a transition once it ends
+static void FACE_redraw(const BUS_msg_t* msg, void* arg)
+{
+	FB_flush();
+}
+
+esp_err_t FACE_init(spi_device_handle_t spi)
+{
+	esp_err_t ret;
+
+	LCD_paletteInit(&clock_palette, clock_palette_colors, glyph_display_numbers[0].bpp);
+	FONT_makePalette(&text_palette, &font_5x7, FACE_DATE_COLOR, FACE_BACKGROUND);
+
+	FB_init(spi, FACE_BACKGROUND);
+	FB_flush();
+	ret = ANIM_init(ANIM_DEFAULT_FPS, FACE_animDone, NULL);
+	if (ret != ESP_OK)
+	{
+		return ret;
+	}
+
+	//widgets, later ones are drawn on top
+	UI_init(0, FACE_BACKGROUND);
+	widgets.clock = UI_addClock(&clock_layout, glyph_display_numbers, &glyph_semi_colon, &clock_palette);
+	widgets.icon = UI_addIcon(&icon_layout, rle_media_icons, MEDIA_ICONS_COUNT);
+	widgets.date = UI_addLabel(&date_layout, &font_5x7, FACE_DATE_SCALE, &text_palette);
+	widgets.battery = UI_addBattery(&battery_layout);
+
+	//the dispatcher owns the display, nothing else draws
+	ret = BUS_subscribe(BUS_MSG_CLOCK_TICK, FACE_time, NULL);
+	if (ret == ESP_OK)
+	{
+		ret = BUS_subscribe(BUS_MSG_ICON, FACE_icon, NULL);
+	}
+	if (ret == ESP_OK)
+	{
+		ret = BUS_subscribe(BUS_MSG_REDRAW, FACE_redraw, NULL);
+	}
+	return ret;
+}
+
+void FACE_setAnimated(bool on)
+{
+	atomic_store(&animated, on);
+}
+
+void FACE_getWidgets(FACE_widgets_t* out)
+{
+	*out = widgets;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file watch_face.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Watch face widgets and the display handlers on the app bus
+ *
+ * The face is the clock, the media icon, the date label and the battery
+ * gauge. Its handlers run on the dispatcher, which owns the display: a clock
+ * tick redraws the time, date and gauge, an icon message slides the media
+ * icon in, and the end of a transition flushes what changed under it.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include <stdbool.h>
+#include "esp_err.h"
+#include "driver/spi_master.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define FACE_BACKGROUND       0x7D7D
+#define FACE_DATE_COLOR       0xFFFF
+#define FACE_DATE_SCALE       2
+#define FACE_BUS_LOG_MINUTES  10  //bus counters are logged on these minute boundaries
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+/* Widget ids, for UI_getBounds and friends. */
+typedef struct {
+	int clock;
+	int icon;
+	int date;
+	int battery;
+} FACE_widgets_t;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+/** @brief Clear the screen, build the widgets and subscribe the display handlers
+ *
+ *  Call once after BUS_init and LCD_init. Starts the animation task. The
+ *  first clock tick draws the time and date, the icon shows once picked.
+ *
+ *  @param spi Display bus handle
+ *  @return ESP_OK on success.
+ */
+esp_err_t FACE_init(spi_device_handle_t spi);
+
+/** @brief Turn the scroll transitions on or off
+ *
+ *  On by default. Off, a new time or icon is drawn in place.
+ *
+ *  @param animated true to scroll changes in
+ *  @return Void.
+ */
+void FACE_setAnimated(bool animated);
+
+/** @brief Get the widget ids
+ *
+ *  @param widgets Filled with the ids FACE_init got
+ *  @return Void.
+ */
+void FACE_getWidgets(FACE_widgets_t* widgets);
+
+#ifdef __cplusplus
+}
+#endif
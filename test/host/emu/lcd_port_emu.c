@@ -0,0 +1,244 @@
+/**
+ * @file lcd_port_emu.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief display_port.h implementation that feeds the ST7735S model
+ *
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "display_main.h"
+#include "lcd_port_emu.h"
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static EMU_st7735s_t emu;
+static pthread_mutex_t emu_lock;
+static pthread_once_t emu_once = PTHREAD_ONCE_INIT;
+
+//finished queued transactions, handed back in order
+static spi_transaction_t* done[LCD_EMU_QUEUE_MAX];
+static int done_head = 0;
+static int done_count = 0;
+
+static LCD_emu_calls_t calls;
+static LCD_emu_capture_t* capture;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+static void LCD_emuLockInit(void)
+{
+	pthread_mutexattr_t attr;
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&emu_lock, &attr);
+}
+
+static void LCD_emuTake(void)
+{
+	pthread_once(&emu_once, LCD_emuLockInit);
+	pthread_mutex_lock(&emu_lock);
+}
+
+void LCD_emuInit(void)
+{
+	LCD_emuTake();
+	EMU_init(&emu, X_OFFSET, Y_OFFSET, WIDTH, HEIGHT);
+	done_head = 0;
+	done_count = 0;
+	memset(&calls, 0, sizeof(calls));
+	capture = NULL;
+	pthread_mutex_unlock(&emu_lock);
+}
+
+EMU_st7735s_t* LCD_emuLock(void)
+{
+	LCD_emuTake();
+	return &emu;
+}
+
+void LCD_emuUnlock(void)
+{
+	pthread_mutex_unlock(&emu_lock);
+}
+
+void LCD_emuFrameEnd(EMU_counters_t* out)
+{
+	LCD_emuTake();
+	EMU_frameEnd(&emu, out);
+	pthread_mutex_unlock(&emu_lock);
+}
+
+void LCD_emuCalls(LCD_emu_calls_t* out)
+{
+	LCD_emuTake();
+	if (out != NULL)
+	{
+		*out = calls;
+	}
+	memset(&calls, 0, sizeof(calls));
+	pthread_mutex_unlock(&emu_lock);
+}
+
+void LCD_emuCapture(LCD_emu_capture_t* c)
+{
+	LCD_emuTake();
+	capture = c;
+	if (c != NULL)
+	{
+		c->len = 0;
+	}
+	pthread_mutex_unlock(&emu_lock);
+}
+
+double LCD_emuCpuUs(const LCD_emu_calls_t* c)
+{
+	return c->polled_ns / 1000.0 + c->polled * LCD_EMU_POLL_US + c->queued * LCD_EMU_QUEUE_US + c->results * LCD_EMU_RESULT_US;
+}
+
+int LCD_emuDump(const char* path)
+{
+	const size_t len = strlen(path);
+	int ret;
+
+	LCD_emuTake();
+	if (len > 4 && strcmp(path + len - 4, ".png") == 0)
+	{
+		ret = EMU_dumpPng(&emu, path);
+	}
+	else
+	{
+		ret = EMU_dumpPpm(&emu, path);
+	}
+	pthread_mutex_unlock(&emu_lock);
+	return ret;
+}
+
+bool LCD_emuVerify(uint32_t expected_crc, const LCD_bus_region_t* region, void* arg)
+{
+	LCD_emuTake();
+	const uint32_t crc = EMU_gramCrc(&emu, region->x, region->y, region->w, region->h);
+	pthread_mutex_unlock(&emu_lock);
+	return crc == expected_crc;
+}
+
+//What the SPI master does per transaction: pre_cb drives D/C, then the bytes go out
+static uint64_t LCD_emuSend(spi_device_handle_t spi, spi_transaction_t* t)
+{
+	const uint8_t* data = (t->flags & SPI_TRANS_USE_TXDATA) ? t->tx_data : t->tx_buffer;
+	const int clock_hz = spi->cfg.clock_speed_hz;
+
+	if (spi->cfg.pre_cb != NULL)
+	{
+		spi->cfg.pre_cb(t);
+	}
+	EMU_transfer(&emu, data, t->length / 8, clock_hz);
+
+	for (size_t i = 0; capture != NULL && i < t->length / 8; i++, capture->len++)
+	{
+		if (capture->len < capture->size)
+		{
+			capture->bytes[capture->len] = data[i];
+			capture->dc[capture->len] = emu.dc;
+		}
+	}
+
+	//wire time
+	return (clock_hz > 0) ? (uint64_t)t->length * 1000000000ULL / clock_hz : 0;
+}
+
+esp_err_t LCD_emuTransmit(spi_device_handle_t spi, spi_transaction_t* t)
+{
+	esp_err_t ret = ESP_OK;
+
+	LCD_emuTake();
+	//the driver refuses a polling transaction while queued ones are outstanding
+	if (done_count > 0)
+	{
+		ret = ESP_ERR_INVALID_STATE;
+	}
+	else
+	{
+		calls.polled_ns += LCD_emuSend(spi, t);
+		calls.polled++;
+	}
+	pthread_mutex_unlock(&emu_lock);
+	return ret;
+}
+
+esp_err_t LCD_emuQueue(spi_device_handle_t spi, spi_transaction_t* t, TickType_t ticks)
+{
+	esp_err_t ret = ESP_OK;
+
+	LCD_emuTake();
+	//nothing is reaped while the caller is blocked here, a full queue would never drain
+	if (done_count >= spi->cfg.queue_size || done_count == LCD_EMU_QUEUE_MAX)
+	{
+		ret = ESP_ERR_TIMEOUT;
+	}
+	else
+	{
+		calls.bursts += (done_count == 0);
+		calls.queued++;
+		calls.queued_ns += LCD_emuSend(spi, t);
+		done[(done_head + done_count) % LCD_EMU_QUEUE_MAX] = t;
+		done_count++;
+	}
+	pthread_mutex_unlock(&emu_lock);
+	return ret;
+}
+
+esp_err_t LCD_emuResult(spi_device_handle_t spi, spi_transaction_t** t, TickType_t ticks)
+{
+	LCD_emuTake();
+	if (done_count == 0)
+	{
+		pthread_mutex_unlock(&emu_lock);
+		if (ticks == portMAX_DELAY)
+		{
+			//on target this blocks forever
+			fprintf(stderr, "lcd_port_emu: waiting for a result with nothing queued\n");
+			abort();
+		}
+		return ESP_ERR_TIMEOUT;
+	}
+	*t = done[done_head];
+	calls.results++;
+	done_head = (done_head + 1) % LCD_EMU_QUEUE_MAX;
+	done_count--;
+	pthread_mutex_unlock(&emu_lock);
+	return ESP_OK;
+}
+
+void LCD_emuSetLevel(int pin, int level)
+{
+	LCD_emuTake();
+	if (pin == PIN_DATA_NCOMMAND)
+	{
+		EMU_setDc(&emu, level);
+	}
+	else if (pin == PIN_RESET && level == 0)
+	{
+		EMU_reset(&emu);
+	}
+	pthread_mutex_unlock(&emu_lock);
+	gpio_set_level(pin, level);
+}
+
+void LCD_emuDelay(int ms)
+{
+	LCD_emuTake();
+	EMU_delay(&emu, ms);
+	pthread_mutex_unlock(&emu_lock);
+}
@@ -0,0 +1,162 @@
+/**
+ * @file lcd_port_emu.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief display_port.h implementation that feeds the ST7735S model
+ *
+ * Selected with -DLCD_PORT_HEADER="lcd_port_emu.h". Transactions run the
+ * device pre_cb (LCD_spiPreTransferCallback, installed by LCD_busInit) and
+ * are clocked into the model right away, queued ones are returned by
+ * LCD_PORT_GET_RESULT in order. Driving RESET low resets the model, delays
+ * only advance the model's sleep out timer. Tests reach the model through
+ * LCD_emuLock, which also keeps it still while the flush task is sending.
+ * LCD_PORT_VERIFY reads the calibration pattern back out of the model's GRAM.
+ * LCD_emuCapture records the byte stream with the D/C level of every byte.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/spi_master.h"
+#include "driver/gpio.h"
+#include "esp_err.h"
+#include "display_bus.h"
+#include "st7735s.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+/* SPI transactions. */
+#define LCD_PORT_POLL_TRANS(spi, t)              LCD_emuTransmit((spi), (t))
+#define LCD_PORT_QUEUE_TRANS(spi, t, ticks)      LCD_emuQueue((spi), (t), (ticks))
+#define LCD_PORT_GET_RESULT(spi, t, ticks)       LCD_emuResult((spi), (t), (ticks))
+
+/* Control pins. */
+#define LCD_PORT_CONFIG_OUTPUTS(conf)            gpio_config(conf)
+#define LCD_PORT_SET_LEVEL(pin, level)           LCD_emuSetLevel((pin), (level))
+
+/* Blocking delay. */
+#define LCD_PORT_DELAY_MS(ms)                    LCD_emuDelay(ms)
+
+/* Calibration pattern check. */
+#define LCD_PORT_VERIFY                          LCD_emuVerify
+
+#define LCD_EMU_QUEUE_MAX  16  //queued transactions the port holds, at least the device queue_size
+
+/* Rough ESP32 spi_master CPU cost per driver call at 160 MHz, for LCD_emuCpuUs. */
+#define LCD_EMU_POLL_US    12.0   //polling transaction: acquire, setup, teardown
+#define LCD_EMU_QUEUE_US   4.0    //queueing a transaction, the driver ISR chains it
+#define LCD_EMU_RESULT_US  2.0    //collecting a finished transaction
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+/* SPI driver calls made through the port, what the bus counters cannot see. */
+typedef struct {
+	uint32_t polled;     //polling transactions, each a full round trip
+	uint32_t queued;     //queued transactions
+	uint32_t bursts;     //queued transactions that found the queue empty
+	uint32_t results;    //finished queued transactions handed back
+	uint64_t polled_ns;  //wire time of polled transactions, the CPU waits through it
+	uint64_t queued_ns;  //wire time of queued transactions, sent while the CPU is free
+} LCD_emu_calls_t;
+
+/* Byte stream recorded by LCD_emuCapture. */
+typedef struct {
+	uint8_t* bytes;
+	uint8_t* dc;         //D/C level each byte went out with
+	size_t size;         //room in bytes and dc
+	size_t len;          //bytes seen, keeps counting past size
+} LCD_emu_capture_t;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+/** @brief Power up the model, call before LCD_busInit
+ *
+ *  @return Void.
+ */
+void LCD_emuInit(void);
+
+/** @brief Take the model for inspection, nothing is sent until LCD_emuUnlock
+ *
+ *  @return The model.
+ */
+EMU_st7735s_t* LCD_emuLock(void);
+
+/** @brief Release the model taken with LCD_emuLock
+ *
+ *  @return Void.
+ */
+void LCD_emuUnlock(void);
+
+/** @brief End a frame of the model counters
+ *
+ *  @param out Filled with the counters since the last call (may be NULL)
+ *  @return Void.
+ */
+void LCD_emuFrameEnd(EMU_counters_t* out);
+
+/** @brief Get the driver calls since the last call
+ *
+ *  @param out Filled with the calls since the last call (may be NULL)
+ *  @return Void.
+ */
+void LCD_emuCalls(LCD_emu_calls_t* out);
+
+/** @brief Record every byte clocked into the model
+ *
+ *  @param capture Buffers to fill with len reset to 0, NULL stops recording
+ *  @return Void.
+ */
+void LCD_emuCapture(LCD_emu_capture_t* capture);
+
+/** @brief Estimate the CPU time the driver calls would take on target
+ *
+ *  Polled transactions keep the CPU for their wire time, queued ones only
+ *  for queueing and collecting them.
+ *
+ *  @param calls Counters from LCD_emuCalls
+ *  @return CPU time in microseconds.
+ */
+double LCD_emuCpuUs(const LCD_emu_calls_t* calls);
+
+/** @brief Dump what the glass shows
+ *
+ *  Written as PNG when path ends in ".png", PPM otherwise.
+ *
+ *  @param path File to write
+ *  @return 0 on success, -1 if the file cannot be written.
+ */
+int LCD_emuDump(const char* path);
+
+/** @brief Calibration verify hook, checks the region in the model's GRAM
+ *
+ *  @param expected_crc CRC of the pattern that was sent
+ *  @param region GRAM region the pattern was written to
+ *  @param arg Unused
+ *  @return true if the region holds the pattern.
+ */
+bool LCD_emuVerify(uint32_t expected_crc, const LCD_bus_region_t* region, void* arg);
+
+esp_err_t LCD_emuTransmit(spi_device_handle_t spi, spi_transaction_t* t);
+esp_err_t LCD_emuQueue(spi_device_handle_t spi, spi_transaction_t* t, TickType_t ticks);
+esp_err_t LCD_emuResult(spi_device_handle_t spi, spi_transaction_t** t, TickType_t ticks);
+void LCD_emuSetLevel(int pin, int level);
+void LCD_emuDelay(int ms);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,547 @@
+/**
+ * @file st7735s.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Software model of the ST7735S controller for host tests
+ *
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "esp_rom_crc.h"
+#include "st7735s.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+// ST7735S commands the model understands (ref: pdf datasheet v1.4)
+#define CMD_NOP     0x00
+#define CMD_SWRESET 0x01
+#define CMD_SLPIN   0x10
+#define CMD_SLPOUT  0x11
+#define CMD_NORON   0x13
+#define CMD_INVOFF  0x20
+#define CMD_INVON   0x21
+#define CMD_GAMSET  0x26
+#define CMD_DISPOFF 0x28
+#define CMD_DISPON  0x29
+#define CMD_CASET   0x2A
+#define CMD_RASET   0x2B
+#define CMD_RAMWR   0x2C
+#define CMD_VSCRDEF 0x33
+#define CMD_TEOFF   0x34
+#define CMD_TEON    0x35
+#define CMD_MADCTL  0x36
+#define CMD_VSCSAD  0x37
+#define CMD_IDMOFF  0x38
+#define CMD_IDMON   0x39
+#define CMD_COLMOD  0x3A
+
+#define EMU_SLPOUT_MS   120
+#define EMU_COLMOD_16   0x05  //low nibble of COLMOD for 16 bit pixels
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+void EMU_init(EMU_st7735s_t* emu, uint8_t view_x, uint8_t view_y, uint8_t view_w, uint8_t view_h)
+{
+	memset(emu, 0, sizeof(*emu));
+	emu->view_x = view_x;
+	emu->view_y = view_y;
+	emu->view_w = view_w;
+	emu->view_h = view_h;
+	EMU_reset(emu);
+}
+
+void EMU_reset(EMU_st7735s_t* emu)
+{
+	emu->cmd = CMD_NOP;
+	emu->param_count = 0;
+	emu->pixel_half = false;
+
+	emu->xs = 0;
+	emu->xe = EMU_GRAM_WIDTH - 1;
+	emu->ys = 0;
+	emu->ye = EMU_GRAM_HEIGHT - 1;
+	emu->col = 0;
+	emu->row = 0;
+
+	emu->madctl = 0x00;
+	emu->colmod = 0x06;  //18 bit
+	emu->gamma = 0x01;
+	emu->tfa = 0;
+	emu->vsa = EMU_GRAM_HEIGHT;
+	emu->bfa = 0;
+	emu->ssa = 0;
+	emu->scroll = false;
+	emu->sleeping = true;
+	emu->idle = false;
+	emu->display_on = false;
+	emu->inverted = false;
+	emu->tearing = false;
+	emu->wake_ms = 0;
+}
+
+void EMU_setDc(EMU_st7735s_t* emu, int level)
+{
+	level = level ? 1 : 0;
+	if (level != emu->dc)
+	{
+		emu->frame.dc_toggles++;
+		emu->total.dc_toggles++;
+	}
+	emu->dc = level;
+}
+
+//Number of parameters a command takes, -1 for commands the model does not know
+static int EMU_paramCount(uint8_t cmd)
+{
+	switch (cmd)
+	{
+	case CMD_NOP: case CMD_SWRESET: case CMD_SLPIN: case CMD_SLPOUT: case CMD_NORON:
+	case CMD_INVOFF: case CMD_INVON: case CMD_DISPOFF: case CMD_DISPON: case CMD_TEOFF:
+	case CMD_IDMOFF: case CMD_IDMON:
+		return 0;
+	case CMD_GAMSET: case CMD_TEON: case CMD_MADCTL: case CMD_COLMOD:
+		return 1;
+	case CMD_VSCSAD:
+		return 2;
+	case CMD_CASET: case CMD_RASET:
+		return 4;
+	case CMD_VSCRDEF:
+		return 6;
+	case CMD_RAMWR:
+		return 0;  //followed by pixel data, not parameters
+	default:
+		return -1;
+	}
+}
+
+static void EMU_command(EMU_st7735s_t* emu, uint8_t cmd)
+{
+	emu->cmd = cmd;
+	emu->param_count = 0;
+	emu->pixel_half = false;
+
+	if (emu->wake_ms > 0)
+	{
+		emu->sleep_writes++;
+	}
+
+	switch (cmd)
+	{
+	case CMD_SWRESET:
+		EMU_reset(emu);
+		break;
+	case CMD_SLPIN:
+		emu->sleeping = true;
+		break;
+	case CMD_SLPOUT:
+		emu->sleeping = false;
+		emu->wake_ms = EMU_SLPOUT_MS;
+		break;
+	case CMD_NORON:
+		//normal mode ends partial and scroll mode
+		emu->scroll = false;
+		break;
+	case CMD_INVOFF:
+		emu->inverted = false;
+		break;
+	case CMD_INVON:
+		emu->inverted = true;
+		break;
+	case CMD_DISPOFF:
+		emu->display_on = false;
+		break;
+	case CMD_DISPON:
+		emu->display_on = true;
+		break;
+	case CMD_TEOFF:
+		emu->tearing = false;
+		break;
+	case CMD_IDMOFF:
+		emu->idle = false;
+		break;
+	case CMD_IDMON:
+		emu->idle = true;
+		break;
+	case CMD_RAMWR:
+		emu->col = emu->xs;
+		emu->row = emu->ys;
+		emu->frame.ramwr++;
+		emu->total.ramwr++;
+		break;
+	case CMD_CASET:
+	case CMD_RASET:
+		emu->frame.windows++;
+		emu->total.windows++;
+		break;
+	default:
+		if (EMU_paramCount(cmd) < 0)
+		{
+			emu->unknown_cmds++;
+		}
+		break;
+	}
+}
+
+//All parameters of the current command arrived
+static void EMU_applyParams(EMU_st7735s_t* emu)
+{
+	const uint8_t* p = emu->params;
+
+	switch (emu->cmd)
+	{
+	case CMD_CASET:
+	case CMD_RASET: {
+		const uint16_t start = (p[0] << 8) | p[1];
+		const uint16_t end = (p[2] << 8) | p[3];
+		//the exchanged axis decides which limit applies
+		const bool columns = (emu->cmd == CMD_CASET) != ((emu->madctl & EMU_MADCTL_MV) != 0);
+		const uint16_t limit = columns ? EMU_GRAM_WIDTH : EMU_GRAM_HEIGHT;
+		if (start > end || end >= limit)
+		{
+			emu->bad_params++;
+		}
+		if (emu->cmd == CMD_CASET)
+		{
+			emu->xs = start;
+			emu->xe = end;
+		}
+		else
+		{
+			emu->ys = start;
+			emu->ye = end;
+		}
+		break;
+	}
+	case CMD_MADCTL:
+		emu->madctl = p[0];
+		break;
+	case CMD_COLMOD:
+		emu->colmod = p[0];
+		break;
+	case CMD_GAMSET:
+		emu->gamma = p[0];
+		break;
+	case CMD_TEON:
+		emu->tearing = true;
+		break;
+	case CMD_VSCRDEF:
+		emu->tfa = (p[0] << 8) | p[1];
+		emu->vsa = (p[2] << 8) | p[3];
+		emu->bfa = (p[4] << 8) | p[5];
+		if (emu->tfa + emu->vsa + emu->bfa != EMU_GRAM_HEIGHT)
+		{
+			emu->bad_params++;
+		}
+		break;
+	case CMD_VSCSAD:
+		emu->ssa = (p[0] << 8) | p[1];
+		if (emu->ssa < emu->tfa || emu->ssa >= emu->tfa + emu->vsa)
+		{
+			emu->bad_params++;
+		}
+		//scroll mode starts with the first start address
+		emu->scroll = true;
+		break;
+	default:
+		break;
+	}
+}
+
+//Store a pixel at the write pointer and advance it through the window
+static void EMU_writePixel(EMU_st7735s_t* emu, uint16_t color)
+{
+	int x = emu->col;
+	int y = emu->row;
+
+	if (emu->madctl & EMU_MADCTL_MV)
+	{
+		const int t = x;
+		x = y;
+		y = t;
+	}
+	if (emu->madctl & EMU_MADCTL_MX)
+	{
+		x = EMU_GRAM_WIDTH - 1 - x;
+	}
+	if (emu->madctl & EMU_MADCTL_MY)
+	{
+		y = EMU_GRAM_HEIGHT - 1 - y;
+	}
+
+	if (x >= 0 && x < EMU_GRAM_WIDTH && y >= 0 && y < EMU_GRAM_HEIGHT)
+	{
+		emu->gram[y][x] = color;
+	}
+	else
+	{
+		emu->bad_pixels++;
+	}
+
+	//column first, the window wraps back to its start once full
+	if (++emu->col > emu->xe)
+	{
+		emu->col = emu->xs;
+		if (++emu->row > emu->ye)
+		{
+			emu->row = emu->ys;
+		}
+	}
+}
+
+static void EMU_data(EMU_st7735s_t* emu, uint8_t byte, bool too_fast)
+{
+	if (emu->cmd == CMD_RAMWR)
+	{
+		//sampled a bit late, the last bit of each byte is lost
+		if (too_fast)
+		{
+			byte ^= 0x01;
+		}
+		emu->frame.pixel_bytes++;
+		emu->total.pixel_bytes++;
+		if ((emu->colmod & 0x07) != EMU_COLMOD_16)
+		{
+			emu->bad_pixels++;
+		}
+
+		//RGB565, high byte first
+		if (!emu->pixel_half)
+		{
+			emu->pixel_hi = byte;
+			emu->pixel_half = true;
+		}
+		else
+		{
+			EMU_writePixel(emu, (emu->pixel_hi << 8) | byte);
+			emu->pixel_half = false;
+		}
+		return;
+	}
+
+	const int expected = EMU_paramCount(emu->cmd);
+	if (expected <= 0 || emu->param_count >= expected)
+	{
+		emu->bad_params++;
+		return;
+	}
+	emu->params[emu->param_count++] = byte;
+	if (emu->param_count == expected)
+	{
+		EMU_applyParams(emu);
+	}
+}
+
+void EMU_transfer(EMU_st7735s_t* emu, const uint8_t* data, size_t len, int clock_hz)
+{
+	emu->frame.transactions++;
+	emu->total.transactions++;
+	emu->frame.bytes += len;
+	emu->total.bytes += len;
+	const bool too_fast = (emu->max_clock_hz > 0 && clock_hz > emu->max_clock_hz);
+	if (clock_hz > 0)
+	{
+		const uint64_t ns = (uint64_t)len * 8 * 1000000000ULL / clock_hz;
+		emu->frame.bus_ns += ns;
+		emu->total.bus_ns += ns;
+	}
+
+	for (size_t i = 0; i < len; i++)
+	{
+		if (emu->dc == 0)
+		{
+			emu->frame.commands++;
+			emu->total.commands++;
+			EMU_command(emu, data[i]);
+		}
+		else
+		{
+			EMU_data(emu, data[i], too_fast);
+		}
+	}
+}
+
+uint32_t EMU_gramCrc(const EMU_st7735s_t* emu, int x, int y, int w, int h)
+{
+	uint8_t line[EMU_GRAM_WIDTH * 2];
+	uint32_t crc = 0;
+
+	if (x < 0 || y < 0 || w <= 0 || h <= 0 || x + w > EMU_GRAM_WIDTH || y + h > EMU_GRAM_HEIGHT)
+	{
+		return 0;
+	}
+	for (int j = y; j < y + h; j++)
+	{
+		for (int i = 0; i < w; i++)
+		{
+			line[i * 2] = emu->gram[j][x + i] >> 8;
+			line[i * 2 + 1] = emu->gram[j][x + i] & 0xFF;
+		}
+		crc = esp_rom_crc32_le(crc, line, w * 2);
+	}
+	return crc;
+}
+
+void EMU_delay(EMU_st7735s_t* emu, int ms)
+{
+	emu->wake_ms = (emu->wake_ms > ms) ? emu->wake_ms - ms : 0;
+}
+
+void EMU_frameEnd(EMU_st7735s_t* emu, EMU_counters_t* out)
+{
+	if (out != NULL)
+	{
+		*out = emu->frame;
+	}
+	memset(&emu->frame, 0, sizeof(emu->frame));
+}
+
+int EMU_scanLine(const EMU_st7735s_t* emu, int line)
+{
+	if (!emu->scroll || line < emu->tfa || line >= emu->tfa + emu->vsa || emu->vsa == 0)
+	{
+		return line;
+	}
+	//the scroll area shows memory from the start line on and wraps inside the area
+	const int offset = (emu->ssa - emu->tfa + (line - emu->tfa)) % emu->vsa;
+	return emu->tfa + ((offset < 0) ? offset + emu->vsa : offset);
+}
+
+uint16_t EMU_viewPixel(const EMU_st7735s_t* emu, int x, int y)
+{
+	if (emu->sleeping || !emu->display_on)
+	{
+		return 0x0000;
+	}
+
+	uint16_t c = emu->gram[EMU_scanLine(emu, emu->view_y + y)][emu->view_x + x];
+	if (emu->inverted)
+	{
+		c = ~c;
+	}
+	if (emu->idle)
+	{
+		//8 colors, only the most significant bit of each channel is shown
+		c = ((c & 0x8000) ? 0xF800 : 0) | ((c & 0x0400) ? 0x07E0 : 0) | ((c & 0x0010) ? 0x001F : 0);
+	}
+	return c;
+}
+
+//RGB888 of a view pixel
+static void EMU_viewRgb(const EMU_st7735s_t* emu, int x, int y, uint8_t* rgb)
+{
+	const uint16_t c = EMU_viewPixel(emu, x, y);
+	const uint8_t r = (c >> 11) & 0x1F;
+	const uint8_t g = (c >> 5) & 0x3F;
+	const uint8_t b = c & 0x1F;
+	rgb[0] = (r << 3) | (r >> 2);
+	rgb[1] = (g << 2) | (g >> 4);
+	rgb[2] = (b << 3) | (b >> 2);
+}
+
+int EMU_dumpPpm(const EMU_st7735s_t* emu, const char* path)
+{
+	FILE* f = fopen(path, "wb");
+	if (f == NULL)
+	{
+		return -1;
+	}
+
+	fprintf(f, "P6\n%d %d\n255\n", emu->view_w, emu->view_h);
+	for (int y = 0; y < emu->view_h; y++)
+	{
+		for (int x = 0; x < emu->view_w; x++)
+		{
+			uint8_t rgb[3];
+			EMU_viewRgb(emu, x, y, rgb);
+			fwrite(rgb, 1, sizeof(rgb), f);
+		}
+	}
+	return fclose(f) == 0 ? 0 : -1;
+}
+
+static void EMU_put32(uint8_t* p, uint32_t v)
+{
+	p[0] = v >> 24;
+	p[1] = v >> 16;
+	p[2] = v >> 8;
+	p[3] = v;
+}
+
+//Length, type, data and the CRC over type and data
+static void EMU_pngChunk(FILE* f, const char* type, const uint8_t* data, uint32_t len)
+{
+	uint8_t word[4];
+
+	EMU_put32(word, len);
+	fwrite(word, 1, 4, f);
+	fwrite(type, 1, 4, f);
+	fwrite(data, 1, len, f);
+	EMU_put32(word, esp_rom_crc32_le(esp_rom_crc32_le(0, (const uint8_t*)type, 4), data, len));
+	fwrite(word, 1, 4, f);
+}
+
+int EMU_dumpPng(const EMU_st7735s_t* emu, const char* path)
+{
+	static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+	//one filter byte per row, every row is its own stored deflate block
+	const int row_len = 1 + emu->view_w * 3;
+	const uint32_t idat_len = 2 + emu->view_h * (5 + row_len) + 4;
+	uint8_t idat[2 + EMU_GRAM_HEIGHT * (5 + 1 + EMU_GRAM_WIDTH * 3) + 4];
+	uint8_t ihdr[13];
+	uint32_t s1 = 1;
+	uint32_t s2 = 0;
+	uint8_t* p = idat;
+
+	FILE* f = fopen(path, "wb");
+	if (f == NULL)
+	{
+		return -1;
+	}
+
+	EMU_put32(&ihdr[0], emu->view_w);
+	EMU_put32(&ihdr[4], emu->view_h);
+	ihdr[8] = 8;   //bits per channel
+	ihdr[9] = 2;   //RGB
+	ihdr[10] = 0;  //deflate
+	ihdr[11] = 0;  //adaptive filtering
+	ihdr[12] = 0;  //no interlace
+
+	*p++ = 0x78;   //zlib header, 32K window, no dictionary
+	*p++ = 0x01;
+	for (int y = 0; y < emu->view_h; y++)
+	{
+		*p++ = (y == emu->view_h - 1) ? 1 : 0;  //final block flag, stored
+		*p++ = row_len & 0xFF;
+		*p++ = row_len >> 8;
+		*p++ = ~row_len & 0xFF;
+		*p++ = (~row_len >> 8) & 0xFF;
+
+		uint8_t* row = p;
+		*p++ = 0;  //no filter
+		for (int x = 0; x < emu->view_w; x++, p += 3)
+		{
+			EMU_viewRgb(emu, x, y, p);
+		}
+		for (uint8_t* b = row; b < p; b++)
+		{
+			s1 = (s1 + *b) % 65521;
+			s2 = (s2 + s1) % 65521;
+		}
+	}
+	EMU_put32(p, (s2 << 16) | s1);
+
+	fwrite(signature, 1, sizeof(signature), f);
+	EMU_pngChunk(f, "IHDR", ihdr, sizeof(ihdr));
+	EMU_pngChunk(f, "IDAT", idat, idat_len);
+	EMU_pngChunk(f, "IEND", NULL, 0);
+	return fclose(f) == 0 ? 0 : -1;
+}
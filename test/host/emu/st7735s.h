@@ -0,0 +1,234 @@
+/**
+ * @file st7735s.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Software model of the ST7735S controller for host tests
+ *
+ * Decodes the command stream the driver sends over the 4-wire serial
+ * interface (D/C selects command or data) into a 132x162 RGB565 GRAM, the
+ * largest memory the controller addresses. Handles the commands display_main.c
+ * uses: CASET/RASET/RAMWR with the address window and its wrap, MADCTL row
+ * and column exchange and mirroring, COLMOD, the sleep, idle, inversion and
+ * display on/off state, and the vertical scroll (VSCRDEF/VSCSAD/NORON). The
+ * panel view applies the scroll and the glass offset, so it shows what the
+ * user would see, and can be dumped as PPM or PNG. Unknown commands and malformed writes are counted, never
+ * fatal. Bytes, transactions, D/C toggles and memory writes are counted per
+ * frame and in total. A clock limit can be set to exercise the bus calibration.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define EMU_GRAM_WIDTH   132
+#define EMU_GRAM_HEIGHT  162
+#define EMU_MAX_PARAMS   8
+
+/* MADCTL bits. */
+#define EMU_MADCTL_MY    0x80  //row address order
+#define EMU_MADCTL_MX    0x40  //column address order
+#define EMU_MADCTL_MV    0x20  //row / column exchange
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+/* Bus traffic counters. */
+typedef struct {
+	uint32_t bytes;          //every byte clocked in
+	uint32_t pixel_bytes;    //bytes written to GRAM
+	uint32_t transactions;   //chip select cycles
+	uint32_t commands;       //command bytes
+	uint32_t dc_toggles;     //D/C line changes
+	uint32_t ramwr;          //memory writes started
+	uint32_t windows;        //CASET and RASET commands
+	uint64_t bus_ns;         //time on the wire at the device clock
+} EMU_counters_t;
+
+/* Controller state. */
+typedef struct {
+	uint16_t gram[EMU_GRAM_HEIGHT][EMU_GRAM_WIDTH];
+
+	//glass window onto the GRAM, set by EMU_init
+	uint8_t view_x;
+	uint8_t view_y;
+	uint8_t view_w;
+	uint8_t view_h;
+
+	//command decoder
+	int dc;                  //D/C line, 0 command
+	uint8_t cmd;
+	uint8_t params[EMU_MAX_PARAMS];
+	int param_count;
+	bool pixel_half;         //first byte of a pixel is waiting for its second
+	uint8_t pixel_hi;
+
+	//address window and pointer (logical, before MADCTL)
+	uint16_t xs;
+	uint16_t xe;
+	uint16_t ys;
+	uint16_t ye;
+	uint16_t col;
+	uint16_t row;
+
+	//registers
+	uint8_t madctl;
+	uint8_t colmod;
+	uint8_t gamma;
+	uint16_t tfa;            //top fixed lines
+	uint16_t vsa;            //scroll area lines
+	uint16_t bfa;            //bottom fixed lines
+	uint16_t ssa;            //scroll start line
+	bool scroll;
+	bool sleeping;
+	bool idle;
+	bool display_on;
+	bool inverted;
+	bool tearing;
+	int wake_ms;             //left of the 120 ms the controller needs after sleep out
+
+	//fastest clock the panel samples pixel data at, 0 for no limit, faster writes store corrupted pixels
+	int max_clock_hz;
+
+	//problems seen, all should stay 0 with a correct driver
+	uint32_t unknown_cmds;
+	uint32_t bad_params;     //parameters out of range or for a command that takes none
+	uint32_t bad_pixels;     //pixels outside memory or in a format other than 16 bit
+	uint32_t sleep_writes;   //commands sent within 120 ms of sleep out
+
+	EMU_counters_t frame;
+	EMU_counters_t total;
+} EMU_st7735s_t;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+/** @brief Power the model up
+ *
+ *  Clears every counter, then resets the controller like the RESET pin does.
+ *
+ *  @param emu Model
+ *  @param view_x First GRAM column visible on the glass
+ *  @param view_y First GRAM line visible on the glass
+ *  @param view_w Visible columns
+ *  @param view_h Visible lines
+ *  @return Void.
+ */
+void EMU_init(EMU_st7735s_t* emu, uint8_t view_x, uint8_t view_y, uint8_t view_w, uint8_t view_h);
+
+/** @brief Hardware reset
+ *
+ *  Registers go back to their reset values (sleep in, display off, 18 bit
+ *  pixels, full window), the GRAM and the counters are kept.
+ *
+ *  @param emu Model
+ *  @return Void.
+ */
+void EMU_reset(EMU_st7735s_t* emu);
+
+/** @brief Drive the D/C line
+ *
+ *  @param emu Model
+ *  @param level 0 command, 1 data
+ *  @return Void.
+ */
+void EMU_setDc(EMU_st7735s_t* emu, int level);
+
+/** @brief Clock in one transaction
+ *
+ *  @param emu Model
+ *  @param data Bytes in wire order
+ *  @param len Number of bytes
+ *  @param clock_hz Serial clock, used for the bus time and the max_clock_hz check
+ *  @return Void.
+ */
+void EMU_transfer(EMU_st7735s_t* emu, const uint8_t* data, size_t len, int clock_hz);
+
+/** @brief Note time passing without bus traffic
+ *
+ *  Used for the sleep out wait, commands sent too soon after SLPOUT are counted.
+ *
+ *  @param emu Model
+ *  @param ms Milliseconds
+ *  @return Void.
+ */
+void EMU_delay(EMU_st7735s_t* emu, int ms);
+
+/** @brief End a frame
+ *
+ *  @param emu Model
+ *  @param out Filled with the counters since the last call (may be NULL)
+ *  @return Void.
+ */
+void EMU_frameEnd(EMU_st7735s_t* emu, EMU_counters_t* out);
+
+/** @brief GRAM line shown on a panel line
+ *
+ *  @param emu Model
+ *  @param line Panel line (0 - EMU_GRAM_HEIGHT - 1)
+ *  @return Memory line, after the vertical scroll.
+ */
+int EMU_scanLine(const EMU_st7735s_t* emu, int line);
+
+/** @brief Pixel the glass shows
+ *
+ *  Applies the view window, the scroll, inversion, idle mode colors and
+ *  sleep / display off (black).
+ *
+ *  @param emu Model
+ *  @param x Screen column (0 - view_w - 1)
+ *  @param y Screen line (0 - view_h - 1)
+ *  @return RGB565 color.
+ */
+uint16_t EMU_viewPixel(const EMU_st7735s_t* emu, int x, int y);
+
+/** @brief CRC of a GRAM region
+ *
+ *  Pixels are taken line by line in wire order (high byte first), so the
+ *  result matches esp_rom_crc32_le over the buffer that was written.
+ *
+ *  @param emu Model
+ *  @param x First GRAM column
+ *  @param y First GRAM line
+ *  @param w Columns
+ *  @param h Lines
+ *  @return CRC-32, 0 if the region is outside the GRAM.
+ */
+uint32_t EMU_gramCrc(const EMU_st7735s_t* emu, int x, int y, int w, int h);
+
+/** @brief Write what the glass shows as a binary PPM
+ *
+ *  @param emu Model
+ *  @param path File to write
+ *  @return 0 on success, -1 if the file cannot be written.
+ */
+int EMU_dumpPpm(const EMU_st7735s_t* emu, const char* path);
+
+/** @brief Write what the glass shows as an RGB PNG
+ *
+ *  The image data is stored uncompressed, no zlib needed.
+ *
+ *  @param emu Model
+ *  @param path File to write
+ *  @return 0 on success, -1 if the file cannot be written.
+ */
+int EMU_dumpPng(const EMU_st7735s_t* emu, const char* path);
+
+#ifdef __cplusplus
+}
+#endif
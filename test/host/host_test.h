@@ -0,0 +1,80 @@
+/**
+ * @file host_test.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Checks and reporting shared by the host tests
+ *
+ * A failed check prints where it failed and the test keeps going, the exit
+ * code of HOST_testDone tells ctest whether anything failed. Benchmarks print
+ * their numbers with HOST_report so they show up in the ctest log.
+ */
+
+#pragma once
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdint.h>
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#ifndef HOST_FRAME_DIR
+#define HOST_FRAME_DIR "."  //where frame dumps go, set by CMake
+#endif
+
+#define CHECK(cond) \
+	HOST_check((cond), __FILE__, __LINE__, "%s", #cond)
+
+#define CHECK_EQ(actual, expected) do {                                                           \
+		const long long check_a_ = (long long)(actual);                                           \
+		const long long check_e_ = (long long)(expected);                                         \
+		HOST_check(check_a_ == check_e_, __FILE__, __LINE__, "%s == %s (%lld, expected %lld)",    \
+			#actual, #expected, check_a_, check_e_);                                              \
+	} while (0)
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static int host_checks = 0;
+static int host_failures = 0;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+static inline void HOST_check(int ok, const char* file, int line, const char* format, ...)
+{
+	host_checks++;
+	if (!ok)
+	{
+		va_list args;
+		host_failures++;
+		fprintf(stderr, "%s:%d: check failed: ", file, line);
+		va_start(args, format);
+		vfprintf(stderr, format, args);
+		va_end(args);
+		fputc('\n', stderr);
+	}
+}
+
+static inline void HOST_report(const char* format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	vprintf(format, args);
+	va_end(args);
+	fputc('\n', stdout);
+}
+
+//Exit code for main
+static inline int HOST_testDone(const char* name)
+{
+	printf("%s: %d checks, %d failed\n", name, host_checks, host_failures);
+	return host_failures ? 1 : 0;
+}
@@ -0,0 +1,309 @@
+/**
+ * @file esp_host.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Host versions of the small ESP-IDF services (errors, CRC, heap, PM, GPIO, SPI bus)
+ *
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+#include "esp_rom_crc.h"
+#include "esp_heap_caps.h"
+#include "esp_pm.h"
+#include "host_shim.h"
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+typedef struct {
+	int level;
+	gpio_int_type_t intr_type;
+	bool intr_enabled;
+	gpio_isr_t handler;
+	void* arg;
+} HOST_pin_t;
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static HOST_pin_t pins[GPIO_NUM_MAX];
+static bool isr_service = false;
+
+static spi_device_handle_t spi_devices[SPI_HOST_MAX];
+static bool spi_bus[SPI_HOST_MAX];
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+const char* esp_err_to_name(esp_err_t code)
+{
+	switch (code)
+	{
+	case ESP_OK:                 return "ESP_OK";
+	case ESP_FAIL:               return "ESP_FAIL";
+	case ESP_ERR_NO_MEM:         return "ESP_ERR_NO_MEM";
+	case ESP_ERR_INVALID_ARG:    return "ESP_ERR_INVALID_ARG";
+	case ESP_ERR_INVALID_STATE:  return "ESP_ERR_INVALID_STATE";
+	case ESP_ERR_INVALID_SIZE:   return "ESP_ERR_INVALID_SIZE";
+	case ESP_ERR_NOT_FOUND:      return "ESP_ERR_NOT_FOUND";
+	case ESP_ERR_NOT_SUPPORTED:  return "ESP_ERR_NOT_SUPPORTED";
+	case ESP_ERR_TIMEOUT:        return "ESP_ERR_TIMEOUT";
+	default:                     return "UNKNOWN ERROR";
+	}
+}
+
+//Reflected CRC-32 (0xEDB88320), the ROM inverts on the way in and out like zlib
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len)
+{
+	crc = ~crc;
+	for (uint32_t i = 0; i < len; i++)
+	{
+		crc ^= buf[i];
+		for (int bit = 0; bit < 8; bit++)
+		{
+			crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+		}
+	}
+	return ~crc;
+}
+
+size_t heap_caps_get_free_size(uint32_t caps)
+{
+	return 0;
+}
+
+size_t heap_caps_get_minimum_free_size(uint32_t caps)
+{
+	return 0;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+	return 0;
+}
+
+esp_err_t esp_pm_configure(const void* config)
+{
+	return ESP_OK;
+}
+
+esp_err_t esp_pm_lock_create(esp_pm_lock_type_t type, int arg, const char* name, esp_pm_lock_handle_t* out)
+{
+	static int lock_id;
+	*out = (esp_pm_lock_handle_t)&lock_id;
+	return ESP_OK;
+}
+
+esp_err_t esp_pm_lock_acquire(esp_pm_lock_handle_t lock)
+{
+	return ESP_OK;
+}
+
+esp_err_t esp_pm_lock_release(esp_pm_lock_handle_t lock)
+{
+	return ESP_OK;
+}
+
+/*
+ * GPIO
+ */
+
+static bool HOST_pinValid(gpio_num_t pin)
+{
+	return pin >= 0 && pin < GPIO_NUM_MAX;
+}
+
+esp_err_t gpio_config(const gpio_config_t* conf)
+{
+	for (int pin = 0; pin < GPIO_NUM_MAX; pin++)
+	{
+		if (conf->pin_bit_mask & (1ULL << pin))
+		{
+			pins[pin].intr_type = conf->intr_type;
+			pins[pin].intr_enabled = (conf->intr_type != GPIO_INTR_DISABLE);
+			//an input with a pull-up idles high
+			if (conf->mode == GPIO_MODE_INPUT && conf->pull_up_en)
+			{
+				pins[pin].level = 1;
+			}
+		}
+	}
+	return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t pin, uint32_t level)
+{
+	if (!HOST_pinValid(pin))
+	{
+		return ESP_ERR_INVALID_ARG;
+	}
+	pins[pin].level = level ? 1 : 0;
+	return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t pin)
+{
+	return HOST_pinValid(pin) ? pins[pin].level : 0;
+}
+
+esp_err_t gpio_set_intr_type(gpio_num_t pin, gpio_int_type_t type)
+{
+	if (!HOST_pinValid(pin))
+	{
+		return ESP_ERR_INVALID_ARG;
+	}
+	pins[pin].intr_type = type;
+	return ESP_OK;
+}
+
+esp_err_t gpio_intr_enable(gpio_num_t pin)
+{
+	if (!HOST_pinValid(pin))
+	{
+		return ESP_ERR_INVALID_ARG;
+	}
+	pins[pin].intr_enabled = true;
+	return ESP_OK;
+}
+
+esp_err_t gpio_intr_disable(gpio_num_t pin)
+{
+	if (!HOST_pinValid(pin))
+	{
+		return ESP_ERR_INVALID_ARG;
+	}
+	pins[pin].intr_enabled = false;
+	return ESP_OK;
+}
+
+esp_err_t gpio_install_isr_service(int flags)
+{
+	if (isr_service)
+	{
+		return ESP_ERR_INVALID_STATE;
+	}
+	isr_service = true;
+	return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t pin, gpio_isr_t handler, void* arg)
+{
+	if (!HOST_pinValid(pin))
+	{
+		return ESP_ERR_INVALID_ARG;
+	}
+	pins[pin].handler = handler;
+	pins[pin].arg = arg;
+	return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_remove(gpio_num_t pin)
+{
+	return gpio_isr_handler_add(pin, NULL, NULL);
+}
+
+esp_err_t gpio_wakeup_enable(gpio_num_t pin, gpio_int_type_t type)
+{
+	return HOST_pinValid(pin) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+void HOST_gpioSetInput(gpio_num_t pin, int level)
+{
+	HOST_pin_t* p = &pins[pin];
+	const int old = p->level;
+
+	p->level = level ? 1 : 0;
+	if (p->level == old || !p->intr_enabled || p->handler == NULL)
+	{
+		return;
+	}
+
+	bool fire;
+	switch (p->intr_type)
+	{
+	case GPIO_INTR_POSEDGE:    fire = (p->level == 1); break;
+	case GPIO_INTR_NEGEDGE:    fire = (p->level == 0); break;
+	case GPIO_INTR_ANYEDGE:    fire = true; break;
+	case GPIO_INTR_LOW_LEVEL:  fire = (p->level == 0); break;
+	case GPIO_INTR_HIGH_LEVEL: fire = (p->level == 1); break;
+	default:                   fire = false; break;
+	}
+	if (fire)
+	{
+		p->handler(p->arg);
+	}
+}
+
+/*
+ * SPI bus
+ */
+
+esp_err_t spi_bus_initialize(spi_host_device_t host, const spi_bus_config_t* config, int dma_chan)
+{
+	if (host >= SPI_HOST_MAX || spi_bus[host])
+	{
+		return ESP_ERR_INVALID_STATE;
+	}
+	spi_bus[host] = true;
+	return ESP_OK;
+}
+
+esp_err_t spi_bus_free(spi_host_device_t host)
+{
+	if (host >= SPI_HOST_MAX || !spi_bus[host] || spi_devices[host] != NULL)
+	{
+		return ESP_ERR_INVALID_STATE;
+	}
+	spi_bus[host] = false;
+	return ESP_OK;
+}
+
+esp_err_t spi_bus_add_device(spi_host_device_t host, const spi_device_interface_config_t* config, spi_device_handle_t* handle)
+{
+	if (host >= SPI_HOST_MAX || !spi_bus[host])
+	{
+		return ESP_ERR_INVALID_STATE;
+	}
+	//one device per bus is all the watch has
+	if (spi_devices[host] != NULL)
+	{
+		return ESP_ERR_NOT_FOUND;
+	}
+
+	spi_device_handle_t dev = calloc(1, sizeof(*dev));
+	if (dev == NULL)
+	{
+		return ESP_ERR_NO_MEM;
+	}
+	dev->host = host;
+	dev->cfg = *config;
+	spi_devices[host] = dev;
+	*handle = dev;
+	return ESP_OK;
+}
+
+esp_err_t spi_bus_remove_device(spi_device_handle_t handle)
+{
+	if (handle == NULL || spi_devices[handle->host] != handle)
+	{
+		return ESP_ERR_INVALID_ARG;
+	}
+	spi_devices[handle->host] = NULL;
+	free(handle);
+	return ESP_OK;
+}
+
+spi_device_handle_t HOST_spiDevice(spi_host_device_t host)
+{
+	return (host < SPI_HOST_MAX) ? spi_devices[host] : NULL;
+}
@@ -0,0 +1,274 @@
+/**
+ * @file esp_timer_host.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief esp_timer on the monotonic clock or a manual test clock
+ *
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "esp_timer.h"
+#include "host_shim.h"
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+struct esp_timer {
+	esp_timer_create_args_t args;
+	int64_t deadline_us;
+	int64_t period_us;    //0 for one shot
+	bool armed;
+	struct esp_timer* next;
+};
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static pthread_mutex_t timer_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t timer_cond;
+static pthread_t timer_thread;
+static bool thread_started = false;
+
+static struct esp_timer* timers = NULL;
+
+static bool manual = false;
+static int64_t manual_us = 0;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+static int64_t HOST_monotonicUs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+int64_t esp_timer_get_time(void)
+{
+	if (manual)
+	{
+		pthread_mutex_lock(&timer_lock);
+		const int64_t now = manual_us;
+		pthread_mutex_unlock(&timer_lock);
+		return now;
+	}
+	return HOST_monotonicUs();
+}
+
+//Earliest armed timer, caller holds timer_lock
+static struct esp_timer* HOST_timerNext(void)
+{
+	struct esp_timer* best = NULL;
+	for (struct esp_timer* t = timers; t != NULL; t = t->next)
+	{
+		if (t->armed && (best == NULL || t->deadline_us < best->deadline_us))
+		{
+			best = t;
+		}
+	}
+	return best;
+}
+
+//Take a due timer off the schedule (or move a periodic one on), caller holds timer_lock
+static void HOST_timerFire(struct esp_timer* t)
+{
+	if (t->period_us > 0)
+	{
+		t->deadline_us += t->period_us;
+	}
+	else
+	{
+		t->armed = false;
+	}
+}
+
+//Runs callbacks one at a time, like the esp_timer task
+static void* HOST_timerThread(void* arg)
+{
+	pthread_mutex_lock(&timer_lock);
+	for (;;)
+	{
+		struct esp_timer* t = HOST_timerNext();
+		if (t == NULL)
+		{
+			pthread_cond_wait(&timer_cond, &timer_lock);
+			continue;
+		}
+
+		const int64_t now = HOST_monotonicUs();
+		if (t->deadline_us > now)
+		{
+			struct timespec ts = {.tv_sec = t->deadline_us / 1000000, .tv_nsec = (t->deadline_us % 1000000) * 1000};
+			pthread_cond_timedwait(&timer_cond, &timer_lock, &ts);
+			continue;
+		}
+
+		HOST_timerFire(t);
+		const esp_timer_cb_t cb = t->args.callback;
+		void* cb_arg = t->args.arg;
+		pthread_mutex_unlock(&timer_lock);
+		cb(cb_arg);
+		pthread_mutex_lock(&timer_lock);
+	}
+	return NULL;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* out)
+{
+	struct esp_timer* t = calloc(1, sizeof(*t));
+	if (t == NULL)
+	{
+		return ESP_ERR_NO_MEM;
+	}
+	t->args = *args;
+
+	pthread_mutex_lock(&timer_lock);
+	if (!manual && !thread_started)
+	{
+		pthread_condattr_t attr;
+		pthread_condattr_init(&attr);
+		pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+		pthread_cond_init(&timer_cond, &attr);
+		pthread_create(&timer_thread, NULL, HOST_timerThread, NULL);
+		pthread_detach(timer_thread);
+		thread_started = true;
+	}
+	t->next = timers;
+	timers = t;
+	pthread_mutex_unlock(&timer_lock);
+
+	*out = t;
+	return ESP_OK;
+}
+
+static esp_err_t HOST_timerStart(esp_timer_handle_t t, uint64_t timeout_us, uint64_t period_us)
+{
+	pthread_mutex_lock(&timer_lock);
+	if (t->armed)
+	{
+		pthread_mutex_unlock(&timer_lock);
+		return ESP_ERR_INVALID_STATE;
+	}
+	t->deadline_us = (manual ? manual_us : HOST_monotonicUs()) + (int64_t)timeout_us;
+	t->period_us = (int64_t)period_us;
+	t->armed = true;
+	if (thread_started)
+	{
+		pthread_cond_signal(&timer_cond);
+	}
+	pthread_mutex_unlock(&timer_lock);
+	return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+	return HOST_timerStart(timer, timeout_us, 0);
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period_us)
+{
+	return HOST_timerStart(timer, period_us, period_us);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+	esp_err_t ret = ESP_OK;
+
+	pthread_mutex_lock(&timer_lock);
+	if (!timer->armed)
+	{
+		ret = ESP_ERR_INVALID_STATE;
+	}
+	timer->armed = false;
+	pthread_mutex_unlock(&timer_lock);
+	return ret;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+	pthread_mutex_lock(&timer_lock);
+	if (timer->armed)
+	{
+		pthread_mutex_unlock(&timer_lock);
+		return ESP_ERR_INVALID_STATE;
+	}
+	for (struct esp_timer** p = &timers; *p != NULL; p = &(*p)->next)
+	{
+		if (*p == timer)
+		{
+			*p = timer->next;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&timer_lock);
+	free(timer);
+	return ESP_OK;
+}
+
+bool esp_timer_is_active(esp_timer_handle_t timer)
+{
+	pthread_mutex_lock(&timer_lock);
+	const bool armed = timer->armed;
+	pthread_mutex_unlock(&timer_lock);
+	return armed;
+}
+
+void HOST_clockSetManual(int64_t start_us)
+{
+	pthread_mutex_lock(&timer_lock);
+	manual = true;
+	manual_us = start_us;
+	pthread_mutex_unlock(&timer_lock);
+}
+
+void HOST_clockAdvance(int64_t us)
+{
+	pthread_mutex_lock(&timer_lock);
+	const int64_t target = manual_us + us;
+	for (;;)
+	{
+		struct esp_timer* t = HOST_timerNext();
+		if (t == NULL || t->deadline_us > target)
+		{
+			break;
+		}
+
+		//the callback sees the clock at its own deadline
+		if (t->deadline_us > manual_us)
+		{
+			manual_us = t->deadline_us;
+		}
+		HOST_timerFire(t);
+		const esp_timer_cb_t cb = t->args.callback;
+		void* cb_arg = t->args.arg;
+		pthread_mutex_unlock(&timer_lock);
+		cb(cb_arg);
+		pthread_mutex_lock(&timer_lock);
+	}
+	manual_us = target;
+	pthread_mutex_unlock(&timer_lock);
+}
+
+int HOST_timersArmed(void)
+{
+	int armed = 0;
+
+	pthread_mutex_lock(&timer_lock);
+	for (struct esp_timer* t = timers; t != NULL; t = t->next)
+	{
+		armed += t->armed;
+	}
+	pthread_mutex_unlock(&timer_lock);
+	return armed;
+}
@@ -0,0 +1,387 @@
+/**
+ * @file freertos_host.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief FreeRTOS tasks, notifications and queues on pthreads
+ *
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <unistd.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static pthread_mutex_t critical_lock;
+static pthread_once_t critical_once = PTHREAD_ONCE_INIT;
+
+static pthread_condattr_t cond_attr;
+static pthread_once_t cond_once = PTHREAD_ONCE_INIT;
+
+//task of the calling thread, threads not started by xTaskCreateStatic get one on first use
+static __thread StaticTask_t* current_task = NULL;
+
+static struct timespec boot_time;
+static pthread_once_t boot_once = PTHREAD_ONCE_INIT;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+static void HOST_criticalInit(void)
+{
+	pthread_mutexattr_t attr;
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&critical_lock, &attr);
+}
+
+void HOST_criticalEnter(void)
+{
+	pthread_once(&critical_once, HOST_criticalInit);
+	pthread_mutex_lock(&critical_lock);
+}
+
+void HOST_criticalExit(void)
+{
+	pthread_mutex_unlock(&critical_lock);
+}
+
+//Every wait is timed against CLOCK_MONOTONIC so a wall clock change never stretches it
+static void HOST_condInit(void)
+{
+	pthread_condattr_init(&cond_attr);
+	pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+}
+
+static void HOST_condCreate(pthread_cond_t* cond)
+{
+	pthread_once(&cond_once, HOST_condInit);
+	pthread_cond_init(cond, &cond_attr);
+}
+
+bool HOST_deadline(TickType_t ticks, struct timespec* ts)
+{
+	if (ticks == portMAX_DELAY)
+	{
+		return false;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, ts);
+	const uint64_t ns = (uint64_t)ticks * portTICK_PERIOD_MS * 1000000ULL + ts->tv_nsec;
+	ts->tv_sec += ns / 1000000000ULL;
+	ts->tv_nsec = ns % 1000000000ULL;
+	return true;
+}
+
+//Wait on cond until woken or the deadline passes, returns false on timeout
+static bool HOST_wait(pthread_cond_t* cond, pthread_mutex_t* lock, bool timed, const struct timespec* ts)
+{
+	if (!timed)
+	{
+		pthread_cond_wait(cond, lock);
+		return true;
+	}
+	return pthread_cond_timedwait(cond, lock, ts) != ETIMEDOUT;
+}
+
+/*
+ * Tasks
+ */
+
+static void HOST_taskInit(StaticTask_t* task, TaskFunction_t fn, const char* name, void* arg)
+{
+	memset(task, 0, sizeof(*task));
+	task->fn = fn;
+	task->arg = arg;
+	task->name = name;
+	pthread_mutex_init(&task->lock, NULL);
+	HOST_condCreate(&task->cond);
+}
+
+static void* HOST_taskEntry(void* arg)
+{
+	StaticTask_t* task = arg;
+	current_task = task;
+	task->fn(task->arg);
+	return NULL;
+}
+
+TaskHandle_t xTaskCreateStatic(TaskFunction_t fn, const char* name, uint32_t stack_depth, void* arg,
+	UBaseType_t priority, StackType_t* stack, StaticTask_t* task)
+{
+	pthread_attr_t attr;
+
+	HOST_taskInit(task, fn, name, arg);
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	//host frames are bigger than on target, never run a task on its target sized stack
+	if (pthread_create(&task->thread, &attr, HOST_taskEntry, task) != 0)
+	{
+		abort();
+	}
+	pthread_attr_destroy(&attr);
+	return task;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stack_depth, void* arg,
+	UBaseType_t priority, TaskHandle_t* created)
+{
+	StaticTask_t* task = malloc(sizeof(StaticTask_t));
+	if (task == NULL)
+	{
+		return pdFAIL;
+	}
+	xTaskCreateStatic(fn, name, stack_depth, arg, priority, NULL, task);
+	if (created != NULL)
+	{
+		*created = task;
+	}
+	return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+	//only self deletion is used
+	assert(task == NULL || task == current_task);
+	pthread_exit(NULL);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+	usleep((useconds_t)ticks * portTICK_PERIOD_MS * 1000);
+}
+
+static void HOST_bootInit(void)
+{
+	clock_gettime(CLOCK_MONOTONIC, &boot_time);
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+	struct timespec now;
+	pthread_once(&boot_once, HOST_bootInit);
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (TickType_t)((now.tv_sec - boot_time.tv_sec) * 1000 + (now.tv_nsec - boot_time.tv_nsec) / 1000000);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+	if (current_task == NULL)
+	{
+		current_task = malloc(sizeof(StaticTask_t));
+		HOST_taskInit(current_task, NULL, "host", NULL);
+		current_task->thread = pthread_self();
+	}
+	return current_task;
+}
+
+const char* pcTaskGetName(TaskHandle_t task)
+{
+	return (task != NULL) ? task->name : xTaskGetCurrentTaskHandle()->name;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task)
+{
+	return 0;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+	pthread_mutex_lock(&task->lock);
+	task->notify++;
+	pthread_cond_broadcast(&task->cond);
+	pthread_mutex_unlock(&task->lock);
+	return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* woken)
+{
+	xTaskNotifyGive(task);
+	if (woken != NULL)
+	{
+		*woken = pdTRUE;
+	}
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks)
+{
+	StaticTask_t* task = xTaskGetCurrentTaskHandle();
+	struct timespec ts;
+	const bool timed = HOST_deadline(ticks, &ts);
+	uint32_t value;
+
+	pthread_mutex_lock(&task->lock);
+	while (task->notify == 0 && ticks != 0)
+	{
+		if (!HOST_wait(&task->cond, &task->lock, timed, &ts))
+		{
+			break;
+		}
+	}
+	value = task->notify;
+	if (value > 0)
+	{
+		task->notify = clear ? 0 : value - 1;
+	}
+	pthread_mutex_unlock(&task->lock);
+	return value;
+}
+
+/*
+ * Queues and semaphores
+ */
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t item_size, uint8_t* storage, StaticQueue_t* queue)
+{
+	memset(queue, 0, sizeof(*queue));
+	pthread_mutex_init(&queue->lock, NULL);
+	HOST_condCreate(&queue->cond);
+	queue->storage = storage;
+	queue->item_size = item_size;
+	queue->length = length;
+	return queue;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+	StaticQueue_t* queue = malloc(sizeof(StaticQueue_t));
+	uint8_t* storage = (item_size > 0) ? malloc(length * item_size) : NULL;
+	if (queue == NULL || (item_size > 0 && storage == NULL))
+	{
+		free(queue);
+		free(storage);
+		return NULL;
+	}
+	xQueueCreateStatic(length, item_size, storage, queue);
+	queue->allocated = true;
+	return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+	pthread_mutex_destroy(&queue->lock);
+	pthread_cond_destroy(&queue->cond);
+	if (queue->allocated)
+	{
+		free(queue->storage);
+		free(queue);
+	}
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks)
+{
+	struct timespec ts;
+	const bool timed = HOST_deadline(ticks, &ts);
+
+	pthread_mutex_lock(&queue->lock);
+	while (queue->count == queue->length)
+	{
+		if (ticks == 0 || !HOST_wait(&queue->cond, &queue->lock, timed, &ts))
+		{
+			pthread_mutex_unlock(&queue->lock);
+			return pdFAIL;
+		}
+	}
+	if (queue->item_size > 0)
+	{
+		const UBaseType_t tail = (queue->head + queue->count) % queue->length;
+		memcpy(queue->storage + tail * queue->item_size, item, queue->item_size);
+	}
+	queue->count++;
+	pthread_cond_broadcast(&queue->cond);
+	pthread_mutex_unlock(&queue->lock);
+	return pdPASS;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void* item, BaseType_t* woken)
+{
+	if (woken != NULL)
+	{
+		*woken = pdFALSE;
+	}
+	return xQueueSend(queue, item, 0);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticks)
+{
+	struct timespec ts;
+	const bool timed = HOST_deadline(ticks, &ts);
+
+	pthread_mutex_lock(&queue->lock);
+	while (queue->count == 0)
+	{
+		if (ticks == 0 || !HOST_wait(&queue->cond, &queue->lock, timed, &ts))
+		{
+			pthread_mutex_unlock(&queue->lock);
+			return pdFAIL;
+		}
+	}
+	if (queue->item_size > 0)
+	{
+		memcpy(item, queue->storage + queue->head * queue->item_size, queue->item_size);
+	}
+	queue->head = (queue->head + 1) % queue->length;
+	queue->count--;
+	pthread_cond_broadcast(&queue->cond);
+	pthread_mutex_unlock(&queue->lock);
+	return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+	pthread_mutex_lock(&queue->lock);
+	const UBaseType_t count = queue->count;
+	pthread_mutex_unlock(&queue->lock);
+	return count;
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue)
+{
+	pthread_mutex_lock(&queue->lock);
+	const UBaseType_t spaces = queue->length - queue->count;
+	pthread_mutex_unlock(&queue->lock);
+	return spaces;
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue)
+{
+	pthread_mutex_lock(&queue->lock);
+	queue->head = 0;
+	queue->count = 0;
+	pthread_cond_broadcast(&queue->cond);
+	pthread_mutex_unlock(&queue->lock);
+	return pdPASS;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t* sem)
+{
+	return xQueueCreateStatic(1, 0, NULL, sem);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t* sem)
+{
+	//a mutex starts given, there is no priority inheritance on the host
+	xQueueCreateStatic(1, 0, NULL, sem);
+	sem->count = 1;
+	return sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateCountingStatic(UBaseType_t max, UBaseType_t initial, StaticSemaphore_t* sem)
+{
+	xQueueCreateStatic(max, 0, NULL, sem);
+	sem->count = initial;
+	return sem;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file gpio.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Host shim of the ESP-IDF GPIO driver
+ *
+ * Pins hold a level that the sources drive with gpio_set_level and tests drive
+ * with HOST_gpioSetInput (host_shim.h). A level change runs the pin's ISR
+ * handler in the calling thread when its interrupt is enabled and the new
+ * level matches the interrupt type.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define GPIO_NUM_MAX  49
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+typedef int gpio_num_t;
+
+typedef enum {
+	GPIO_MODE_DISABLE = 0,
+	GPIO_MODE_INPUT,
+	GPIO_MODE_OUTPUT,
+	GPIO_MODE_INPUT_OUTPUT,
+} gpio_mode_t;
+
+typedef enum {
+	GPIO_INTR_DISABLE = 0,
+	GPIO_INTR_POSEDGE,
+	GPIO_INTR_NEGEDGE,
+	GPIO_INTR_ANYEDGE,
+	GPIO_INTR_LOW_LEVEL,
+	GPIO_INTR_HIGH_LEVEL,
+} gpio_int_type_t;
+
+typedef struct {
+	uint64_t pin_bit_mask;
+	gpio_mode_t mode;
+	int pull_up_en;
+	int pull_down_en;
+	gpio_int_type_t intr_type;
+} gpio_config_t;
+
+typedef void (*gpio_isr_t)(void* arg);
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+esp_err_t gpio_config(const gpio_config_t* conf);
+esp_err_t gpio_set_level(gpio_num_t pin, uint32_t level);
+int gpio_get_level(gpio_num_t pin);
+esp_err_t gpio_set_intr_type(gpio_num_t pin, gpio_int_type_t type);
+esp_err_t gpio_intr_enable(gpio_num_t pin);
+esp_err_t gpio_intr_disable(gpio_num_t pin);
+esp_err_t gpio_install_isr_service(int flags);
+esp_err_t gpio_isr_handler_add(gpio_num_t pin, gpio_isr_t handler, void* arg);
+esp_err_t gpio_isr_handler_remove(gpio_num_t pin);
+esp_err_t gpio_wakeup_enable(gpio_num_t pin, gpio_int_type_t type);
+
+#ifdef __cplusplus
+}
+#endif
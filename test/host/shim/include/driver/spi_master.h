@@ -0,0 +1,109 @@
+/**
+ * @file spi_master.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Host shim of the ESP-IDF SPI master driver
+ *
+ * Covers bus setup and the device handle. Transactions are not sent by the
+ * shim: the display sources go through display_port.h, and the host build
+ * points LCD_PORT_HEADER at the emulator port, which reads the device clock
+ * from the handle.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define SPI_TRANS_USE_RXDATA  (1 << 2)
+#define SPI_TRANS_USE_TXDATA  (1 << 3)
+
+#define SPI_DMA_CH_AUTO       3
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+typedef enum {
+	SPI1_HOST = 0,
+	SPI2_HOST,
+	SPI3_HOST,
+	SPI_HOST_MAX,
+} spi_host_device_t;
+
+typedef struct spi_transaction_t spi_transaction_t;
+typedef void (*transaction_cb_t)(spi_transaction_t* t);
+
+struct spi_transaction_t {
+	uint32_t flags;
+	uint16_t cmd;
+	uint64_t addr;
+	size_t length;       //bits
+	size_t rxlength;
+	void* user;
+	union {
+		const void* tx_buffer;
+		uint8_t tx_data[4];
+	};
+	union {
+		void* rx_buffer;
+		uint8_t rx_data[4];
+	};
+};
+
+typedef struct {
+	int mosi_io_num;
+	int miso_io_num;
+	int sclk_io_num;
+	int quadwp_io_num;
+	int quadhd_io_num;
+	int max_transfer_sz;
+	uint32_t flags;
+} spi_bus_config_t;
+
+typedef struct {
+	uint8_t command_bits;
+	uint8_t address_bits;
+	uint8_t dummy_bits;
+	uint8_t mode;
+	int clock_speed_hz;
+	int spics_io_num;
+	uint32_t flags;
+	int queue_size;
+	transaction_cb_t pre_cb;
+	transaction_cb_t post_cb;
+} spi_device_interface_config_t;
+
+/* Attached device, keeps the configuration it was added with. */
+struct spi_device_t {
+	spi_host_device_t host;
+	spi_device_interface_config_t cfg;
+};
+
+typedef struct spi_device_t* spi_device_handle_t;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+esp_err_t spi_bus_initialize(spi_host_device_t host, const spi_bus_config_t* config, int dma_chan);
+esp_err_t spi_bus_free(spi_host_device_t host);
+esp_err_t spi_bus_add_device(spi_host_device_t host, const spi_device_interface_config_t* config, spi_device_handle_t* handle);
+esp_err_t spi_bus_remove_device(spi_device_handle_t handle);
+
+#ifdef __cplusplus
+}
+#endif
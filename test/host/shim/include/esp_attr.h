@@ -0,0 +1,14 @@
+/**
+ * @file esp_attr.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Host shim of the ESP-IDF placement attributes, only the alignment is kept
+ */
+
+#pragma once
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_DATA_ATTR
+#define DMA_ATTR            __attribute__((aligned(4)))
+#define WORD_ALIGNED_ATTR   __attribute__((aligned(4)))
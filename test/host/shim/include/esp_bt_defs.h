@@ -0,0 +1,22 @@
+/**
+ * @file esp_bt_defs.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Host shim of the Bluetooth address type
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#define ESP_BD_ADDR_LEN 6
+
+typedef uint8_t esp_bd_addr_t[ESP_BD_ADDR_LEN];
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,34 @@
+/**
+ * @file esp_gap_bt_api.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Host shim of the Classic GAP calls, the test linking it provides them
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "esp_err.h"
+#include "esp_bt_defs.h"
+
+typedef enum {
+	ESP_BT_NON_CONNECTABLE = 0,
+	ESP_BT_CONNECTABLE,
+} esp_bt_connection_mode_t;
+
+typedef enum {
+	ESP_BT_NON_DISCOVERABLE = 0,
+	ESP_BT_LIMITED_DISCOVERABLE,
+	ESP_BT_GENERAL_DISCOVERABLE,
+} esp_bt_discovery_mode_t;
+
+esp_err_t esp_bt_gap_set_scan_mode(esp_bt_connection_mode_t c_mode, esp_bt_discovery_mode_t d_mode);
+esp_err_t esp_bt_gap_get_bond_device_list(int* dev_num, esp_bd_addr_t* dev_list);
+esp_err_t esp_bt_gap_read_rssi_delta(esp_bd_addr_t remote_addr);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,21 @@
+/**
+ * @file esp_hidd_api.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Host shim of the Classic HID device calls, the test linking it provides them
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "esp_err.h"
+#include "esp_bt_defs.h"
+
+esp_err_t esp_bt_hid_device_connect(esp_bd_addr_t bd_addr);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,19 @@
+/**
+ * @file esp_log.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Host shim of the ESP-IDF logging macros, info and above go to stderr
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#define HOST_LOG(letter, tag, format, ...)  fprintf(stderr, letter " (%s) " format "\n", (tag), ##__VA_ARGS__)
+
+#define ESP_LOGE(tag, format, ...)  HOST_LOG("E", tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...)  HOST_LOG("W", tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...)  HOST_LOG("I", tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...)  ((void)(tag))
+#define ESP_LOGV(tag, format, ...)  ((void)(tag))
@@ -0,0 +1,12 @@
+/**
+ * @file esp_rom_crc.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Host shim of the ROM CRC, same polynomial and conventions as zlib crc32
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len);
@@ -0,0 +1,10 @@
+/**
+ * @file esp_system.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Host shim, included by the sources but nothing in it is used off target
+ */
+
+#pragma once
+
+#include "esp_err.h"
@@ -0,0 +1,60 @@
+/**
+ * @file esp_timer.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Host shim of esp_timer, on the monotonic clock or a manual test clock
+ *
+ * Callbacks run one at a time from a dispatch thread, like the esp_timer task.
+ * Once HOST_clockSetManual is called the clock only moves with HOST_clockAdvance,
+ * which runs every callback that falls due on the calling thread, in order.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+typedef void (*esp_timer_cb_t)(void* arg);
+
+typedef enum {
+	ESP_TIMER_TASK = 0,
+} esp_timer_dispatch_t;
+
+typedef struct {
+	esp_timer_cb_t callback;
+	void* arg;
+	esp_timer_dispatch_t dispatch_method;
+	const char* name;
+	bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+typedef struct esp_timer* esp_timer_handle_t;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+int64_t esp_timer_get_time(void);
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* out);
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us);
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period_us);
+esp_err_t esp_timer_stop(esp_timer_handle_t timer);
+esp_err_t esp_timer_delete(esp_timer_handle_t timer);
+bool esp_timer_is_active(esp_timer_handle_t timer);
+
+#ifdef __cplusplus
+}
+#endif
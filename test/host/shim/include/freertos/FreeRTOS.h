@@ -0,0 +1,124 @@
+/**
+ * @file FreeRTOS.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Host shim of the FreeRTOS kernel types, tasks and queues run on pthreads
+ *
+ * Only what the watch sources use. Ticks are milliseconds, priorities are
+ * ignored (every task is a thread) and critical sections share one recursive
+ * lock. Static objects really hold the state, so the sources keep allocating
+ * them the way they do on target.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <time.h>
+#include <pthread.h>
+#include "sdkconfig.h"
+#include "esp_attr.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define configTICK_RATE_HZ        1000
+#define configMINIMAL_STACK_SIZE  768
+#define portTICK_PERIOD_MS        (1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY             ((TickType_t)0xFFFFFFFF)
+#define pdMS_TO_TICKS(ms)         ((TickType_t)(ms) * configTICK_RATE_HZ / 1000)
+
+#define pdFALSE                   0
+#define pdTRUE                    1
+#define pdPASS                    pdTRUE
+#define pdFAIL                    pdFALSE
+
+#define portMUX_INITIALIZER_UNLOCKED  {0}
+
+#define portENTER_CRITICAL(mux)       ((void)(mux), HOST_criticalEnter())
+#define portEXIT_CRITICAL(mux)        ((void)(mux), HOST_criticalExit())
+#define portENTER_CRITICAL_ISR(mux)   ((void)(mux), HOST_criticalEnter())
+#define portEXIT_CRITICAL_ISR(mux)    ((void)(mux), HOST_criticalExit())
+#define taskENTER_CRITICAL(mux)       ((void)(mux), HOST_criticalEnter())
+#define taskEXIT_CRITICAL(mux)        ((void)(mux), HOST_criticalExit())
+#define portYIELD_FROM_ISR(...)       ((void)0)
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+typedef uint8_t StackType_t;  //bytes, same as the IDF port
+
+typedef struct {
+	int unused;
+} portMUX_TYPE;
+
+typedef void (*TaskFunction_t)(void* arg);
+
+/* Task control block, a thread with a notification counter. */
+typedef struct HOST_task {
+	pthread_t thread;
+	TaskFunction_t fn;
+	void* arg;
+	const char* name;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	uint32_t notify;
+} StaticTask_t;
+
+/* Queue, semaphores are queues of empty items like in the kernel. */
+typedef struct HOST_queue {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;      //broadcast on every send and receive
+	uint8_t* storage;
+	size_t item_size;
+	UBaseType_t length;
+	UBaseType_t head;
+	UBaseType_t count;
+	bool allocated;           //storage came from malloc
+} StaticQueue_t;
+
+typedef StaticQueue_t StaticSemaphore_t;
+
+typedef StaticTask_t* TaskHandle_t;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+/** @brief Enter the shared critical section (recursive)
+ *
+ *  @return Void.
+ */
+void HOST_criticalEnter(void);
+
+/** @brief Leave the shared critical section
+ *
+ *  @return Void.
+ */
+void HOST_criticalExit(void);
+
+/** @brief Absolute CLOCK_MONOTONIC deadline for a blocking call
+ *
+ *  @param ticks Timeout in ticks, portMAX_DELAY for none
+ *  @param ts Filled with the deadline
+ *  @return false when the call may block forever.
+ */
+bool HOST_deadline(TickType_t ticks, struct timespec* ts);
+
+#ifdef __cplusplus
+}
+#endif
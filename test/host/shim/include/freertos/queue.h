@@ -0,0 +1,44 @@
+/**
+ * @file queue.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Host shim of the FreeRTOS queue API
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include "freertos/FreeRTOS.h"
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+typedef StaticQueue_t* QueueHandle_t;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t item_size, uint8_t* storage, StaticQueue_t* queue);
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size);
+void vQueueDelete(QueueHandle_t queue);
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks);
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void* item, BaseType_t* woken);
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticks);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue);
+BaseType_t xQueueReset(QueueHandle_t queue);
+
+#define xQueueSendToBack(queue, item, ticks)  xQueueSend((queue), (item), (ticks))
+
+#ifdef __cplusplus
+}
+#endif
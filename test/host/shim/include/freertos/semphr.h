@@ -0,0 +1,42 @@
+/**
+ * @file semphr.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Host shim of the FreeRTOS semaphore API, built on the queue shim
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include "freertos/queue.h"
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+typedef QueueHandle_t SemaphoreHandle_t;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t* sem);
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t* sem);
+SemaphoreHandle_t xSemaphoreCreateCountingStatic(UBaseType_t max, UBaseType_t initial, StaticSemaphore_t* sem);
+
+#define xSemaphoreCreateBinary()               xQueueCreate(1, 0)
+#define xSemaphoreTake(sem, ticks)             xQueueReceive((sem), NULL, (ticks))
+#define xSemaphoreGive(sem)                    xQueueSend((sem), NULL, 0)
+#define xSemaphoreGiveFromISR(sem, woken)      xQueueSendFromISR((sem), NULL, (woken))
+#define vSemaphoreDelete(sem)                  vQueueDelete(sem)
+
+#ifdef __cplusplus
+}
+#endif
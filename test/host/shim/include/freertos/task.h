@@ -0,0 +1,41 @@
+/**
+ * @file task.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Host shim of the FreeRTOS task API
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include "freertos/FreeRTOS.h"
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+TaskHandle_t xTaskCreateStatic(TaskFunction_t fn, const char* name, uint32_t stack_depth, void* arg,
+	UBaseType_t priority, StackType_t* stack, StaticTask_t* task);
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stack_depth, void* arg,
+	UBaseType_t priority, TaskHandle_t* created);
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount(void);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+const char* pcTaskGetName(TaskHandle_t task);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* woken);
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks);
+
+#ifdef __cplusplus
+}
+#endif
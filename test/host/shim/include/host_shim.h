@@ -0,0 +1,71 @@
+/**
+ * @file host_shim.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Test controls of the host shims (clock, pins, bus)
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************************
+ *  Includes
+ ***********************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "driver/gpio.h"
+#include "driver/spi_master.h"
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+/** @brief Stop the esp_timer clock, from here on it only moves with HOST_clockAdvance
+ *
+ *  Call before anything creates a timer.
+ *
+ *  @param start_us Clock value to start from
+ *  @return Void.
+ */
+void HOST_clockSetManual(int64_t start_us);
+
+/** @brief Move the manual clock forward
+ *
+ *  Timers falling due are run in deadline order on the calling thread, each
+ *  with the clock set to its deadline.
+ *
+ *  @param us Microseconds to advance
+ *  @return Void.
+ */
+void HOST_clockAdvance(int64_t us);
+
+/** @brief Number of timers currently armed
+ *
+ *  @return Armed timers.
+ */
+int HOST_timersArmed(void);
+
+/** @brief Drive an input pin
+ *
+ *  Runs the pin ISR handler when the change matches the interrupt type.
+ *
+ *  @param pin GPIO number
+ *  @param level New level
+ *  @return Void.
+ */
+void HOST_gpioSetInput(gpio_num_t pin, int level);
+
+/** @brief Device attached to a bus
+ *
+ *  @param host SPI host
+ *  @return The last device added to host, NULL if none.
+ */
+spi_device_handle_t HOST_spiDevice(spi_host_device_t host);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,34 @@
+/**
+ * @file nvs.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Host shim of the NVS blob calls, the test linking it provides them
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+#define ESP_ERR_NVS_NOT_FOUND  0x1102
+
+typedef uint32_t nvs_handle_t;
+
+typedef enum {
+	NVS_READONLY = 0,
+	NVS_READWRITE,
+} nvs_open_mode_t;
+
+esp_err_t nvs_open(const char* name, nvs_open_mode_t open_mode, nvs_handle_t* out_handle);
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char* key, void* out_value, size_t* length);
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char* key, const void* value, size_t length);
+esp_err_t nvs_commit(nvs_handle_t handle);
+
+#ifdef __cplusplus
+}
+#endif
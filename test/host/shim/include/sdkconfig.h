@@ -0,0 +1,10 @@
+/**
+ * @file sdkconfig.h
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Host build configuration, mirrors the sdkconfig.defaults options the sources test
+ */
+
+#pragma once
+
+#define CONFIG_FREERTOS_HZ          1000
@@ -0,0 +1,275 @@
+/**
+ * @file test_anim.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Scroll transitions against the ST7735S model
+ *
+ * Plays the icon carousel and clock transitions in real time through the
+ * widget layer and the animation task, then checks that the glass ends up
+ * exactly as a plain redraw leaves it, with the controller back in normal
+ * mode. The done callback stands in for the dispatcher: the test thread
+ * flushes once it fires, the animation task never does. The pixel data each
+ * transition sent is compared against redrawing
+ * the whole region every frame, and reported next to a plain redraw (which
+ * for the clock only sends the changed digit) with the frame pacing counters.
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <string.h>
+#include "display_main.h"
+#include "display_bus.h"
+#include "display_fb.h"
+#include "display_anim.h"
+#include "display_ui.h"
+#include "display_assets.h"
+#include "lcd_port_emu.h"
+#include "host_test.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define BACKGROUND     0x7D7D
+#define SETTLE_MS      (ANIM_DEFAULT_MS + 300)  //transition and its done callback
+#define REGION_MAX     (WIDTH * 48)
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static spi_device_handle_t spi;
+static LCD_palette_t clock_palette;
+static int clock_widget;
+static int icon_widget;
+
+static atomic_int finished;            //done callbacks
+static uint16_t reference[REGION_MAX];
+static uint16_t shown[REGION_MAX];
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+//What the glass shows inside a widget
+static void snapshot(int id, uint16_t* out)
+{
+	const FB_rect_t r = UI_getBounds(id);
+	assert(r.w * r.h <= REGION_MAX);
+
+	EMU_st7735s_t* emu = LCD_emuLock();
+	for (int j = 0; j < r.h; j++)
+	{
+		for (int i = 0; i < r.w; i++)
+		{
+			*out++ = EMU_viewPixel(emu, r.x + i, r.y + j);
+		}
+	}
+	LCD_emuUnlock();
+}
+
+static bool regionMatches(int id)
+{
+	const FB_rect_t r = UI_getBounds(id);
+	snapshot(id, shown);
+	return memcmp(shown, reference, r.w * r.h * sizeof(uint16_t)) == 0;
+}
+
+static void checkNormalMode(void)
+{
+	EMU_st7735s_t* emu = LCD_emuLock();
+	CHECK(!emu->scroll);
+	CHECK_EQ(emu->unknown_cmds, 0);
+	CHECK_EQ(emu->bad_params, 0);
+	CHECK_EQ(emu->bad_pixels, 0);
+	LCD_emuUnlock();
+}
+
+//Pixel bytes of one plain (untransitioned) update, and the reference it leaves on the glass
+static uint32_t plainIcon(int from, int to)
+{
+	EMU_counters_t c;
+
+	UI_setIcon(icon_widget, from, UI_TRANSITION_NONE);
+	UI_commit();
+	LCD_emuFrameEnd(NULL);
+	UI_setIcon(icon_widget, to, UI_TRANSITION_NONE);
+	UI_commit();
+	LCD_emuFrameEnd(&c);
+	snapshot(icon_widget, reference);
+	UI_setIcon(icon_widget, from, UI_TRANSITION_NONE);
+	UI_commit();
+	return c.pixel_bytes;
+}
+
+static uint32_t plainClock(int from, int to)
+{
+	EMU_counters_t c;
+
+	UI_setTime(clock_widget, 12, from, UI_TRANSITION_NONE);
+	UI_commit();
+	LCD_emuFrameEnd(NULL);
+	UI_setTime(clock_widget, 12, to, UI_TRANSITION_NONE);
+	UI_commit();
+	LCD_emuFrameEnd(&c);
+	snapshot(clock_widget, reference);
+	UI_setTime(clock_widget, 12, from, UI_TRANSITION_NONE);
+	UI_commit();
+	return c.pixel_bytes;
+}
+
+//Runs in the animation task, the flush is left to the test thread like to the dispatcher
+static void onDone(void* arg)
+{
+	atomic_fetch_add(&finished, 1);
+}
+
+//Counters of one transition, started by set and given time to finish
+static ANIM_stats_t played(const ANIM_stats_t* before, EMU_counters_t* bus)
+{
+	ANIM_stats_t after;
+	const int done = atomic_load(&finished);
+
+	vTaskDelay(pdMS_TO_TICKS(SETTLE_MS));
+	CHECK_EQ(atomic_load(&finished), done + 1);
+	FB_flush();
+	LCD_emuFrameEnd(bus);
+	ANIM_getStats(&after);
+
+	after.transitions -= before->transitions;
+	after.rejected -= before->rejected;
+	after.frames -= before->frames;
+	after.dropped -= before->dropped;
+	after.bytes -= before->bytes;
+	after.redraw_bytes -= before->redraw_bytes;
+	return after;
+}
+
+static void report(const char* name, const ANIM_stats_t* s, const EMU_counters_t* bus, uint32_t plain)
+{
+	HOST_report("%-12s frames %2u  dropped %u  max frame %5u us  sent %6u  redraw every frame %6u (%3.0f%%)  plain %6u  bus pixel bytes %6u",
+		name, s->frames, s->dropped, s->max_frame_us, s->bytes, s->redraw_bytes,
+		100.0 * s->bytes / (s->redraw_bytes ? s->redraw_bytes : 1), plain, bus->pixel_bytes);
+}
+
+//Transition counters every run has to meet
+static void checkTransition(const ANIM_stats_t* s, const EMU_counters_t* bus)
+{
+	const int frames = ANIM_DEFAULT_MS * ANIM_DEFAULT_FPS / 1000;
+
+	CHECK_EQ(s->transitions, 1);
+	CHECK_EQ(s->rejected, 0);
+	//every tick is either a frame or a drop, a drop skips a frame ahead (the last one may overshoot)
+	CHECK(s->frames + s->dropped >= frames);
+	CHECK(s->frames <= frames);
+	//newly exposed rows only, each row of the region about once over the whole transition
+	const uint32_t region = s->redraw_bytes / (s->frames ? s->frames : 1);
+	CHECK(s->bytes <= region + region / 4);
+	CHECK(s->bytes * 3 <= s->redraw_bytes);
+	CHECK(bus->pixel_bytes >= s->bytes);
+}
+
+static void testIconCarousel(void)
+{
+	static const struct {
+		int from;
+		int to;
+		UI_transition_t dir;
+		const char* name;
+	} steps[] = {
+		{0, 1, UI_TRANSITION_UP, "icon up"},
+		{1, 2, UI_TRANSITION_UP, "icon up"},
+		{2, 1, UI_TRANSITION_DOWN, "icon down"},
+	};
+
+	for (int i = 0; i < (int)(sizeof(steps) / sizeof(steps[0])); i++)
+	{
+		const uint32_t plain = plainIcon(steps[i].from, steps[i].to);
+		ANIM_stats_t before;
+		EMU_counters_t bus;
+
+		LCD_emuFrameEnd(NULL);
+		ANIM_getStats(&before);
+		UI_setIcon(icon_widget, steps[i].to, steps[i].dir);
+		UI_commit();
+		const ANIM_stats_t s = played(&before, &bus);
+
+		report(steps[i].name, &s, &bus, plain);
+		checkTransition(&s, &bus);
+		CHECK(regionMatches(icon_widget));
+		checkNormalMode();
+	}
+}
+
+static void testClock(void)
+{
+	const uint32_t plain = plainClock(34, 35);
+	ANIM_stats_t before;
+	EMU_counters_t bus;
+
+	LCD_emuFrameEnd(NULL);
+	ANIM_getStats(&before);
+	UI_setTime(clock_widget, 12, 35, UI_TRANSITION_UP);
+	UI_commit();
+	const ANIM_stats_t s = played(&before, &bus);
+
+	report("clock", &s, &bus, plain);
+	checkTransition(&s, &bus);
+	CHECK(regionMatches(clock_widget));
+	checkNormalMode();
+}
+
+//A change while a transition runs falls back to a plain redraw of the latest content
+static void testBusy(void)
+{
+	ANIM_stats_t before;
+	EMU_counters_t bus;
+
+	plainIcon(1, 0);
+	ANIM_getStats(&before);
+	UI_setIcon(icon_widget, 2, UI_TRANSITION_UP);
+	UI_commit();
+	UI_setIcon(icon_widget, 0, UI_TRANSITION_UP);
+	UI_commit();
+	const ANIM_stats_t s = played(&before, &bus);
+
+	HOST_report("%-12s transitions %u  rejected %u", "busy", s.transitions, s.rejected);
+	CHECK_EQ(s.transitions, 1);
+	CHECK_EQ(s.rejected, 1);
+	CHECK(regionMatches(icon_widget));
+	checkNormalMode();
+}
+
+int main(void)
+{
+	LCD_emuInit();
+	CHECK_EQ(LCD_busInit(&spi, LCD_BUS_DEFAULT_HZ), ESP_OK);
+	LCD_init(spi);
+
+	//vsync is never started, so the flush does not pace itself
+	FB_init(spi, BACKGROUND);
+	CHECK_EQ(ANIM_init(ANIM_DEFAULT_FPS, onDone, NULL), ESP_OK);
+	UI_init(0, BACKGROUND);
+
+	static const UI_layout_t clock_layout = {UI_ALIGN_LEFT, 11, 44};
+	static const UI_layout_t icon_layout = {UI_ALIGN_CENTER, 0, 92};
+	LCD_paletteInit(&clock_palette, clock_palette_colors, glyph_display_numbers[0].bpp);
+	clock_widget = UI_addClock(&clock_layout, glyph_display_numbers, &glyph_semi_colon, &clock_palette);
+	icon_widget = UI_addIcon(&icon_layout, rle_media_icons, MEDIA_ICONS_COUNT);
+
+	UI_setTime(clock_widget, 12, 34, UI_TRANSITION_NONE);
+	UI_setIcon(icon_widget, 0, UI_TRANSITION_NONE);
+	UI_commit();
+	checkNormalMode();
+
+	testIconCarousel();
+	testClock();
+	testBusy();
+
+	CHECK_EQ(LCD_emuDump(HOST_FRAME_DIR "/anim_end.png"), 0);
+	return HOST_testDone("test_anim");
+}
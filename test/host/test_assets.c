@@ -0,0 +1,154 @@
+/**
+ * @file test_assets.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Every generated RLE asset through the firmware decoder
+ *
+ * Each frame of each asset is decoded with LCD_rleDecode at several output
+ * buffer sizes (so packets are split at every kind of boundary) and compared
+ * byte for byte with the raw RGB565 frame read from the PNG source. One frame
+ * of each asset is also streamed to the emulator with LCD_sendRleFrame and
+ * read back from the glass.
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <string.h>
+#include "display_main.h"
+#include "display_bus.h"
+#include "display_rle.h"
+#include "display_assets_raw.h"
+#include "lcd_port_emu.h"
+#include "host_test.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define FRAME_MAX    DISPLAY_NUMBERS_SIZE   //largest decoded frame
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+typedef struct {
+	const char* name;
+	const LCD_rle_asset_t* frames;
+	const uint8_t* raw;
+	int count;
+	int size;        //decoded bytes per frame
+} asset_t;
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static spi_device_handle_t spi;
+static uint8_t decoded[FRAME_MAX + RLE_TX_SIZE];
+
+static const asset_t assets[] = {
+	{"display_numbers", rle_display_numbers, raw_display_numbers[0], DISPLAY_NUMBERS_COUNT, DISPLAY_NUMBERS_SIZE},
+	{"semi_colon", &rle_semi_colon, raw_semi_colon, SEMI_COLON_COUNT, SEMI_COLON_SIZE},
+	{"media_icons", rle_media_icons, raw_media_icons[0], MEDIA_ICONS_COUNT, MEDIA_ICONS_SIZE},
+};
+
+//odd sizes only fit whole pixels, so runs and literals split mid packet
+static const int chunk_sizes[] = {PIXEL_SIZE, 7, 64, 255, RLE_TX_SIZE};
+
+_Static_assert(SEMI_COLON_SIZE <= FRAME_MAX && MEDIA_ICONS_SIZE <= FRAME_MAX, "decode buffer too small");
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+//Decode a frame max_bytes at a time, returns the decoded length
+static int decodeAll(const LCD_rle_asset_t* frame, int max_bytes)
+{
+	LCD_rle_decoder_t dec;
+	int total = 0;
+	int n;
+
+	LCD_rleDecoderInit(&dec, frame);
+	while ((n = LCD_rleDecode(&dec, decoded + total, max_bytes)) > 0)
+	{
+		CHECK_EQ(n % PIXEL_SIZE, 0);
+		CHECK(n <= max_bytes);
+		total += n;
+		if (total > FRAME_MAX)
+		{
+			break;
+		}
+	}
+	//exhausted decoders stay exhausted
+	CHECK_EQ(LCD_rleDecode(&dec, decoded + total, max_bytes), 0);
+	return total;
+}
+
+static bool glassMatches(const LCD_rle_asset_t* frame, const uint8_t* raw)
+{
+	bool ok = true;
+
+	EMU_st7735s_t* emu = LCD_emuLock();
+	for (int i = 0; i < frame->width * frame->height && ok; i++)
+	{
+		const uint16_t px = (raw[i * PIXEL_SIZE] << 8) | raw[i * PIXEL_SIZE + 1];
+		ok = (EMU_viewPixel(emu, i % frame->width, i / frame->width) == px);
+	}
+	LCD_emuUnlock();
+	return ok;
+}
+
+static void testAsset(const asset_t* a)
+{
+	int compressed = 0;
+	int mismatched = 0;
+
+	for (int k = 0; k < a->count; k++)
+	{
+		const LCD_rle_asset_t* frame = &a->frames[k];
+		const uint8_t* raw = a->raw + k * a->size;
+
+		CHECK_EQ(frame->width * frame->height * PIXEL_SIZE, a->size);
+		compressed += frame->size;
+		for (int c = 0; c < (int)(sizeof(chunk_sizes) / sizeof(chunk_sizes[0])); c++)
+		{
+			memset(decoded, 0xA5, sizeof(decoded));
+			const int len = decodeAll(frame, chunk_sizes[c]);
+			CHECK_EQ(len, a->size);
+			mismatched += (len != a->size || memcmp(decoded, raw, a->size) != 0);
+		}
+	}
+	CHECK_EQ(mismatched, 0);
+
+	//last frame end to end, top left corner of the glass
+	const LCD_rle_asset_t* last = &a->frames[a->count - 1];
+	LCD_setDrawingWindow(spi, X_OFFSET, Y_OFFSET, last->width - 1, last->height - 1);
+	LCD_sendRleFrame(spi, last);
+	CHECK(glassMatches(last, a->raw + (a->count - 1) * a->size));
+
+	HOST_report("%-16s %d frame%s %dx%d  raw %6d  rle %6d (%3.0f%%)  mismatched %d",
+		a->name, a->count, (a->count > 1) ? "s" : " ", a->frames[0].width, a->frames[0].height,
+		a->count * a->size, compressed, 100.0 * compressed / (a->count * a->size), mismatched);
+}
+
+int main(void)
+{
+	LCD_emuInit();
+	CHECK_EQ(LCD_busInit(&spi, LCD_BUS_DEFAULT_HZ), ESP_OK);
+	LCD_init(spi);
+
+	for (int i = 0; i < (int)(sizeof(assets) / sizeof(assets[0])); i++)
+	{
+		testAsset(&assets[i]);
+	}
+
+	EMU_st7735s_t* emu = LCD_emuLock();
+	CHECK_EQ(emu->unknown_cmds, 0);
+	CHECK_EQ(emu->bad_params, 0);
+	CHECK_EQ(emu->bad_pixels, 0);
+	LCD_emuUnlock();
+
+	return HOST_testDone("test_assets");
+}
@@ -0,0 +1,231 @@
+/**
+ * @file test_bus.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief SPI clock calibration against the ST7735S model, app bus counters
+ *
+ * The model is given a clock limit above which it stores corrupted pixels,
+ * LCD_busCalibrate with the port's verify hook has to settle on that limit.
+ *
+ * The app bus dispatcher is then fed from this thread and from its own
+ * handlers, and held up by a slow handler until the queue overflows. The
+ * per type counters have to account for every post: handoffs from other
+ * tasks, drops, queue depth, latency and handler time.
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <stdatomic.h>
+#include "display_main.h"
+#include "display_bus.h"
+#include "display_port.h"
+#include "app_bus.h"
+#include "freertos/semphr.h"
+#include "host_shim.h"
+#include "host_test.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define TICKS         10
+#define OVERFLOW      5       //posts beyond a full queue
+#define HOLD_MS       20      //slow handler holds the dispatcher this long
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static spi_device_handle_t spi;
+
+static atomic_int media_count;
+static atomic_int icon_count;
+static atomic_bool panel_busy;
+static SemaphoreHandle_t panel_release;
+static StaticSemaphore_t panel_release_buf;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+static void setLimit(int hz)
+{
+	EMU_st7735s_t* emu = LCD_emuLock();
+	emu->max_clock_hz = hz;
+	LCD_emuUnlock();
+}
+
+static void checkNoErrors(void)
+{
+	EMU_st7735s_t* emu = LCD_emuLock();
+	CHECK_EQ(emu->unknown_cmds, 0);
+	CHECK_EQ(emu->bad_params, 0);
+	CHECK_EQ(emu->bad_pixels, 0);
+	LCD_emuUnlock();
+}
+
+static void calibrate(const char* name, int limit_hz, int expected_hz)
+{
+	EMU_counters_t c;
+
+	CHECK_EQ(LCD_busSetClock(&spi, LCD_BUS_DEFAULT_HZ), ESP_OK);
+	setLimit(limit_hz);
+	LCD_emuFrameEnd(NULL);
+
+	CHECK_EQ(LCD_busCalibrate(&spi, LCD_PORT_VERIFY, NULL), ESP_OK);
+	LCD_emuFrameEnd(&c);
+	HOST_report("%-9s limit %8d Hz  settled %8d Hz  %u pattern bytes", name, limit_hz, LCD_busGetClock(), c.pixel_bytes);
+
+	CHECK_EQ(LCD_busGetClock(), expected_hz);
+	//the handle was replaced, the caller's copy has to be the attached one
+	CHECK(spi == HOST_spiDevice(HOST_DEVICE));
+	CHECK_EQ(spi->cfg.clock_speed_hz, expected_hz);
+	checkNoErrors();
+}
+
+//A tick leads to a media message posted from the dispatcher itself
+static void onTick(const BUS_msg_t* msg, void* arg)
+{
+	const BUS_msg_t media = {.type = BUS_MSG_MEDIA};
+	BUS_post(&media);
+}
+
+static void onMedia(const BUS_msg_t* msg, void* arg)
+{
+	atomic_fetch_add(&media_count, 1);
+}
+
+static void onIcon(const BUS_msg_t* msg, void* arg)
+{
+	atomic_fetch_add(&icon_count, 1);
+}
+
+//Holds the dispatcher until released
+static void onPanel(const BUS_msg_t* msg, void* arg)
+{
+	atomic_store(&panel_busy, true);
+	xSemaphoreTake(panel_release, portMAX_DELAY);
+}
+
+static void waitFor(atomic_int* count, int n)
+{
+	for (int i = 0; i < 1000 && atomic_load(count) < n; i++)
+	{
+		vTaskDelay(1);
+	}
+}
+
+static void testBusStats(void)
+{
+	const BUS_msg_t tick = {.type = BUS_MSG_CLOCK_TICK};
+	const BUS_msg_t icon = {.type = BUS_MSG_ICON};
+	const BUS_msg_t panel = {.type = BUS_MSG_PANEL};
+	BUS_stats_t s;
+	int accepted = 0;
+	int refused = 0;
+
+	panel_release = xSemaphoreCreateBinaryStatic(&panel_release_buf);
+	CHECK_EQ(BUS_init(), ESP_OK);
+	CHECK_EQ(BUS_subscribe(BUS_MSG_CLOCK_TICK, onTick, NULL), ESP_OK);
+	CHECK_EQ(BUS_subscribe(BUS_MSG_MEDIA, onMedia, NULL), ESP_OK);
+	CHECK_EQ(BUS_subscribe(BUS_MSG_ICON, onIcon, NULL), ESP_OK);
+	CHECK_EQ(BUS_subscribe(BUS_MSG_PANEL, onPanel, NULL), ESP_OK);
+
+	//ticks are handed off from here, the media posts they cause are not
+	for (int i = 0; i < TICKS; i++)
+	{
+		CHECK_EQ(BUS_post(&tick), ESP_OK);
+	}
+	waitFor(&media_count, TICKS);
+
+	//hold the dispatcher and overflow the queue behind it
+	CHECK_EQ(BUS_post(&panel), ESP_OK);
+	for (int i = 0; i < 1000 && !atomic_load(&panel_busy); i++)
+	{
+		vTaskDelay(1);
+	}
+	for (int i = 0; i < BUS_DEPTH + OVERFLOW; i++)
+	{
+		const esp_err_t ret = BUS_post(&icon);
+		accepted += (ret == ESP_OK);
+		refused += (ret == ESP_ERR_NO_MEM);
+	}
+	vTaskDelay(pdMS_TO_TICKS(HOLD_MS));
+	xSemaphoreGive(panel_release);
+	waitFor(&icon_count, BUS_DEPTH);
+
+	BUS_getStats(&s);
+	const BUS_type_stats_t* t = &s.types[BUS_MSG_CLOCK_TICK];
+	const BUS_type_stats_t* m = &s.types[BUS_MSG_MEDIA];
+	const BUS_type_stats_t* i = &s.types[BUS_MSG_ICON];
+	const BUS_type_stats_t* p = &s.types[BUS_MSG_PANEL];
+	HOST_report("bus: %u wakeups, depth max %u, dropped %u, latency max %lld us, handler max %lld us",
+		s.wakeups, s.depth_max, s.dropped, (long long)s.latency_max_us, (long long)s.handler_max_us);
+	HOST_report("bus tick   posted %2u  handoffs %2u  dispatched %2u", t->posted, t->handoffs, t->dispatched);
+	HOST_report("bus media  posted %2u  handoffs %2u  dispatched %2u", m->posted, m->handoffs, m->dispatched);
+	HOST_report("bus icon   posted %2u  handoffs %2u  dispatched %2u  dropped %u  depth max %u  latency max %lld us",
+		i->posted, i->handoffs, i->dispatched, i->dropped, i->depth_max, (long long)i->latency_max_us);
+
+	CHECK_EQ(atomic_load(&media_count), TICKS);
+	CHECK_EQ(t->posted, TICKS);
+	CHECK_EQ(t->handoffs, TICKS);
+	CHECK_EQ(t->dispatched, TICKS);
+	CHECK_EQ(m->posted, TICKS);
+	CHECK_EQ(m->handoffs, 0);
+	CHECK_EQ(m->dispatched, TICKS);
+
+	CHECK_EQ(accepted, BUS_DEPTH);
+	CHECK_EQ(refused, OVERFLOW);
+	CHECK_EQ(atomic_load(&icon_count), BUS_DEPTH);
+	CHECK_EQ(i->posted, BUS_DEPTH);
+	CHECK_EQ(i->handoffs, BUS_DEPTH);
+	CHECK_EQ(i->dispatched, BUS_DEPTH);
+	CHECK_EQ(i->dropped, OVERFLOW);
+	CHECK_EQ(i->depth_max, BUS_DEPTH - 1);
+	CHECK(i->latency_max_us >= HOLD_MS * 1000);
+	CHECK(p->handler_max_us >= HOLD_MS * 1000);
+	CHECK_EQ(p->dropped + t->dropped + m->dropped, 0);
+
+	CHECK_EQ(s.dropped, OVERFLOW);
+	CHECK(s.depth_max <= BUS_DEPTH);
+	//handoffs coalesce, a batch of posts wakes the dispatcher once
+	CHECK(s.wakeups >= 1);
+	CHECK(s.wakeups <= t->handoffs + p->handoffs + i->handoffs);
+	CHECK_EQ(s.handler_max_us, p->handler_max_us);
+}
+
+int main(void)
+{
+	LCD_emuInit();
+	CHECK_EQ(LCD_busInit(&spi, LCD_BUS_DEFAULT_HZ), ESP_OK);
+	LCD_init(spi);
+	LCD_emuFrameEnd(NULL);
+
+	//without a hook nothing is sent and the clock stays
+	CHECK_EQ(LCD_busCalibrate(&spi, NULL, NULL), ESP_ERR_NOT_SUPPORTED);
+	CHECK_EQ(LCD_busGetClock(), LCD_BUS_DEFAULT_HZ);
+	{
+		EMU_counters_t c;
+		LCD_emuFrameEnd(&c);
+		CHECK_EQ(c.bytes, 0);
+	}
+
+	calibrate("limited", 13000000, 13000000);
+	calibrate("marginal", 10500000, LCD_BUS_DEFAULT_HZ);
+	calibrate("unlimited", 0, LCD_BUS_MAX_HZ);
+
+	//pixels sent at the calibrated clock land intact
+	setLimit(13000000);
+	CHECK_EQ(LCD_busSetClock(&spi, 13000000), ESP_OK);
+	LCD_fillRect(spi, X_OFFSET, Y_OFFSET, WIDTH, HEIGHT, 0x1234);
+	{
+		EMU_st7735s_t* emu = LCD_emuLock();
+		CHECK_EQ(EMU_viewPixel(emu, 64, 64), 0x1234);
+		LCD_emuUnlock();
+	}
+
+	testBusStats();
+	return HOST_testDone("test_bus");
+}
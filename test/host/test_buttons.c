@@ -0,0 +1,351 @@
+/**
+ * @file test_buttons.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Bounce trace replay through the button debouncer and gesture machine
+ *
+ * Presses with randomized contact bounce are played into the pins on a manual
+ * clock. The ISR runs on each pin change, and the queue is drained through
+ * BUTTON_handle (BUTTON_onEdge / BUTTON_onDeadline) after every clock step,
+ * the way the button task would. Every gesture is checked against the one the
+ * trace was written to produce, and the latency from the physical edge the
+ * gesture belongs to is reported. A short press and a held press are then
+ * run through BUTTON_acts: once per press for plain actions, on every repeat
+ * for volume.
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <stdlib.h>
+#include "host_shim.h"
+#include "host_test.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+//the test drains the edge queue itself, no button task
+#define xTaskCreateStatic(fn, name, depth, arg, prio, stack, buf)  ((void)(fn), (void)(stack), (void)(buf), (TaskHandle_t)NULL)
+#include "buttons.c"
+#undef xTaskCreateStatic
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define PIN_PLAIN      25      //reports short presses right away
+#define PIN_DOUBLE     26      //waits for a second press
+#define STEP_US        50      //clock step between queue drains
+#define BOUNCE_MAX_US  4000    //contact bounce after each edge
+#define TRACE_MAX      2048
+#define GESTURE_MAX    256
+#define RUNS           10
+#define TIME_SLACK_US  STEP_US
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+typedef struct {
+	int64_t t_us;
+	int pin;
+	int level;
+} trace_edge_t;
+
+typedef struct {
+	int gpio;
+	BUTTON_gesture_t gesture;
+	int64_t edge_us;       //debounced edge or deadline the gesture belongs to
+	int64_t delivered_us;  //callback time
+} gesture_t;
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static trace_edge_t trace[TRACE_MAX];
+static int trace_count;
+
+static gesture_t expected[GESTURE_MAX];
+static int expected_count;
+static gesture_t seen[GESTURE_MAX];
+static int seen_count;
+
+static int64_t now_us;
+static uint32_t seed;
+
+static const char* gesture_names[] = {"short", "long", "double", "repeat"};
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+//Buttons wake the panel, nothing to do on the host
+void POWER_requestWake(POWER_source_t src)
+{
+}
+
+void POWER_enableGpioWakeup(int gpio_num)
+{
+}
+
+static uint32_t nextRandom(void)
+{
+	seed = seed * 1664525u + 1013904223u;
+	return seed >> 8;
+}
+
+static void onGesture(const BUTTON_event_t* evt, void* arg)
+{
+	if (seen_count < GESTURE_MAX)
+	{
+		seen[seen_count].gpio = evt->gpio;
+		seen[seen_count].gesture = evt->gesture;
+		seen[seen_count].edge_us = evt->edge_us;
+		seen[seen_count].delivered_us = esp_timer_get_time();
+		seen_count++;
+	}
+}
+
+static void addEdge(int64_t t_us, int pin, int level)
+{
+	assert(trace_count < TRACE_MAX);
+	trace[trace_count].t_us = t_us;
+	trace[trace_count].pin = pin;
+	trace[trace_count].level = level;
+	trace_count++;
+}
+
+//Contact closing or opening: the first edge, then a burst of bounces ending on level
+static void addBouncyEdge(int64_t t_us, int pin, int level)
+{
+	const int bounces = nextRandom() % 4;
+	int64_t t = t_us;
+
+	addEdge(t, pin, level);
+	for (int i = 0; i < bounces; i++)
+	{
+		t += 100 + nextRandom() % (BOUNCE_MAX_US / (2 * (bounces + 1)));
+		addEdge(t, pin, !level);
+		t += 100 + nextRandom() % (BOUNCE_MAX_US / (2 * (bounces + 1)));
+		addEdge(t, pin, level);
+	}
+}
+
+static void press(int pin, int64_t t_us, int64_t hold_us)
+{
+	addBouncyEdge(t_us, pin, 0);
+	addBouncyEdge(t_us + hold_us, pin, 1);
+}
+
+static void expect(int pin, BUTTON_gesture_t gesture, int64_t edge_us)
+{
+	assert(expected_count < GESTURE_MAX);
+	expected[expected_count].gpio = pin;
+	expected[expected_count].gesture = gesture;
+	expected[expected_count].edge_us = edge_us;
+	expected_count++;
+}
+
+//One pass over every gesture, expected events in the order they are delivered
+static void buildScript(int64_t start)
+{
+	int64_t t = start;
+
+	//short press on a plain button, reported on release
+	press(PIN_PLAIN, t, 120000);
+	expect(PIN_PLAIN, BUTTON_SHORT, t + 120000);
+	t += 400000;
+
+	//held for a second: long at 600 ms, repeats at 750 and 900 ms
+	press(PIN_PLAIN, t, 1000000);
+	expect(PIN_PLAIN, BUTTON_LONG, t + BUTTON_LONG_US);
+	expect(PIN_PLAIN, BUTTON_REPEAT, t + BUTTON_LONG_US + BUTTON_REPEAT_US);
+	expect(PIN_PLAIN, BUTTON_REPEAT, t + BUTTON_LONG_US + 2 * BUTTON_REPEAT_US);
+	t += 1400000;
+
+	//double press, reported on the second press
+	press(PIN_DOUBLE, t, 80000);
+	press(PIN_DOUBLE, t + 200000, 80000);
+	expect(PIN_DOUBLE, BUTTON_DOUBLE, t + 200000);
+	t += 700000;
+
+	//single press on a double button, reported once the gap runs out
+	press(PIN_DOUBLE, t, 100000);
+	expect(PIN_DOUBLE, BUTTON_SHORT, t + 100000 + BUTTON_DOUBLE_GAP_US);
+	t += 700000;
+
+	//fast taps, each one reported
+	for (int i = 0; i < 5; i++)
+	{
+		press(PIN_PLAIN, t, 60000);
+		expect(PIN_PLAIN, BUTTON_SHORT, t + 60000);
+		t += 140000;
+	}
+	t += 300000;
+
+	//released inside the lockout window, picked up when the window ends
+	addEdge(t, PIN_PLAIN, 0);
+	addEdge(t + 12000, PIN_PLAIN, 1);
+	expect(PIN_PLAIN, BUTTON_SHORT, t + BUTTON_DEBOUNCE_US);
+	t += 400000;
+
+	//both buttons at once
+	press(PIN_PLAIN, t, 150000);
+	press(PIN_DOUBLE, t + 30000, 100000);
+	expect(PIN_PLAIN, BUTTON_SHORT, t + 150000);
+	expect(PIN_DOUBLE, BUTTON_SHORT, t + 30000 + 100000 + BUTTON_DOUBLE_GAP_US);
+}
+
+//Play order, presses on different pins overlap
+static int compareEdges(const void* a, const void* b)
+{
+	const trace_edge_t* ea = a;
+	const trace_edge_t* eb = b;
+	return (ea->t_us > eb->t_us) - (ea->t_us < eb->t_us);
+}
+
+static void drain(void)
+{
+	BUTTON_edge_t edge;
+	while (xQueueReceive(edge_queue, &edge, 0) == pdTRUE)
+	{
+		BUTTON_handle(&edge);
+	}
+}
+
+//Move the clock to t, draining the queue every step
+static void runTo(int64_t t)
+{
+	while (now_us < t)
+	{
+		const int64_t step = (t - now_us < STEP_US) ? t - now_us : STEP_US;
+		HOST_clockAdvance(step);
+		now_us += step;
+		drain();
+	}
+}
+
+//Play one press and count the gestures BUTTON_acts lets through
+static void countActs(int64_t hold_us, int* once, int* repeat)
+{
+	const int64_t start = now_us + 100000;
+
+	trace_count = 0;
+	seen_count = 0;
+	press(PIN_PLAIN, start, hold_us);
+	for (int i = 0; i < trace_count; i++)
+	{
+		runTo(trace[i].t_us);
+		HOST_gpioSetInput(trace[i].pin, trace[i].level);
+		drain();
+	}
+	runTo(now_us + 500000);
+
+	*once = 0;
+	*repeat = 0;
+	for (int i = 0; i < seen_count; i++)
+	{
+		*once += BUTTON_acts(seen[i].gesture, false);
+		*repeat += BUTTON_acts(seen[i].gesture, true);
+	}
+}
+
+static void testActs(void)
+{
+	const int held_repeats = (1300000 - BUTTON_LONG_US) / BUTTON_REPEAT_US;
+	int once;
+	int repeat;
+
+	countActs(120000, &once, &repeat);
+	CHECK_EQ(once, 1);
+	CHECK_EQ(repeat, 1);
+
+	//long at 600 ms, then repeats every 150 ms until the release at 1.3 s
+	countActs(1300000, &once, &repeat);
+	HOST_report("held 1.3 s: %d gestures, media key sent %d, volume sent %d", seen_count, once, repeat);
+	CHECK_EQ(seen_count, 1 + held_repeats);
+	CHECK_EQ(once, 1);
+	CHECK_EQ(repeat, 1 + held_repeats);
+}
+
+static int64_t llabs64(int64_t v)
+{
+	return v < 0 ? -v : v;
+}
+
+int main(void)
+{
+	const BUTTON_config_t cfg[2] = {
+		{.gpio = PIN_PLAIN, .double_press = false},
+		{.gpio = PIN_DOUBLE, .double_press = true},
+	};
+	int matched = 0;
+	int total = 0;
+	int64_t latency_max = 0;
+	int64_t latency_sum = 0;
+	int64_t offset_max = 0;
+
+	now_us = 1000000;
+	HOST_clockSetManual(now_us);
+	CHECK_EQ(BUTTON_init(cfg, 2, onGesture, NULL), ESP_OK);
+
+	for (int run = 0; run < RUNS; run++)
+	{
+		seed = 0x1234 + run * 7919;
+		trace_count = 0;
+		expected_count = 0;
+		seen_count = 0;
+
+		buildScript(now_us + 100000);
+		qsort(trace, trace_count, sizeof(trace[0]), compareEdges);
+		for (int i = 0; i < trace_count; i++)
+		{
+			runTo(trace[i].t_us);
+			HOST_gpioSetInput(trace[i].pin, trace[i].level);
+			drain();
+		}
+		runTo(now_us + 1000000);
+
+		CHECK_EQ(seen_count, expected_count);
+		for (int i = 0; i < expected_count && i < seen_count; i++)
+		{
+			const gesture_t* e = &expected[i];
+			const gesture_t* s = &seen[i];
+			const int64_t offset = llabs64(s->edge_us - e->edge_us);
+			const bool ok = s->gpio == e->gpio && s->gesture == e->gesture && offset <= TIME_SLACK_US;
+			if (!ok)
+			{
+				fprintf(stderr, "run %d gesture %d: got %s on %d at %lld, expected %s on %d at %lld\n", run, i,
+					gesture_names[s->gesture], s->gpio, (long long)s->edge_us,
+					gesture_names[e->gesture], e->gpio, (long long)e->edge_us);
+			}
+			CHECK(ok);
+			matched += ok;
+
+			//from the physical edge (or deadline) the gesture belongs to, to the callback
+			const int64_t latency = s->delivered_us - e->edge_us;
+			latency_sum += latency;
+			latency_max = (latency > latency_max) ? latency : latency_max;
+			offset_max = (offset > offset_max) ? offset : offset_max;
+		}
+		total += expected_count;
+	}
+
+	BUTTON_stats_t stats;
+	BUTTON_getStats(&stats);
+	HOST_report("gestures %d/%d correct over %d runs, edge time error max %lld us",
+		matched, total, RUNS, (long long)offset_max);
+	HOST_report("latency avg %lld us, max %lld us (clock step %d us)",
+		(long long)(total ? latency_sum / total : 0), (long long)latency_max, STEP_US);
+	HOST_report("edges accepted %u, bounces dropped %u, events %u",
+		stats.edges, stats.bounces, stats.events);
+
+	CHECK_EQ(matched, total);
+	CHECK(stats.bounces > 0);
+	CHECK(latency_max <= 2 * STEP_US);
+
+	testActs();
+
+	return HOST_testDone("test_buttons");
+}
@@ -0,0 +1,169 @@
+/**
+ * @file test_clock.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief A week of minute ticks with a late timer task
+ *
+ * The wall clock (gettimeofday/settimeofday/time) is faked on top of the
+ * manual esp_timer clock, and every re-arm of the tick timer is delayed by a
+ * random lateness, the way a busy esp_timer task would run it late. Over
+ * 7 x 1440 ticks every tick has to land in the next minute, none skipped or
+ * repeated, just after the boundary by no more than its lateness.
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <sys/time.h>
+#include <time.h>
+#include "host_shim.h"
+#include "host_test.h"
+#include "esp_timer.h"
+
+//the clock reads the fake wall clock and arms its timer late
+static int fakeGettimeofday(struct timeval* tv, void* tz);
+static int fakeSettimeofday(const struct timeval* tv, const void* tz);
+static time_t fakeTime(time_t* t);
+static esp_err_t lateStartOnce(esp_timer_handle_t timer, uint64_t timeout_us);
+
+#define gettimeofday(tv, tz)            fakeGettimeofday((tv), (tz))
+#define settimeofday(tv, tz)            fakeSettimeofday((tv), (tz))
+#define time(t)                         fakeTime(t)
+#define esp_timer_start_once(timer, us) lateStartOnce((timer), (us))
+#include "watch_clock.c"
+#undef gettimeofday
+#undef settimeofday
+#undef time
+#undef esp_timer_start_once
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define DAYS             7
+#define TICKS            (DAYS * 24 * 60)
+#define STEP_US          (10 * 1000000LL)   //clock advanced per loop, ticks fire at their deadlines
+#define LATE_MAX_US      20000              //usual timer task lateness
+#define LATE_STALL_US    5000000            //now and then the task is held up for seconds
+#define STALL_ONE_IN     100
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static int64_t wall_offset_us;      //wall clock minus esp_timer time
+static uint32_t seed = 0xC10C;
+static int64_t armed_late_us;       //lateness given to the armed tick
+static int64_t fired_late_us;       //lateness of the tick running now (the callback re-arms before notifying)
+static int64_t late_max_us;
+
+static int ticks;
+static int64_t last_minute;         //minutes since the epoch at the previous tick
+static int skipped;
+static int repeated;
+static int early;
+static int64_t into_minute_max_us;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+static int64_t wallUs(void)
+{
+	return wall_offset_us + esp_timer_get_time();
+}
+
+static int fakeGettimeofday(struct timeval* tv, void* tz)
+{
+	const int64_t us = wallUs();
+	tv->tv_sec = us / 1000000;
+	tv->tv_usec = us % 1000000;
+	return 0;
+}
+
+static int fakeSettimeofday(const struct timeval* tv, const void* tz)
+{
+	wall_offset_us = tv->tv_sec * 1000000LL + tv->tv_usec - esp_timer_get_time();
+	return 0;
+}
+
+static time_t fakeTime(time_t* t)
+{
+	const time_t now = wallUs() / 1000000;
+	if (t != NULL)
+	{
+		*t = now;
+	}
+	return now;
+}
+
+static uint32_t nextRandom(void)
+{
+	seed = seed * 1664525u + 1013904223u;
+	return seed >> 8;
+}
+
+static esp_err_t lateStartOnce(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+	fired_late_us = armed_late_us;
+	armed_late_us = nextRandom() % LATE_MAX_US;
+	if (nextRandom() % STALL_ONE_IN == 0)
+	{
+		armed_late_us += nextRandom() % LATE_STALL_US;
+	}
+	late_max_us = (armed_late_us > late_max_us) ? armed_late_us : late_max_us;
+	return esp_timer_start_once(timer, timeout_us + armed_late_us);
+}
+
+static void onTick(const struct tm* now, void* arg)
+{
+	const int64_t wall = wallUs();
+	const int64_t minute = wall / 60000000;
+	const int64_t into_minute = wall % 60000000;
+
+	//the tick shows the minute it runs in
+	CHECK_EQ(now->tm_min, (int)(minute % 60));
+
+	if (ticks > 0)
+	{
+		skipped += (minute > last_minute + 1);
+		repeated += (minute <= last_minute);
+		//just after the boundary, late by no more than the lateness it was armed with
+		early += (into_minute < CLOCK_WAKE_MARGIN_US);
+		CHECK(into_minute <= CLOCK_WAKE_MARGIN_US + fired_late_us);
+		into_minute_max_us = (into_minute > into_minute_max_us) ? into_minute : into_minute_max_us;
+	}
+	last_minute = minute;
+	ticks++;
+}
+
+int main(void)
+{
+	HOST_clockSetManual(0);
+	CHECK_EQ(CLOCK_subscribe(onTick, NULL), ESP_OK);
+
+	//the first notification comes from setting the time, the week starts from there
+	CHECK_EQ(CLOCK_init(23, 58), ESP_OK);
+	CHECK_EQ(ticks, 1);
+	const int64_t start_minute = last_minute;
+
+	while (ticks < TICKS + 1)
+	{
+		HOST_clockAdvance(STEP_US);
+	}
+
+	HOST_report("%d ticks over %d days: skipped %d  repeated %d  early %d", ticks - 1, DAYS, skipped, repeated, early);
+	HOST_report("lateness max %lld us, tick at most %lld us into its minute",
+		(long long)late_max_us, (long long)into_minute_max_us);
+
+	CHECK_EQ(ticks - 1, TICKS);
+	CHECK_EQ(skipped, 0);
+	CHECK_EQ(repeated, 0);
+	CHECK_EQ(early, 0);
+	//no drift, a week of ticks is a week of minutes
+	CHECK_EQ(last_minute - start_minute, TICKS);
+	CHECK_EQ(HOST_timersArmed(), 1);
+
+	return HOST_testDone("test_clock");
+}
@@ -0,0 +1,460 @@
+/**
+ * @file test_display.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Driver and framebuffer against the ST7735S model
+ *
+ * Checks the controller state LCD_init leaves behind, that LCD_fillRect puts
+ * the same byte stream on the wire as the old buffered boot clear, pixel placement of
+ * fills and windows (including MADCTL row / column exchange), the scroll and
+ * panel modes, then flushes a framebuffer scene and dumps it. The watch face
+ * updates (a minute change and an icon swap) are counted against a full
+ * screen redraw. The LCD trace counters must add up to the bytes and
+ * transactions the emulator saw. Per frame bus counters are printed for each
+ * step.
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <string.h>
+#include "display_main.h"
+#include "display_bus.h"
+#include "display_fb.h"
+#include "display_font.h"
+#include "display_trace.h"
+#include "display_assets.h"
+#include "lcd_port_emu.h"
+#include "host_test.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define RED    0xF800
+#define GREEN  0x07E0
+#define BLUE   0x001F
+#define BLACK  0x0000
+#define GREY   0x7BEF
+#define CLEAR  0x7D7D     //boot clear, every byte 125
+
+#define STREAM_MAX (FRAME_SIZE + 64)
+
+#define CLOCK_X    11     //watch_face.c layout
+#define CLOCK_Y    44
+#define ICON_Y     92
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static spi_device_handle_t spi;
+static uint8_t window_buf[20 * 10 * PIXEL_SIZE];
+static uint8_t clear_buf[FRAME_SIZE];
+static uint8_t stream_bytes[2][STREAM_MAX];
+static uint8_t stream_dc[2][STREAM_MAX];
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+static void printFrame(const char* name, const EMU_counters_t* c)
+{
+	HOST_report("%-10s bytes %6u  pixel bytes %6u  transactions %4u  commands %3u  dc toggles %4u  ramwr %2u  bus %7.1f us",
+		name, c->bytes, c->pixel_bytes, c->transactions, c->commands, c->dc_toggles, c->ramwr, c->bus_ns / 1000.0);
+}
+
+static EMU_counters_t endFrame(const char* name)
+{
+	EMU_counters_t c;
+	LCD_emuFrameEnd(&c);
+	printFrame(name, &c);
+	return c;
+}
+
+static uint16_t viewPixel(int x, int y)
+{
+	EMU_st7735s_t* emu = LCD_emuLock();
+	const uint16_t px = EMU_viewPixel(emu, x, y);
+	LCD_emuUnlock();
+	return px;
+}
+
+//Every pixel of a screen rect is color
+static bool rectIs(int x, int y, int w, int h, uint16_t color)
+{
+	for (int j = y; j < y + h; j++)
+	{
+		for (int i = x; i < x + w; i++)
+		{
+			if (viewPixel(i, j) != color)
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static void checkNoErrors(void)
+{
+	EMU_st7735s_t* emu = LCD_emuLock();
+	CHECK_EQ(emu->unknown_cmds, 0);
+	CHECK_EQ(emu->bad_params, 0);
+	CHECK_EQ(emu->bad_pixels, 0);
+	CHECK_EQ(emu->sleep_writes, 0);
+	LCD_emuUnlock();
+}
+
+static void testInit(void)
+{
+	LCD_emuInit();
+	CHECK_EQ(LCD_busInit(&spi, LCD_BUS_DEFAULT_HZ), ESP_OK);
+	LCD_init(spi);
+
+	EMU_st7735s_t* emu = LCD_emuLock();
+	CHECK(!emu->sleeping);
+	CHECK(emu->display_on);
+	CHECK(!emu->inverted);
+	CHECK_EQ(emu->colmod, PIXEL_FORMAT);
+	CHECK_EQ(emu->madctl, 0x00);
+	CHECK_EQ(emu->gamma, GAMMA_CURVE);
+	LCD_emuUnlock();
+	checkNoErrors();
+
+	//SLPOUT, MADCTL + 1, COLMOD + 1, GAMSET + 1, INVOFF, DISPON
+	const EMU_counters_t c = endFrame("init");
+	CHECK_EQ(c.transactions, 9);
+	CHECK_EQ(c.commands, 6);
+	CHECK_EQ(c.bytes, 9);
+	CHECK_EQ(c.pixel_bytes, 0);
+}
+
+//The old boot clear: a frame sized buffer sent as 128 polling chunks after RAMWR
+static void clearBuffered(void)
+{
+	const int chunk = FRAME_SIZE / 128;
+
+	memset(clear_buf, 125, sizeof(clear_buf));
+	LCD_setDrawingWindow(spi, X_OFFSET, Y_OFFSET, WIDTH - 1, HEIGHT - 1);
+	LCD_sendCommand(spi, 0x2C);
+	for (int i = 0; i < 128; i++)
+	{
+		LCD_sendData(spi, clear_buf + i * chunk, chunk);
+	}
+}
+
+static LCD_emu_capture_t captureStream(int n, void (*send)(void))
+{
+	LCD_emu_capture_t capture = {stream_bytes[n], stream_dc[n], STREAM_MAX, 0};
+
+	LCD_emuCapture(&capture);
+	send();
+	LCD_emuCapture(NULL);
+	return capture;
+}
+
+static void clearFill(void)
+{
+	LCD_fillRect(spi, X_OFFSET, Y_OFFSET, WIDTH, HEIGHT, CLEAR);
+}
+
+//Same bytes with the same D/C level, only the transactions carrying them differ
+static void testClearStream(void)
+{
+	const LCD_emu_capture_t old = captureStream(0, clearBuffered);
+	const EMU_counters_t old_c = endFrame("old clear");
+	const LCD_emu_capture_t fill = captureStream(1, clearFill);
+	const EMU_counters_t fill_c = endFrame("fill clear");
+
+	CHECK(old.len <= STREAM_MAX);
+	CHECK_EQ(fill.len, old.len);
+	CHECK(memcmp(stream_bytes[1], stream_bytes[0], old.len) == 0);
+	CHECK(memcmp(stream_dc[1], stream_dc[0], old.len) == 0);
+	CHECK_EQ(fill_c.pixel_bytes, old_c.pixel_bytes);
+	CHECK(fill_c.transactions < old_c.transactions);
+	CHECK(rectIs(0, 0, WIDTH, HEIGHT, CLEAR));
+	checkNoErrors();
+}
+
+static void testFill(void)
+{
+	LCD_fillRect(spi, X_OFFSET, Y_OFFSET, WIDTH, HEIGHT, BLACK);
+	EMU_counters_t c = endFrame("clear");
+	CHECK_EQ(c.pixel_bytes, FRAME_SIZE);
+	CHECK_EQ(c.ramwr, 1);
+	CHECK_EQ(c.windows, 2);
+	//window and RAMWR are 5 transactions, then one per pattern repeat
+	CHECK_EQ(c.transactions, 5 + FRAME_SIZE / LCD_FILL_PATTERN_SIZE);
+	//command / data alternate through the header, then stay high for the pixels
+	CHECK(c.dc_toggles <= 6);
+	CHECK(rectIs(0, 0, WIDTH, HEIGHT, BLACK));
+
+	LCD_fillRect(spi, X_OFFSET + 10, Y_OFFSET + 20, 30, 40, RED);
+	c = endFrame("fill");
+	CHECK_EQ(c.pixel_bytes, 30 * 40 * PIXEL_SIZE);
+	CHECK(rectIs(10, 20, 30, 40, RED));
+	CHECK(rectIs(9, 20, 1, 40, BLACK));
+	CHECK(rectIs(40, 20, 1, 40, BLACK));
+	CHECK(rectIs(10, 19, 30, 1, BLACK));
+	CHECK(rectIs(10, 60, 30, 1, BLACK));
+	checkNoErrors();
+}
+
+static void fillGradient(void)
+{
+	for (int i = 0; i < 20 * 10; i++)
+	{
+		const uint16_t px = (uint16_t)(i * 331);
+		window_buf[i * 2] = px >> 8;
+		window_buf[i * 2 + 1] = px & 0xFF;
+	}
+}
+
+static uint16_t gradientAt(int i)
+{
+	return (uint16_t)(i * 331);
+}
+
+static void testWindow(void)
+{
+	fillGradient();
+	LCD_waitFrame(LCD_sendWindowAsync(spi, X_OFFSET + 50, Y_OFFSET + 70, 20, 10, window_buf, sizeof(window_buf)));
+	const EMU_counters_t c = endFrame("window");
+	CHECK_EQ(c.pixel_bytes, sizeof(window_buf));
+
+	int wrong = 0;
+	for (int y = 0; y < 10; y++)
+	{
+		for (int x = 0; x < 20; x++)
+		{
+			wrong += (viewPixel(50 + x, 70 + y) != gradientAt(y * 20 + x));
+		}
+	}
+	CHECK_EQ(wrong, 0);
+
+	//with rows and columns exchanged the same bytes fill the window column by column
+	const uint8_t mv = EMU_MADCTL_MV;
+	const uint8_t normal = 0x00;
+	LCD_sendCommand(spi, 0x36);
+	LCD_sendData(spi, &mv, 1);
+	LCD_waitFrame(LCD_sendWindowAsync(spi, Y_OFFSET + 70, X_OFFSET + 80, 10, 20, window_buf, sizeof(window_buf)));
+	LCD_sendCommand(spi, 0x36);
+	LCD_sendData(spi, &normal, 1);
+	endFrame("window mv");
+
+	wrong = 0;
+	for (int x = 0; x < 20; x++)
+	{
+		for (int y = 0; y < 10; y++)
+		{
+			wrong += (viewPixel(80 + x, 70 + y) != gradientAt(x * 10 + y));
+		}
+	}
+	CHECK_EQ(wrong, 0);
+	checkNoErrors();
+}
+
+static void testScroll(void)
+{
+	//band over glass lines 10..49, the red rect covers lines 20..59
+	LCD_setScrollArea(spi, Y_OFFSET + 10, 40);
+	LCD_setScrollStart(spi, Y_OFFSET + 18);
+	endFrame("scroll");
+
+	//moved up 8 lines, the band's top 8 lines wrap to its bottom
+	CHECK(rectIs(10, 10, 30, 2, BLACK));
+	CHECK(rectIs(10, 12, 30, 30, RED));
+	CHECK(rectIs(10, 42, 30, 8, BLACK));
+	//lines below the band stay put
+	CHECK(rectIs(10, 50, 30, 10, RED));
+	CHECK(rectIs(10, 60, 30, 1, BLACK));
+
+	LCD_setScrollStart(spi, Y_OFFSET + 40);
+	CHECK(rectIs(10, 10, 30, 10, RED));
+	CHECK(rectIs(10, 20, 30, 10, BLACK));
+	CHECK(rectIs(10, 30, 30, 20, RED));
+
+	LCD_scrollStop(spi);
+	endFrame("scroll off");
+	CHECK(rectIs(10, 20, 30, 40, RED));
+	CHECK(rectIs(10, 19, 30, 1, BLACK));
+	checkNoErrors();
+}
+
+static void testPanelModes(void)
+{
+	LCD_fillRect(spi, X_OFFSET, Y_OFFSET, 4, 4, GREY);
+
+	LCD_setPanelMode(spi, LCD_PANEL_IDLE);
+	//idle mode keeps only the top bit of each channel
+	CHECK_EQ(viewPixel(0, 0), 0x0000);
+	CHECK_EQ(viewPixel(10, 20), RED);
+
+	LCD_setPanelMode(spi, LCD_PANEL_SLEEP);
+	CHECK(rectIs(10, 20, 30, 40, BLACK));
+	{
+		EMU_st7735s_t* emu = LCD_emuLock();
+		CHECK(emu->sleeping);
+		LCD_emuUnlock();
+	}
+
+	//GRAM survives sleep
+	LCD_setPanelMode(spi, LCD_PANEL_NORMAL);
+	CHECK_EQ(viewPixel(0, 0), GREY);
+	CHECK(rectIs(10, 20, 30, 40, RED));
+	endFrame("panel");
+	checkNoErrors();
+}
+
+static void testFramebuffer(void)
+{
+	static LCD_palette_t pal;
+	const FB_rect_t bar = {0, 100, WIDTH, 8};
+
+	FONT_makePalette(&pal, &font_5x7, 0xFFFF, BLUE);
+
+	//vsync is never started, so the flush does not pace itself
+	FB_init(spi, BLUE);
+	FB_flush();
+	EMU_counters_t c = endFrame("fb clear");
+	CHECK_EQ(c.pixel_bytes, FRAME_SIZE);
+	CHECK(rectIs(0, 0, WIDTH, HEIGHT, BLUE));
+
+	FB_setFill(0, bar, GREEN);
+	FB_setText(1, 8, 8, "12:34", &font_5x7, 2, &pal);
+	FB_flush();
+	c = endFrame("fb scene");
+	//only the dirty regions go out
+	CHECK(c.pixel_bytes < FRAME_SIZE);
+	CHECK(rectIs(0, 100, WIDTH, 8, GREEN));
+	CHECK(rectIs(0, 90, WIDTH, 10, BLUE));
+	CHECK(!rectIs(8, 8, 5 * 6 * 2, 7 * 2, BLUE));
+
+	//nothing changed, nothing sent
+	FB_flush();
+	c = endFrame("fb idle");
+	CHECK_EQ(c.bytes, 0);
+	checkNoErrors();
+
+	CHECK_EQ(LCD_emuDump(HOST_FRAME_DIR "/display_scene.ppm"), 0);
+	CHECK_EQ(LCD_emuDump(HOST_FRAME_DIR "/display_scene.png"), 0);
+
+	uint8_t sig[8] = {0};
+	FILE* f = fopen(HOST_FRAME_DIR "/display_scene.png", "rb");
+	CHECK(f != NULL);
+	if (f != NULL)
+	{
+		CHECK_EQ(fread(sig, 1, sizeof(sig), f), sizeof(sig));
+		fclose(f);
+	}
+	CHECK(memcmp(sig, "\x89PNG\r\n\x1a\n", 8) == 0);
+}
+
+//Minute change and icon swap only send what changed, against redrawing the whole screen
+static void testDirtyUpdates(void)
+{
+	static LCD_palette_t clock_pal;
+	const LCD_glyph_t* digits = glyph_display_numbers;
+	const uint8_t w = digits[0].width;
+	const uint8_t icon_x = (WIDTH - MEDIA_ICONS_WIDTH) / 2;
+	const int digit_bytes = w * digits[0].height * PIXEL_SIZE;
+	const int icon_bytes = MEDIA_ICONS_SIZE;
+
+	LCD_paletteInit(&clock_pal, clock_palette_colors, digits[0].bpp);
+	FB_clearSlot(0);
+	FB_clearSlot(1);
+	FB_setGlyph(2, CLOCK_X, CLOCK_Y, &digits[1], &clock_pal);
+	FB_setGlyph(3, CLOCK_X + w, CLOCK_Y, &digits[2], &clock_pal);
+	FB_setGlyph(4, CLOCK_X + 2 * w, CLOCK_Y, &glyph_semi_colon, &clock_pal);
+	FB_setGlyph(5, CLOCK_X + 2 * w + glyph_semi_colon.width, CLOCK_Y, &digits[3], &clock_pal);
+	FB_setGlyph(6, CLOCK_X + 3 * w + glyph_semi_colon.width, CLOCK_Y, &digits[4], &clock_pal);
+	FB_setRle(7, icon_x, ICON_Y, &rle_media_icons[0]);
+	FB_flush();
+	endFrame("fb face");
+
+	//what every update would cost without dirty tracking
+	FB_markDirty((FB_rect_t){0, 0, WIDTH, HEIGHT});
+	FB_flush();
+	const EMU_counters_t full = endFrame("fb full");
+	CHECK_EQ(full.pixel_bytes, FRAME_SIZE);
+
+	//12:34 -> 12:35, one digit
+	FB_setGlyph(6, CLOCK_X + 3 * w + glyph_semi_colon.width, CLOCK_Y, &digits[5], &clock_pal);
+	FB_flush();
+	const EMU_counters_t minute = endFrame("fb minute");
+	CHECK_EQ(minute.pixel_bytes, digit_bytes);
+	CHECK_EQ(minute.ramwr, 1);
+	CHECK(minute.bytes * 10 < full.bytes);
+
+	//12:34 -> 13:00, three digits on both sides of the colon
+	FB_setGlyph(3, CLOCK_X + w, CLOCK_Y, &digits[3], &clock_pal);
+	FB_setGlyph(5, CLOCK_X + 2 * w + glyph_semi_colon.width, CLOCK_Y, &digits[0], &clock_pal);
+	FB_setGlyph(6, CLOCK_X + 3 * w + glyph_semi_colon.width, CLOCK_Y, &digits[0], &clock_pal);
+	FB_flush();
+	const EMU_counters_t hour = endFrame("fb hour");
+	CHECK(hour.pixel_bytes >= 3 * digit_bytes);
+	CHECK(hour.pixel_bytes <= 4 * digit_bytes + glyph_semi_colon.width * glyph_semi_colon.height * PIXEL_SIZE);
+	CHECK(hour.bytes * 3 < full.bytes);
+
+	FB_setRle(7, icon_x, ICON_Y, &rle_media_icons[1]);
+	FB_flush();
+	const EMU_counters_t icon = endFrame("fb icon");
+	CHECK_EQ(icon.pixel_bytes, icon_bytes);
+	CHECK_EQ(icon.ramwr, 1);
+	CHECK(icon.bytes * 10 < full.bytes);
+
+	HOST_report("bytes against a full redraw: minute %.1f%%  hour %.1f%%  icon %.1f%%",
+		100.0 * minute.bytes / full.bytes, 100.0 * hour.bytes / full.bytes, 100.0 * icon.bytes / full.bytes);
+	checkNoErrors();
+}
+
+//Every path through the driver is traced, totals and the last flush agree with the bus
+static void testTrace(void)
+{
+	LCD_trace_stats_t trace;
+	EMU_counters_t bus;
+	EMU_counters_t flush;
+	const uint8_t normal = 0x00;
+
+	LCD_emuFrameEnd(NULL);
+	LCD_traceReset();
+
+	//polling commands and data, a pattern fill, a window burst and framebuffer flushes
+	LCD_sendCommand(spi, 0x36);
+	LCD_sendData(spi, &normal, 1);
+	LCD_fillRect(spi, X_OFFSET + 4, Y_OFFSET + 4, 50, 50, GREEN);
+	LCD_waitFrame(LCD_sendWindowAsync(spi, X_OFFSET + 50, Y_OFFSET + 70, 20, 10, window_buf, sizeof(window_buf)));
+	FB_markDirty((FB_rect_t){0, 0, WIDTH, HEIGHT});
+	FB_flush();
+	LCD_emuFrameEnd(&bus);
+	FB_setFill(0, (FB_rect_t){20, 110, 40, 6}, RED);
+	FB_flush();
+	LCD_emuFrameEnd(&flush);
+
+	LCD_traceGetStats(&trace);
+	HOST_report("trace      bytes %6llu  transactions %4u  frames %u  last frame bytes %u  transactions %u",
+		(unsigned long long)trace.bytes, trace.transactions, trace.frames, trace.frame_bytes, trace.frame_transactions);
+
+	CHECK_EQ(trace.bytes, (uint64_t)bus.bytes + flush.bytes);
+	CHECK_EQ(trace.transactions, bus.transactions + flush.transactions);
+	CHECK_EQ(trace.frames, 2);
+	CHECK_EQ(trace.frame_bytes, flush.bytes);
+	CHECK_EQ(trace.frame_transactions, flush.transactions);
+	checkNoErrors();
+}
+
+int main(void)
+{
+	testInit();
+	testClearStream();
+	testFill();
+	testWindow();
+	testScroll();
+	testPanelModes();
+	testFramebuffer();
+	testDirtyUpdates();
+	testTrace();
+	return HOST_testDone("test_display");
+}
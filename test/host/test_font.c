@@ -0,0 +1,195 @@
+/**
+ * @file test_font.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Font rendering rate and flash cost of the date label
+ *
+ * Renders the date label the watch face shows (5x7 font at scale 2) row by
+ * row with FONT_renderRow and reports glyphs per second, once with the glyph
+ * cache warm (the label repeats every tick) and once cycling through every
+ * glyph of the font so each one is unpacked again. The flash the font takes
+ * is compared with storing the same glyphs pre-rendered as RGB565, the way
+ * the clock digits are. The label is also drawn through the framebuffer and
+ * must show the rendered rows on the glass.
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <string.h>
+#include <time.h>
+#include "display_main.h"
+#include "display_bus.h"
+#include "display_fb.h"
+#include "display_font.h"
+#include "display_assets.h"
+#include "lcd_port_emu.h"
+#include "host_test.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define BACKGROUND     0x7D7D
+#define DATE_SCALE     2          //watch_face.c date label
+#define DATE_Y         26
+#define DATE_TEXT      "Fri 16 Oct"
+#define ROUNDS         5000       //renders of the whole label per pass
+#define COLD_LEN       10         //glyphs per string of the cold pass, more than the cache holds
+#define COLD_STRINGS   50
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+typedef struct {
+	double glyphs_per_s;
+	double px_per_s;
+} rate_t;
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static spi_device_handle_t spi;
+static LCD_palette_t pal;
+static uint8_t row_buf[WIDTH * PIXEL_SIZE];
+static volatile uint8_t sink;         //keeps the renders from being optimized out
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+static double nowUs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+//Every row of each string, rounds times over
+static rate_t renderRate(const char* const* texts, int count, int rounds)
+{
+	const int rows = font_5x7.height * DATE_SCALE;
+	int glyphs = 0;
+	double px = 0;
+
+	const double start = nowUs();
+	for (int r = 0; r < rounds; r++)
+	{
+		const char* text = texts[r % count];
+		const int width = FONT_measure(&font_5x7, text, DATE_SCALE);
+		for (int row = 0; row < rows; row++)
+		{
+			FONT_renderRow(&font_5x7, text, DATE_SCALE, &pal, row, width, row_buf);
+			sink += row_buf[row];
+		}
+		glyphs += (int)strlen(text);
+		px += (double)width * rows;
+	}
+	const double us = nowUs() - start;
+
+	return (rate_t){glyphs * 1e6 / us, px * 1e6 / us};
+}
+
+//Flash the font takes against the same glyphs pre-rendered at the label scale
+static void flashCost(void)
+{
+	int font_bytes = sizeof(FONT_t) + font_5x7.count * sizeof(LCD_glyph_t);
+	int rendered_bytes = 0;
+
+	for (int i = 0; i < font_5x7.count; i++)
+	{
+		const LCD_glyph_t* g = &font_5x7.glyphs[i];
+		font_bytes += (g->width * g->height * g->bpp + 7) / 8;
+		rendered_bytes += g->width * g->height * DATE_SCALE * DATE_SCALE * PIXEL_SIZE;
+	}
+
+	HOST_report("flash: font %d bytes for %d glyphs, pre-rendered at scale %d %d bytes (%.1f%%), clock digits %d bytes",
+		font_bytes, font_5x7.count, DATE_SCALE, rendered_bytes, 100.0 * font_bytes / rendered_bytes,
+		DISPLAY_NUMBERS_COUNT * DISPLAY_NUMBERS_SIZE);
+	CHECK(font_bytes * 10 < rendered_bytes);
+	CHECK(font_bytes < DISPLAY_NUMBERS_SIZE);
+}
+
+static void renderBench(void)
+{
+	static const char* const date[] = {DATE_TEXT};
+	static char cold[COLD_STRINGS][COLD_LEN + 1];
+	static const char* cold_texts[COLD_STRINGS];
+
+	_Static_assert(COLD_LEN * 6 * DATE_SCALE <= WIDTH, "cold strings wider than a row");
+
+	//consecutive strings share no glyph, the cache misses on every one
+	for (int s = 0; s < COLD_STRINGS; s++)
+	{
+		for (int i = 0; i < COLD_LEN; i++)
+		{
+			cold[s][i] = (char)(font_5x7.first + (s * COLD_LEN + i) % font_5x7.count);
+		}
+		cold_texts[s] = cold[s];
+	}
+
+	const rate_t warm = renderRate(date, 1, ROUNDS);
+	const rate_t miss = renderRate(cold_texts, COLD_STRINGS, ROUNDS / 2);
+	HOST_report("date label \"%s\" x%d: %.2f M glyphs/s  %.1f M px/s (host, cache warm)",
+		DATE_TEXT, DATE_SCALE, warm.glyphs_per_s / 1e6, warm.px_per_s / 1e6);
+	HOST_report("every glyph in turn:  %.2f M glyphs/s  %.1f M px/s (host, cache cold)",
+		miss.glyphs_per_s / 1e6, miss.px_per_s / 1e6);
+	CHECK(warm.glyphs_per_s > 0);
+	CHECK(miss.glyphs_per_s > 0);
+}
+
+//The framebuffer draws the label with the same rows
+static void labelOnGlass(void)
+{
+	const int width = FONT_measure(&font_5x7, DATE_TEXT, DATE_SCALE);
+	const int x = (WIDTH - width) / 2;
+	EMU_counters_t c;
+	int wrong = 0;
+
+	FB_init(spi, BACKGROUND);
+	FB_flush();
+	LCD_emuFrameEnd(NULL);
+	FB_setText(0, x, DATE_Y, DATE_TEXT, &font_5x7, DATE_SCALE, &pal);
+	FB_flush();
+	LCD_emuFrameEnd(&c);
+
+	for (int row = 0; row < font_5x7.height * DATE_SCALE; row++)
+	{
+		FONT_renderRow(&font_5x7, DATE_TEXT, DATE_SCALE, &pal, row, width, row_buf);
+		EMU_st7735s_t* emu = LCD_emuLock();
+		for (int i = 0; i < width; i++)
+		{
+			wrong += (EMU_viewPixel(emu, x + i, DATE_Y + row) != ((row_buf[i * 2] << 8) | row_buf[i * 2 + 1]));
+		}
+		LCD_emuUnlock();
+	}
+
+	HOST_report("date label on the glass: %dx%d, %u pixel bytes, %.1f us on the wire",
+		width, font_5x7.height * DATE_SCALE, c.pixel_bytes, c.bus_ns / 1000.0);
+	CHECK_EQ(wrong, 0);
+	CHECK_EQ(c.pixel_bytes, width * font_5x7.height * DATE_SCALE * PIXEL_SIZE);
+}
+
+int main(void)
+{
+	LCD_emuInit();
+	CHECK_EQ(LCD_busInit(&spi, LCD_BUS_DEFAULT_HZ), ESP_OK);
+	LCD_init(spi);
+	FONT_makePalette(&pal, &font_5x7, 0xFFFF, BACKGROUND);
+
+	flashCost();
+	renderBench();
+	//vsync is never started, so the flush does not pace itself
+	labelOnGlass();
+
+	EMU_st7735s_t* emu = LCD_emuLock();
+	CHECK_EQ(emu->unknown_cmds, 0);
+	CHECK_EQ(emu->bad_params, 0);
+	CHECK_EQ(emu->bad_pixels, 0);
+	LCD_emuUnlock();
+
+	return HOST_testDone("test_font");
+}
@@ -0,0 +1,149 @@
+/**
+ * @file test_frame.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief CPU busy time of a full frame, polling against the SPI queue
+ *
+ * Sends the same full screen frame the way LCD_sendFrame used to (RAMWR and
+ * one polling transaction per chunk) and through the transaction queue
+ * (LCD_sendFrameAsync serviced until done). The emulator port counts the
+ * driver calls and the wire time of each kind, LCD_emuCpuUs turns them into
+ * the CPU time the send would hold on target. Both must leave the same GRAM.
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include "display_main.h"
+#include "display_bus.h"
+#include "lcd_port_emu.h"
+#include "host_test.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define CMD_RAMWR   0x2C
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+typedef struct {
+	LCD_emu_calls_t calls;
+	EMU_counters_t bus;
+	double cpu_us;
+	uint32_t crc;
+} send_t;
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static spi_device_handle_t spi;
+static uint8_t frame[FRAME_SIZE];
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+//Diagonal stripes, every chunk different
+static void fillFrame(void)
+{
+	for (int y = 0; y < HEIGHT; y++)
+	{
+		for (int x = 0; x < WIDTH; x++)
+		{
+			const uint16_t color = (uint16_t)((x + y) * 0x0841);
+			frame[(y * WIDTH + x) * PIXEL_SIZE] = color >> 8;
+			frame[(y * WIDTH + x) * PIXEL_SIZE + 1] = color & 0xFF;
+		}
+	}
+}
+
+//The pre-queue LCD_sendFrame: RAMWR, then every chunk as a polling transaction
+static void sendPolled(void)
+{
+	const int chunk = LCD_busChunkSize(FRAME_SIZE);
+
+	LCD_sendCommand(spi, CMD_RAMWR);
+	for (int offset = 0; offset < FRAME_SIZE; offset += chunk)
+	{
+		LCD_sendData(spi, frame + offset, (FRAME_SIZE - offset < chunk) ? FRAME_SIZE - offset : chunk);
+	}
+}
+
+static void sendQueued(void)
+{
+	LCD_frame_handle_t f = LCD_sendFrameAsync(spi, frame, FRAME_SIZE);
+	while (!LCD_frameService(f, 0))
+	{
+	}
+}
+
+static send_t measure(void (*send)(void))
+{
+	send_t r;
+
+	//blank the screen so the send has something to overwrite
+	LCD_fillRect(spi, X_OFFSET, Y_OFFSET, WIDTH, HEIGHT, 0x0000);
+	LCD_setDrawingWindow(spi, X_OFFSET, Y_OFFSET, WIDTH - 1, HEIGHT - 1);
+	LCD_emuFrameEnd(NULL);
+	LCD_emuCalls(NULL);
+
+	send();
+
+	LCD_emuFrameEnd(&r.bus);
+	LCD_emuCalls(&r.calls);
+	r.cpu_us = LCD_emuCpuUs(&r.calls);
+
+	EMU_st7735s_t* emu = LCD_emuLock();
+	r.crc = EMU_gramCrc(emu, X_OFFSET, Y_OFFSET, WIDTH, HEIGHT);
+	LCD_emuUnlock();
+	return r;
+}
+
+static void report(const char* name, const send_t* r)
+{
+	const double wire_us = r->bus.bus_ns / 1000.0;
+	HOST_report("%-7s transactions %3u  polled %3u  queued %3u  wire %7.1f us  cpu %7.1f us (%3.0f%% of the wire time)",
+		name, r->bus.transactions, r->calls.polled, r->calls.queued, wire_us, r->cpu_us, 100.0 * r->cpu_us / wire_us);
+}
+
+int main(void)
+{
+	LCD_emuInit();
+	CHECK_EQ(LCD_busInit(&spi, LCD_BUS_DEFAULT_HZ), ESP_OK);
+	LCD_init(spi);
+	fillFrame();
+
+	const send_t polled = measure(sendPolled);
+	const send_t queued = measure(sendQueued);
+	report("polled", &polled);
+	report("queued", &queued);
+	HOST_report("queued frame holds the CPU %.1f%% as long, %.0f us free for rendering",
+		100.0 * queued.cpu_us / polled.cpu_us, polled.cpu_us - queued.cpu_us);
+
+	//same bytes in the same order, only how they reach the driver differs
+	CHECK_EQ(queued.crc, polled.crc);
+	CHECK_EQ(queued.bus.bytes, polled.bus.bytes);
+	CHECK_EQ(queued.bus.pixel_bytes, FRAME_SIZE);
+	CHECK_EQ(queued.bus.transactions, polled.bus.transactions);
+	CHECK_EQ(queued.bus.ramwr, 1);
+
+	CHECK_EQ(queued.calls.polled, 0);
+	CHECK_EQ(queued.calls.results, queued.calls.queued);
+	CHECK_EQ(polled.calls.queued, 0);
+	//the polling send spins through the whole wire time
+	CHECK(polled.cpu_us * 1000 >= polled.bus.bus_ns);
+	CHECK(queued.cpu_us * 10 < polled.cpu_us);
+
+	EMU_st7735s_t* emu = LCD_emuLock();
+	CHECK_EQ(emu->unknown_cmds, 0);
+	CHECK_EQ(emu->bad_params, 0);
+	CHECK_EQ(emu->bad_pixels, 0);
+	LCD_emuUnlock();
+
+	return HOST_testDone("test_frame");
+}
@@ -0,0 +1,296 @@
+/**
+ * @file test_glyph.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Per glyph setup cost, polled window setup against command batches
+ *
+ * Draws the five glyphs of a clock tick three ways: the old sequence of four
+ * polling transactions (CASET, parameters, RASET, parameters) before
+ * LCD_sendGlyph, LCD_setDrawingWindow (one batch) before LCD_sendGlyph, and
+ * LCD_sendWindowAsync with the window, RAMWR and pixels in a single burst.
+ * The driver calls are counted by the emulator port and turned into a setup
+ * time with rough spi_master costs, host wall time is reported alongside.
+ * All three must put the same pixels on the glass.
+ *
+ * The palette expansion itself is timed against copying the same frames as
+ * raw RGB565, next to the flash each format takes.
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <string.h>
+#include <time.h>
+#include "display_main.h"
+#include "display_bus.h"
+#include "display_glyph.h"
+#include "display_font.h"
+#include "display_assets_raw.h"
+#include "lcd_port_emu.h"
+#include "host_test.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define CMD_CASET        0x2A
+#define CMD_RASET        0x2B
+
+#define TICKS            200     //clock updates per path
+#define TEXT             "12:34"
+#define TEXT_Y           20      //screen rows, one band per path
+#define ROW_GAP          12
+
+/* Rough ESP32 spi_master software cost per call at 160 MHz. */
+#define COST_POLL_US     12.0    //polling transaction: acquire, setup, busy wait
+#define COST_QUEUE_US    4.0     //queued transaction, chained by the driver ISR
+#define COST_BURST_US    20.0    //waking the task once a burst is done
+
+#define EXPAND_ROUNDS    2000    //passes over the ten clock digits
+
+#define FG               0xFFFF
+#define BG               0x0000
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+typedef enum {
+	PATH_POLLED = 0,
+	PATH_BATCH,
+	PATH_BURST,
+	PATH_COUNT,
+} path_t;
+
+typedef struct {
+	EMU_counters_t bus;
+	LCD_emu_calls_t calls;
+	double wall_us;
+	double setup_us;         //modelled, everything but the pixel bytes
+} result_t;
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static spi_device_handle_t spi;
+static LCD_palette_t pal;
+static uint32_t burst_buf[GLYPH_TX_SIZE / 4];
+static uint32_t digit_buf[(DISPLAY_NUMBERS_SIZE + 3) / 4];
+static volatile uint32_t sink;        //keeps the copies from being optimized out
+
+static const char* path_names[PATH_COUNT] = {"polled", "batch", "burst"};
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+static double nowUs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+//Window setup as four polling transactions, end coordinates like LCD_batchWindow
+static void setWindowPolled(uint8_t x, uint8_t y, uint8_t x_end, uint8_t y_end)
+{
+	const uint8_t caset[4] = {0, x, 0, x_end};
+	const uint8_t raset[4] = {0, y, 0, y_end};
+
+	LCD_sendCommand(spi, CMD_CASET);
+	LCD_sendData(spi, caset, 4);
+	LCD_sendCommand(spi, CMD_RASET);
+	LCD_sendData(spi, raset, 4);
+}
+
+static void drawGlyph(path_t path, const LCD_glyph_t* glyph, uint8_t x, uint8_t y)
+{
+	const uint8_t w = glyph->width;
+	const uint8_t h = glyph->height;
+
+	switch (path)
+	{
+		case PATH_POLLED:
+			setWindowPolled(x, y, x + w - 1, y + h - 1);
+			LCD_sendGlyph(spi, glyph, &pal);
+			break;
+		case PATH_BATCH:
+			LCD_setDrawingWindow(spi, x, y, w - 1, h - 1);
+			LCD_sendGlyph(spi, glyph, &pal);
+			break;
+		default:
+			LCD_glyphExpand(glyph, &pal, 0, w * h, (uint8_t*)burst_buf);
+			LCD_waitFrame(LCD_sendWindowAsync(spi, x, y, w, h, (const uint8_t*)burst_buf, w * h * PIXEL_SIZE));
+			break;
+	}
+}
+
+//One clock tick worth of glyphs in panel coordinates
+static void drawText(path_t path, int y)
+{
+	uint8_t x = X_OFFSET + 4;
+
+	for (const char* c = TEXT; *c != '\0'; c++)
+	{
+		const LCD_glyph_t* glyph = FONT_findGlyph(&font_5x7, (uint8_t)*c);
+		drawGlyph(path, glyph, x, Y_OFFSET + y);
+		x += glyph->width + 1;
+	}
+}
+
+static result_t runPath(path_t path)
+{
+	const int y = TEXT_Y + path * ROW_GAP;
+	result_t r;
+
+	LCD_emuFrameEnd(NULL);
+	LCD_emuCalls(NULL);
+
+	const double start = nowUs();
+	for (int i = 0; i < TICKS; i++)
+	{
+		drawText(path, y);
+	}
+	r.wall_us = nowUs() - start;
+
+	LCD_emuFrameEnd(&r.bus);
+	LCD_emuCalls(&r.calls);
+
+	//pixel bytes take the same wire time on every path, leave them out
+	const double pixel_us = r.bus.pixel_bytes * 8.0 * 1e6 / LCD_busGetClock();
+	r.setup_us = r.bus.bus_ns / 1000.0 - pixel_us
+		+ r.calls.polled * COST_POLL_US + r.calls.queued * COST_QUEUE_US + r.calls.bursts * COST_BURST_US;
+	return r;
+}
+
+static uint16_t viewPixel(int x, int y)
+{
+	EMU_st7735s_t* emu = LCD_emuLock();
+	const uint16_t px = EMU_viewPixel(emu, x, y);
+	LCD_emuUnlock();
+	return px;
+}
+
+//Bands drawn by two paths are identical and not blank
+static bool bandsMatch(path_t a, path_t b)
+{
+	const int ya = TEXT_Y + a * ROW_GAP;
+	const int yb = TEXT_Y + b * ROW_GAP;
+	bool lit = false;
+
+	for (int j = 0; j < font_5x7.height; j++)
+	{
+		for (int i = 0; i < 40; i++)
+		{
+			const uint16_t pa = viewPixel(i, ya + j);
+			if (pa != viewPixel(i, yb + j))
+			{
+				return false;
+			}
+			lit |= (pa == FG);
+		}
+	}
+	return lit;
+}
+
+//Palette expansion of the clock digits against a memcpy of the same frames stored raw
+static void benchExpand(void)
+{
+	const int pixels = DISPLAY_NUMBERS_WIDTH * DISPLAY_NUMBERS_HEIGHT;
+	const double total_px = (double)EXPAND_ROUNDS * DISPLAY_NUMBERS_COUNT * pixels;
+	LCD_palette_t clock_pal;
+	int mismatched = 0;
+
+	LCD_paletteInit(&clock_pal, clock_palette_colors, GLYPH_DISPLAY_NUMBERS_BPP);
+	for (int d = 0; d < DISPLAY_NUMBERS_COUNT; d++)
+	{
+		LCD_glyphExpand(&glyph_display_numbers[d], &clock_pal, 0, pixels, (uint8_t*)digit_buf);
+		mismatched += (memcmp(digit_buf, raw_display_numbers[d], DISPLAY_NUMBERS_SIZE) != 0);
+	}
+
+	double start = nowUs();
+	for (int i = 0; i < EXPAND_ROUNDS; i++)
+	{
+		for (int d = 0; d < DISPLAY_NUMBERS_COUNT; d++)
+		{
+			LCD_glyphExpand(&glyph_display_numbers[d], &clock_pal, 0, pixels, (uint8_t*)digit_buf);
+			sink += digit_buf[i % (DISPLAY_NUMBERS_SIZE / 4)];
+		}
+	}
+	const double expand_us = nowUs() - start;
+
+	start = nowUs();
+	for (int i = 0; i < EXPAND_ROUNDS; i++)
+	{
+		for (int d = 0; d < DISPLAY_NUMBERS_COUNT; d++)
+		{
+			memcpy(digit_buf, raw_display_numbers[d], DISPLAY_NUMBERS_SIZE);
+			sink += digit_buf[i % (DISPLAY_NUMBERS_SIZE / 4)];
+		}
+	}
+	const double copy_us = nowUs() - start;
+
+	HOST_report("digit frames: expand %.2f ns/px  memcpy %.2f ns/px (%.1fx, host)  flash %d bytes indexed vs %d raw (%.0f%%)",
+		expand_us * 1000 / total_px, copy_us * 1000 / total_px, expand_us / copy_us,
+		DISPLAY_NUMBERS_COUNT * GLYPH_DISPLAY_NUMBERS_DATA_SIZE, DISPLAY_NUMBERS_COUNT * DISPLAY_NUMBERS_SIZE,
+		100.0 * GLYPH_DISPLAY_NUMBERS_DATA_SIZE / DISPLAY_NUMBERS_SIZE);
+
+	//the clock palette holds every color of the digits, expansion is lossless
+	CHECK_EQ(mismatched, 0);
+	CHECK(GLYPH_DISPLAY_NUMBERS_DATA_SIZE * 4 <= DISPLAY_NUMBERS_SIZE);
+}
+
+int main(void)
+{
+	const int glyphs = TICKS * (int)strlen(TEXT);
+	result_t r[PATH_COUNT];
+
+	LCD_emuInit();
+	CHECK_EQ(LCD_busInit(&spi, LCD_BUS_DEFAULT_HZ), ESP_OK);
+	LCD_init(spi);
+	LCD_fillRect(spi, X_OFFSET, Y_OFFSET, WIDTH, HEIGHT, BG);
+	FONT_makePalette(&pal, &font_5x7, FG, BG);
+
+	for (int p = 0; p < PATH_COUNT; p++)
+	{
+		r[p] = runPath(p);
+		HOST_report("%-6s per glyph: transactions %5.2f  polled %4.2f  queued %5.2f  bursts %4.2f  "
+			"setup %5.1f us (modelled)  host %5.2f us",
+			path_names[p], (double)r[p].bus.transactions / glyphs, (double)r[p].calls.polled / glyphs,
+			(double)r[p].calls.queued / glyphs, (double)r[p].calls.bursts / glyphs,
+			r[p].setup_us / glyphs, r[p].wall_us / glyphs);
+	}
+	HOST_report("setup per glyph: batch %.0f%%, burst %.0f%% of polled",
+		100.0 * r[PATH_BATCH].setup_us / r[PATH_POLLED].setup_us,
+		100.0 * r[PATH_BURST].setup_us / r[PATH_POLLED].setup_us);
+
+	//same bytes on the wire, only the way they are handed to the driver changes
+	CHECK_EQ(r[PATH_BATCH].bus.bytes, r[PATH_POLLED].bus.bytes);
+	CHECK_EQ(r[PATH_BURST].bus.bytes, r[PATH_POLLED].bus.bytes);
+	CHECK_EQ(r[PATH_POLLED].bus.windows, 2 * glyphs);
+	CHECK_EQ(r[PATH_BURST].bus.ramwr, glyphs);
+
+	CHECK_EQ(r[PATH_POLLED].calls.polled, 4 * glyphs);
+	CHECK_EQ(r[PATH_BATCH].calls.polled, 0);
+	CHECK_EQ(r[PATH_BURST].calls.polled, 0);
+	CHECK_EQ(r[PATH_BURST].calls.bursts, glyphs);
+
+	CHECK(r[PATH_BATCH].setup_us < r[PATH_POLLED].setup_us);
+	CHECK(r[PATH_BURST].setup_us < r[PATH_BATCH].setup_us);
+
+	CHECK(bandsMatch(PATH_POLLED, PATH_BATCH));
+	CHECK(bandsMatch(PATH_POLLED, PATH_BURST));
+
+	benchExpand();
+
+	EMU_st7735s_t* emu = LCD_emuLock();
+	CHECK_EQ(emu->unknown_cmds, 0);
+	CHECK_EQ(emu->bad_params, 0);
+	CHECK_EQ(emu->bad_pixels, 0);
+	LCD_emuUnlock();
+
+	LCD_emuDump(HOST_FRAME_DIR "/glyph_paths.png");
+	return HOST_testDone("test_glyph");
+}
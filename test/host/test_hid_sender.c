@@ -0,0 +1,513 @@
+/**
+ * @file test_hid_sender.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief HID sender against a fake transport
+ *
+ * The fake transport logs every report, confirms it right away and can refuse
+ * releases, so the host side key state can be followed report by report. For
+ * the throughput benchmark it confirms through a fake link instead, with a
+ * fixed delay per report, and actions/second are measured for one action at
+ * a time (press/release pairs) against batches, which pack two consumer
+ * usages per press report.
+ *
+ * Queue to send latency is the time from HIDSender_send to the press report
+ * reaching the fake, for a lone press and for a press queued behind one still
+ * in flight. Both have to stay well under the 100 ms the old blocking send
+ * held every press for. Over the fake link the button to confirmed press
+ * latency may only add the link's delay, for the press and for the release
+ * ahead of it.
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <string.h>
+#include <unistd.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_timer.h"
+#include "hid_sender.h"
+#include "power_mgmt.h"
+#include "host_test.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define LOG_MAX      512
+#define WAIT_MS      2000
+
+/* Rough Classic link: confirmed a few slots after the hand over, one report per 625 us slot. */
+#define LINK_LATENCY_US  5000
+#define LINK_REPORT_US   625
+#define LINK_QUEUE       32
+#define LINK_STACK       2048
+
+#define BENCH_ACTIONS    64
+
+#define LATENCY_PRESSES    20
+#define QUEUE_SEND_MAX_US  10000   //lone press, queue to the transport
+#define BEHIND_MAX_US      (HID_SENDER_HOLD_MS * 1000 + QUEUE_SEND_MAX_US)   //press queued behind a pair in flight
+#define CONFIRM_SLACK_US   10000   //host scheduling on top of the link latency
+#define BLOCKING_SEND_US   100000  //what the old send held every press for
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+typedef struct {
+	uint8_t id;
+	uint16_t usage;   //0 for a release
+	uint16_t usage2;  //second consumer slot, 0 unless two taps share the report
+	int64_t time_us;  //handed to the transport
+} report_t;
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static report_t reports[LOG_MAX];
+static int report_count = 0;
+static int refuse_releases = 0;  //next releases the fake refuses
+static portMUX_TYPE fake_lock = portMUX_INITIALIZER_UNLOCKED;
+
+//confirmations through the fake link, send times in order
+static volatile bool link_on = false;
+static QueueHandle_t link_queue;
+static StaticQueue_t link_queue_buf;
+static uint8_t link_storage[LINK_QUEUE * sizeof(int64_t)];
+static StaticTask_t link_task_buf;
+static StackType_t link_task_stack[LINK_STACK];
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+//The sender wakes the CPU before each send, nothing to do on the host
+void POWER_requestWake(POWER_source_t src)
+{
+}
+
+static esp_err_t fakeInit(const uint8_t* report_map, int report_map_len)
+{
+	return ESP_OK;
+}
+
+static esp_err_t fakeSend(uint8_t report_id, uint8_t* data, uint16_t len)
+{
+	const uint16_t usage = (report_id == HID_REPORT_ID_KEYBOARD) ? data[2] : (data[0] | (data[1] << 8));
+	const uint16_t usage2 = (report_id == HID_REPORT_ID_CONSUMER) ? (data[2] | (data[3] << 8)) : 0;
+
+	taskENTER_CRITICAL(&fake_lock);
+	if (usage == 0 && refuse_releases > 0)
+	{
+		refuse_releases--;
+		taskEXIT_CRITICAL(&fake_lock);
+		return ESP_FAIL;
+	}
+	if (report_count < LOG_MAX)
+	{
+		reports[report_count].id = report_id;
+		reports[report_count].usage = usage;
+		reports[report_count].usage2 = usage2;
+		reports[report_count].time_us = esp_timer_get_time();
+		report_count++;
+	}
+	taskEXIT_CRITICAL(&fake_lock);
+
+	if (link_on)
+	{
+		const int64_t now = esp_timer_get_time();
+		xQueueSend(link_queue, &now, portMAX_DELAY);
+		return ESP_OK;
+	}
+	HIDSender_reportSent(true);
+	return ESP_OK;
+}
+
+//Confirms each report LINK_LATENCY_US after it was sent, at most one per LINK_REPORT_US
+static void fakeLinkTask(void* arg)
+{
+	int64_t sent_us;
+	int64_t last_us = 0;
+
+	for (;;)
+	{
+		xQueueReceive(link_queue, &sent_us, portMAX_DELAY);
+		int64_t due = sent_us + LINK_LATENCY_US;
+		due = (due > last_us + LINK_REPORT_US) ? due : last_us + LINK_REPORT_US;
+		const int64_t wait = due - esp_timer_get_time();
+		if (wait > 0)
+		{
+			usleep(wait);
+		}
+		last_us = due;
+		HIDSender_reportSent(true);
+	}
+}
+
+static const HID_transport_t fake_transport = {
+	.name = "fake",
+	.init = fakeInit,
+	.send = fakeSend,
+	.activity = NULL,
+};
+
+static void resetLog(int refuse)
+{
+	taskENTER_CRITICAL(&fake_lock);
+	report_count = 0;
+	refuse_releases = refuse;
+	taskEXIT_CRITICAL(&fake_lock);
+}
+
+//Wait for the sender to finish actions_sent + failed actions, then let stray reports land
+static bool waitActions(const HID_sender_stats_t* before, uint32_t sent, uint32_t errors)
+{
+	HID_sender_stats_t now;
+	const int64_t end = esp_timer_get_time() + WAIT_MS * 1000LL;
+
+	do
+	{
+		HIDSender_getStats(&now);
+		if (now.actions_sent - before->actions_sent >= sent && now.send_errors - before->send_errors >= errors)
+		{
+			usleep(2 * HID_SENDER_ACK_TIMEOUT_MS * 1000);
+			return true;
+		}
+		usleep(1000);
+	} while (esp_timer_get_time() < end);
+	return false;
+}
+
+//No key down once every report has been seen
+static bool allReleased(void)
+{
+	uint16_t down = 0;
+	for (int i = 0; i < report_count; i++)
+	{
+		if (reports[i].id != HID_REPORT_ID_VOLUME)
+		{
+			down = reports[i].usage;
+		}
+	}
+	return down == 0;
+}
+
+static const HID_action_t tap_next = {HID_ACTION_CONSUMER, 0, HID_USAGE_NEXT_TRACK};
+static const HID_action_t tap_prev = {HID_ACTION_CONSUMER, 0, HID_USAGE_PREV_TRACK};
+static const HID_action_t tap_play = {HID_ACTION_CONSUMER, 0, HID_USAGE_PLAY_PAUSE};
+
+static void testBatchRefusedRelease(void)
+{
+	const HID_action_t batch[3] = {tap_next, tap_prev, tap_play};
+	HID_sender_stats_t before, after;
+
+	HIDSender_getStats(&before);
+	resetLog(1);
+	CHECK_EQ(HIDSender_sendBatch(batch, 3), ESP_OK);
+	CHECK(waitActions(&before, 3, 1));
+	HIDSender_getStats(&after);
+
+	CHECK_EQ(after.actions_sent - before.actions_sent, 3);
+	CHECK_EQ(after.send_errors - before.send_errors, 1);
+	CHECK_EQ(after.packed - before.packed, 1);
+	//the first two taps share a press, its refused release goes out again before the next press
+	CHECK_EQ(report_count, 4);
+	CHECK_EQ(reports[0].usage, HID_USAGE_NEXT_TRACK);
+	CHECK_EQ(reports[0].usage2, HID_USAGE_PREV_TRACK);
+	CHECK_EQ(reports[1].usage, 0);
+	CHECK_EQ(reports[1].usage2, 0);
+	CHECK_EQ(reports[2].usage, HID_USAGE_PLAY_PAUSE);
+	CHECK_EQ(reports[2].usage2, 0);
+	CHECK_EQ(reports[3].usage, 0);
+	CHECK(allReleased());
+}
+
+static void testPairRefusedRelease(void)
+{
+	HID_sender_stats_t before, after;
+
+	HIDSender_getStats(&before);
+	resetLog(HID_SENDER_RELEASE_TRIES - 1);
+	CHECK_EQ(HIDSender_send(&tap_play), ESP_OK);
+	CHECK(waitActions(&before, 1, HID_SENDER_RELEASE_TRIES - 1));
+	HIDSender_getStats(&after);
+
+	CHECK_EQ(after.actions_sent - before.actions_sent, 1);
+	CHECK_EQ(report_count, 2);
+	CHECK_EQ(reports[0].usage, HID_USAGE_PLAY_PAUSE);
+	CHECK_EQ(reports[1].usage, 0);
+	CHECK(allReleased());
+}
+
+static void testReleaseGivenUp(void)
+{
+	const HID_action_t batch[2] = {tap_next, tap_next};
+	HID_sender_stats_t before, after;
+
+	//the same usage twice cannot share a report, the first tap's release never goes out
+	//and the sender moves on to the second after the last try
+	HIDSender_getStats(&before);
+	resetLog(HID_SENDER_RELEASE_TRIES);
+	CHECK_EQ(HIDSender_sendBatch(batch, 2), ESP_OK);
+	CHECK(waitActions(&before, 1, HID_SENDER_RELEASE_TRIES));
+	HIDSender_getStats(&after);
+
+	CHECK_EQ(after.actions_sent - before.actions_sent, 1);
+	CHECK_EQ(after.send_errors - before.send_errors, HID_SENDER_RELEASE_TRIES);
+	CHECK_EQ(after.packed - before.packed, 0);
+	CHECK_EQ(report_count, 3);
+	CHECK_EQ(reports[0].usage, HID_USAGE_NEXT_TRACK);
+	CHECK_EQ(reports[1].usage, HID_USAGE_NEXT_TRACK);
+	CHECK_EQ(reports[2].usage, 0);
+}
+
+//Time of the first report carrying usage, -1 if it never came
+static int64_t pressTime(uint16_t usage)
+{
+	const int64_t end = esp_timer_get_time() + WAIT_MS * 1000LL;
+
+	do
+	{
+		taskENTER_CRITICAL(&fake_lock);
+		for (int i = 0; i < report_count; i++)
+		{
+			if (reports[i].usage == usage)
+			{
+				const int64_t t = reports[i].time_us;
+				taskEXIT_CRITICAL(&fake_lock);
+				return t;
+			}
+		}
+		taskEXIT_CRITICAL(&fake_lock);
+		usleep(100);
+	} while (esp_timer_get_time() < end);
+	return -1;
+}
+
+//Queue to send latency of lone presses and of presses queued behind one in flight
+static void testLatency(void)
+{
+	HID_sender_stats_t before, after;
+	int64_t lone_max = 0;
+	int64_t lone_sum = 0;
+	int64_t behind_max = 0;
+
+	HIDSender_getStats(&before);
+	for (int i = 0; i < LATENCY_PRESSES; i++)
+	{
+		HID_sender_stats_t start;
+
+		HIDSender_getStats(&start);
+		resetLog(0);
+		const int64_t queued = esp_timer_get_time();
+		CHECK_EQ(HIDSender_send(&tap_next), ESP_OK);
+		const int64_t sent = pressTime(HID_USAGE_NEXT_TRACK);
+		CHECK(sent >= queued);
+		lone_sum += sent - queued;
+		lone_max = (sent - queued > lone_max) ? sent - queued : lone_max;
+
+		//the press is on the host and held, the next one waits for its release
+		const int64_t queued_behind = esp_timer_get_time();
+		CHECK_EQ(HIDSender_send(&tap_prev), ESP_OK);
+		const int64_t sent_behind = pressTime(HID_USAGE_PREV_TRACK);
+		CHECK(sent_behind >= queued_behind);
+		behind_max = (sent_behind - queued_behind > behind_max) ? sent_behind - queued_behind : behind_max;
+
+		CHECK(waitActions(&start, 2, 0));
+		CHECK(allReleased());
+	}
+	HIDSender_getStats(&after);
+
+	const uint32_t pairs = after.pairs_sent - before.pairs_sent;
+	HOST_report("queue to send: lone press avg %.0f us max %" PRId64 " us, behind a held press max %" PRId64 " us (hold %d ms)",
+		(double)lone_sum / LATENCY_PRESSES, lone_max, behind_max, HID_SENDER_HOLD_MS);
+	HOST_report("button to confirmed press avg %.0f us max %" PRId64 " us (instant confirmation)",
+		(double)(after.latency_sum_us - before.latency_sum_us) / (pairs ? pairs : 1), after.latency_max_us);
+
+	CHECK_EQ(after.actions_sent - before.actions_sent, 2 * LATENCY_PRESSES);
+	CHECK_EQ(after.send_errors - before.send_errors, 0);
+	CHECK(lone_max < QUEUE_SEND_MAX_US);
+	CHECK(behind_max < BEHIND_MAX_US);
+	CHECK(behind_max < BLOCKING_SEND_US);
+	//confirmation is instant, a press waits at most for the hold ahead of it
+	CHECK(after.latency_max_us < BEHIND_MAX_US);
+}
+
+//Wait for actions_sent to reach target without letting reports settle
+static bool waitSent(uint32_t target)
+{
+	HID_sender_stats_t now;
+	const int64_t end = esp_timer_get_time() + WAIT_MS * 1000LL;
+
+	do
+	{
+		HIDSender_getStats(&now);
+		if (now.actions_sent >= target)
+		{
+			return true;
+		}
+		usleep(100);
+	} while (esp_timer_get_time() < end);
+	return false;
+}
+
+//Taps alternate between two usages so every report can be matched
+static bool tapsInOrder(int taps)
+{
+	if (report_count != 2 * taps)
+	{
+		return false;
+	}
+	for (int i = 0; i < taps; i++)
+	{
+		const uint16_t usage = (i & 1) ? HID_USAGE_PREV_TRACK : HID_USAGE_NEXT_TRACK;
+		if (reports[2 * i].usage != usage || reports[2 * i].usage2 != 0 || reports[2 * i + 1].usage != 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+//Batched taps share press reports two by two, each press followed by its release
+static bool packedInOrder(int taps)
+{
+	if (report_count != taps)
+	{
+		return false;
+	}
+	for (int i = 0; i < taps / 2; i++)
+	{
+		if (reports[2 * i].usage != HID_USAGE_NEXT_TRACK || reports[2 * i].usage2 != HID_USAGE_PREV_TRACK
+			|| reports[2 * i + 1].usage != 0 || reports[2 * i + 1].usage2 != 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static double benchPairs(HID_sender_stats_t* delta)
+{
+	HID_sender_stats_t before;
+
+	HIDSender_getStats(&before);
+	resetLog(0);
+	const int64_t start = esp_timer_get_time();
+	for (int i = 0; i < BENCH_ACTIONS; i++)
+	{
+		//one at a time, each one a press, a hold and a release
+		CHECK_EQ(HIDSender_send((i & 1) ? &tap_prev : &tap_next), ESP_OK);
+		if (!waitSent(before.actions_sent + i + 1))
+		{
+			break;
+		}
+	}
+	const int64_t elapsed = esp_timer_get_time() - start;
+	usleep(2 * LINK_LATENCY_US);
+
+	HIDSender_getStats(delta);
+	delta->actions_sent -= before.actions_sent;
+	delta->pairs_sent -= before.pairs_sent;
+	delta->batches -= before.batches;
+	delta->packed -= before.packed;
+	delta->reports_sent -= before.reports_sent;
+	delta->send_errors -= before.send_errors;
+	delta->busy_us -= before.busy_us;
+	delta->latency_sum_us -= before.latency_sum_us;
+	return BENCH_ACTIONS * 1e6 / elapsed;
+}
+
+static double benchBatches(HID_sender_stats_t* delta)
+{
+	HID_action_t batch[HID_SENDER_QUEUE_DEPTH];
+	HID_sender_stats_t before;
+
+	for (int i = 0; i < HID_SENDER_QUEUE_DEPTH; i++)
+	{
+		batch[i] = (i & 1) ? tap_prev : tap_next;
+	}
+
+	HIDSender_getStats(&before);
+	resetLog(0);
+	const int64_t start = esp_timer_get_time();
+	for (int i = 0; i < BENCH_ACTIONS; i += HID_SENDER_QUEUE_DEPTH)
+	{
+		CHECK_EQ(HIDSender_sendBatch(batch, HID_SENDER_QUEUE_DEPTH), ESP_OK);
+		if (!waitSent(before.actions_sent + i + HID_SENDER_QUEUE_DEPTH))
+		{
+			break;
+		}
+	}
+	const int64_t elapsed = esp_timer_get_time() - start;
+	usleep(2 * LINK_LATENCY_US);
+
+	HIDSender_getStats(delta);
+	delta->actions_sent -= before.actions_sent;
+	delta->pairs_sent -= before.pairs_sent;
+	delta->batches -= before.batches;
+	delta->packed -= before.packed;
+	delta->reports_sent -= before.reports_sent;
+	delta->send_errors -= before.send_errors;
+	delta->busy_us -= before.busy_us;
+	return BENCH_ACTIONS * 1e6 / elapsed;
+}
+
+//Actions per second over the fake link, one at a time against batches
+static void testThroughput(void)
+{
+	HID_sender_stats_t pairs, batches;
+
+	link_queue = xQueueCreateStatic(LINK_QUEUE, sizeof(int64_t), link_storage, &link_queue_buf);
+	xTaskCreateStatic(fakeLinkTask, "fake_link", LINK_STACK, NULL, 5, link_task_stack, &link_task_buf);
+	link_on = true;
+
+	const double pair_rate = benchPairs(&pairs);
+	CHECK_EQ(pairs.actions_sent, BENCH_ACTIONS);
+	CHECK_EQ(pairs.pairs_sent, BENCH_ACTIONS);
+	CHECK_EQ(pairs.send_errors, 0);
+	CHECK(tapsInOrder(BENCH_ACTIONS));
+	//a press is queued once the previous release is sent, it waits for that confirmation and its own
+	const double confirm_avg = (double)pairs.latency_sum_us / pairs.pairs_sent;
+	CHECK(confirm_avg >= LINK_LATENCY_US);
+	CHECK(confirm_avg < 2 * LINK_LATENCY_US + CONFIRM_SLACK_US);
+
+	const double batch_rate = benchBatches(&batches);
+	CHECK_EQ(batches.actions_sent, BENCH_ACTIONS);
+	CHECK_EQ(batches.batches, BENCH_ACTIONS / HID_SENDER_QUEUE_DEPTH);
+	CHECK_EQ(batches.send_errors, 0);
+	CHECK_EQ(batches.packed, BENCH_ACTIONS / 2);
+	CHECK_EQ(batches.reports_sent, BENCH_ACTIONS);
+	CHECK(packedInOrder(BENCH_ACTIONS));
+
+	link_on = false;
+
+	HOST_report("link %d us latency, %d us per report", LINK_LATENCY_US, LINK_REPORT_US);
+	HOST_report("pairs   %7.1f actions/s  (%.1f by busy time)  button to confirmed press avg %.0f us",
+		pair_rate, pairs.actions_sent * 1e6 / pairs.busy_us, confirm_avg);
+	HOST_report("batches %7.1f actions/s  (%.1f by busy time)  %.1fx  %.1f reports per action (pairs %.1f)", batch_rate,
+		batches.actions_sent * 1e6 / batches.busy_us, batch_rate / pair_rate,
+		(double)batches.reports_sent / batches.actions_sent, (double)pairs.reports_sent / pairs.actions_sent);
+
+	//a pair waits out the hold and two confirmations, a batch keeps HID_SENDER_WINDOW reports in flight
+	CHECK(batch_rate > 4 * pair_rate);
+}
+
+int main(void)
+{
+	CHECK_EQ(HIDSender_init(&fake_transport), ESP_OK);
+	HIDSender_setConnected(true);
+
+	testBatchRefusedRelease();
+	testPairRefusedRelease();
+	testReleaseGivenUp();
+	testLatency();
+	testThroughput();
+
+	return HOST_testDone("test_hid_sender");
+}
@@ -0,0 +1,325 @@
+/**
+ * @file test_hosts.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Reconnect to a cached host against a mocked GAP
+ *
+ * The GAP, HID device and NVS calls are mocked: a cache of three bonded hosts
+ * sits in the fake NVS and only the host set in range answers a page, the
+ * link opening PAGE_ANSWER_US later. Time runs on the manual esp_timer clock
+ * in STEP_US steps. The first report goes out as soon as the link opens, so
+ * the reconnect start to open time is the time to first report, measured with
+ * the most recent host in range, the last one in range, none in range (the
+ * non discoverable window has to end at HID_HOSTS_HIDDEN_MAX_MS) and a host
+ * coming in on its own while the device pages. No page may be started from
+ * the timer callback.
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+#include "esp_gap_bt_api.h"
+#include "esp_hidd_api.h"
+#include "nvs.h"
+#include "hid_hosts.h"
+#include "host_shim.h"
+#include "host_test.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define HOSTS            3
+#define STEP_US          1000
+#define PAGE_ANSWER_US   150000     //page to link open for a host in range
+#define SETTLE_MS        1000       //longest wait for the hosts task after a timer
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static const esp_bd_addr_t addrs[HOSTS] = {
+	{0x10, 0x00, 0x00, 0x00, 0x00, 0x0A},
+	{0x10, 0x00, 0x00, 0x00, 0x00, 0x0B},
+	{0x10, 0x00, 0x00, 0x00, 0x00, 0x0C},
+};
+
+static portMUX_TYPE mock_lock = portMUX_INITIALIZER_UNLOCKED;
+static pthread_t test_thread;
+static volatile bool advancing = false;    //test thread inside HOST_clockAdvance, running timer callbacks
+
+//fake NVS
+static uint8_t nvs_blob[HID_HOSTS_MAX * sizeof(HID_host_t)];
+static size_t nvs_len = 0;
+
+//mocked GAP
+static int in_range = -1;                  //host that answers a page, -1 for none
+static int pages = 0;
+static int pages_in_timer = 0;
+static bool discoverable = false;
+static bool connectable = true;
+static int64_t open_at_us = -1;            //pending link open, -1 for none
+static int open_host;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+esp_err_t nvs_open(const char* name, nvs_open_mode_t open_mode, nvs_handle_t* out_handle)
+{
+	*out_handle = 1;
+	return ESP_OK;
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char* key, void* out_value, size_t* length)
+{
+	if (nvs_len == 0)
+	{
+		return ESP_ERR_NVS_NOT_FOUND;
+	}
+	if (*length < nvs_len)
+	{
+		return ESP_ERR_INVALID_SIZE;
+	}
+	memcpy(out_value, nvs_blob, nvs_len);
+	*length = nvs_len;
+	return ESP_OK;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char* key, const void* value, size_t length)
+{
+	memcpy(nvs_blob, value, length);
+	nvs_len = length;
+	return ESP_OK;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+	return ESP_OK;
+}
+
+esp_err_t esp_bt_gap_get_bond_device_list(int* dev_num, esp_bd_addr_t* dev_list)
+{
+	*dev_num = HOSTS;
+	memcpy(dev_list, addrs, sizeof(addrs));
+	return ESP_OK;
+}
+
+esp_err_t esp_bt_gap_read_rssi_delta(esp_bd_addr_t remote_addr)
+{
+	return ESP_OK;
+}
+
+esp_err_t esp_bt_gap_set_scan_mode(esp_bt_connection_mode_t c_mode, esp_bt_discovery_mode_t d_mode)
+{
+	taskENTER_CRITICAL(&mock_lock);
+	connectable = (c_mode == ESP_BT_CONNECTABLE);
+	discoverable = (d_mode != ESP_BT_NON_DISCOVERABLE);
+	taskEXIT_CRITICAL(&mock_lock);
+	return ESP_OK;
+}
+
+esp_err_t esp_bt_hid_device_connect(esp_bd_addr_t bd_addr)
+{
+	taskENTER_CRITICAL(&mock_lock);
+	pages++;
+	pages_in_timer += (advancing && pthread_equal(pthread_self(), test_thread));
+	if (in_range >= 0 && memcmp(bd_addr, addrs[in_range], ESP_BD_ADDR_LEN) == 0)
+	{
+		open_at_us = esp_timer_get_time() + PAGE_ANSWER_US;
+		open_host = in_range;
+	}
+	taskEXIT_CRITICAL(&mock_lock);
+	return ESP_OK;
+}
+
+static bool isDiscoverable(void)
+{
+	taskENTER_CRITICAL(&mock_lock);
+	const bool d = discoverable;
+	taskEXIT_CRITICAL(&mock_lock);
+	return d;
+}
+
+//One clock step, then wait for the hosts task to handle a timer that fired
+static void step(void)
+{
+	const bool armed = HOST_timersArmed() > 0;
+
+	advancing = true;
+	HOST_clockAdvance(STEP_US);
+	advancing = false;
+
+	//the task ends every timer by arming it again or by going discoverable
+	if (armed && HOST_timersArmed() == 0)
+	{
+		for (int i = 0; i < SETTLE_MS && HOST_timersArmed() == 0 && !isDiscoverable(); i++)
+		{
+			usleep(1000);
+		}
+	}
+}
+
+//Run the clock until the link opens or the device goes discoverable, time to first report or -1
+static int64_t runUntilOpen(int64_t start_us, int64_t limit_us, bool* stayed_connectable)
+{
+	*stayed_connectable = true;
+	while (esp_timer_get_time() - start_us < limit_us)
+	{
+		step();
+
+		taskENTER_CRITICAL(&mock_lock);
+		const bool open = (open_at_us >= 0 && esp_timer_get_time() >= open_at_us);
+		const bool gave_up = discoverable;
+		*stayed_connectable &= connectable;
+		taskEXIT_CRITICAL(&mock_lock);
+
+		if (open)
+		{
+			open_at_us = -1;
+			//ESP_HIDD_OPEN_EVT, the sender sends what is queued right away
+			HIDHosts_connected(addrs[open_host]);
+			return esp_timer_get_time() - start_us;
+		}
+		if (gave_up)
+		{
+			return -1;
+		}
+	}
+	return -1;
+}
+
+static void seedCache(void)
+{
+	HID_host_t cache[HOSTS];
+
+	memset(cache, 0, sizeof(cache));
+	for (int i = 0; i < HOSTS; i++)
+	{
+		memcpy(cache[i].addr, addrs[i], ESP_BD_ADDR_LEN);
+		cache[i].connects = 1;
+	}
+	nvs_set_blob(1, "hosts", cache, sizeof(cache));
+}
+
+//The most recent host is in range, it is paged first
+static void testRecentHost(void)
+{
+	HID_hosts_stats_t stats;
+	bool stayed;
+
+	in_range = 0;
+	pages = 0;
+	const int64_t start = esp_timer_get_time();
+	HIDHosts_reconnect(NULL);
+	const int64_t first_report = runUntilOpen(start, 5000000, &stayed);
+	HIDHosts_getStats(&stats);
+
+	HOST_report("recent host in range: first report %6.1f ms after reconnect, %d page", first_report / 1000.0, pages);
+	CHECK_EQ(first_report, PAGE_ANSWER_US);
+	CHECK_EQ(stats.reconnect_us, PAGE_ANSWER_US);
+	CHECK_EQ(pages, 1);
+	CHECK(stayed);
+	CHECK(!isDiscoverable());
+	CHECK_EQ(HOST_timersArmed(), 0);
+}
+
+//The last cached host is in range, the others time out first
+static void testLastHost(void)
+{
+	HID_host_t cache[HID_HOSTS_MAX];
+	bool stayed;
+
+	in_range = 2;
+	pages = 0;
+	const int64_t start = esp_timer_get_time();
+	HIDHosts_disconnected();
+	const int64_t first_report = runUntilOpen(start, 60000000, &stayed);
+
+	HOST_report("last host in range:   first report %6.1f ms after reconnect, %d pages", first_report / 1000.0, pages);
+	CHECK_EQ(first_report, 2 * HID_HOSTS_PAGE_TIMEOUT_MS * 1000LL + PAGE_ANSWER_US);
+	CHECK_EQ(pages, 3);
+	CHECK(stayed);
+	CHECK(!isDiscoverable());
+
+	//it moves to the front and is paged first next time
+	CHECK_EQ(HIDHosts_get(cache), HOSTS);
+	CHECK(memcmp(cache[0].addr, addrs[2], ESP_BD_ADDR_LEN) == 0);
+	CHECK_EQ(cache[0].connects, 2);
+}
+
+//Nobody in range, the non discoverable window ends at the cap
+static void testNoHost(void)
+{
+	HID_hosts_stats_t before, after;
+	bool stayed;
+
+	in_range = -1;
+	pages = 0;
+	HIDHosts_getStats(&before);
+	const int64_t start = esp_timer_get_time();
+	HIDHosts_disconnected();
+	CHECK_EQ(runUntilOpen(start, 120000000, &stayed), -1);
+	const int64_t hidden = esp_timer_get_time() - start;
+	HIDHosts_getStats(&after);
+
+	HOST_report("no host in range:     discoverable after %6.1f ms, %d pages", hidden / 1000.0, pages);
+	CHECK(isDiscoverable());
+	CHECK(stayed);
+	CHECK_EQ(hidden, HID_HOSTS_HIDDEN_MAX_MS * 1000LL);
+	CHECK_EQ(after.fallbacks, before.fallbacks + 1);
+	CHECK_EQ(HOST_timersArmed(), 0);
+}
+
+//A host connects on its own while the device pages someone else
+static void testIncoming(void)
+{
+	HID_hosts_stats_t stats;
+	bool stayed;
+
+	in_range = -1;
+	pages = 0;
+	const int64_t start = esp_timer_get_time();
+	HIDHosts_reconnect(NULL);
+	CHECK(!isDiscoverable());
+	CHECK_EQ(runUntilOpen(start, 2000000, &stayed), -1);
+	HIDHosts_connected(addrs[1]);
+	HIDHosts_getStats(&stats);
+	const int pages_then = pages;
+
+	//paging is over, nothing left to fire
+	while (esp_timer_get_time() - start < 20000000)
+	{
+		step();
+	}
+
+	HOST_report("host comes in:        connected %6.1f ms after reconnect, %d page", stats.reconnect_us / 1000.0, pages_then);
+	CHECK(stayed);
+	CHECK_EQ(stats.reconnect_us, 2000000);
+	CHECK_EQ(pages, pages_then);
+	CHECK(!isDiscoverable());
+	CHECK_EQ(HOST_timersArmed(), 0);
+}
+
+int main(void)
+{
+	test_thread = pthread_self();
+	HOST_clockSetManual(0);
+	seedCache();
+	CHECK_EQ(HIDHosts_init(), ESP_OK);
+
+	testRecentHost();
+	testLastHost();
+	testNoHost();
+	testIncoming();
+
+	//the esp_timer callback only wakes the hosts task
+	CHECK_EQ(pages_in_timer, 0);
+	return HOST_testDone("test_hosts");
+}
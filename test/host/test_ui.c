@@ -0,0 +1,364 @@
+/**
+ * @file test_ui.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Watch face handlers, layout and render cost per clock tick
+ *
+ * Builds the firmware's watch face (watch_face.c) on the app bus and plays a
+ * day of minute ticks through its display handler by posting clock ticks,
+ * the way the clock does. The clock, battery and power calls the handler
+ * makes are mocked: they hand it the test's time and level and timestamp the
+ * property setters (layout and damage) apart from the commit (rasterizing
+ * and sending). The bus traffic per tick is compared with a full frame. A
+ * few ticks are checked for minimal damage, the scroll transitions of the
+ * time and the media icon must leave what a plain redraw leaves, and the heap
+ * must not move once the widgets exist.
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <assert.h>
+#include <sched.h>
+#include <string.h>
+#include <time.h>
+#include <malloc.h>
+#include "display_main.h"
+#include "display_bus.h"
+#include "display_fb.h"
+#include "display_anim.h"
+#include "display_ui.h"
+#include "display_assets.h"
+#include "watch_face.h"
+#include "watch_clock.h"
+#include "battery.h"
+#include "power_mgmt.h"
+#include "app_bus.h"
+#include "lcd_port_emu.h"
+#include "host_test.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define TICKS          (24 * 60)
+#define WAIT_MS        2000
+#define REGION_MAX     (WIDTH * 48)
+
+/************************************************
+ *  TYPE DEFINITIONS
+ ***********************************************/
+
+typedef struct {
+	double layout_us;      //handler start to the wake before the commit
+	double render_us;      //UI_commit, to the handler returning
+	uint32_t pixel_bytes;
+} tick_t;
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static spi_device_handle_t spi;
+static FACE_widgets_t face;
+
+//what the mocks hand the handler, and when it called them (dispatcher task)
+static struct tm clock_now;
+static int battery_percent;
+static double handler_start_us;
+static double commit_start_us;
+
+static uint16_t reference[REGION_MAX];
+static uint16_t shown[REGION_MAX];
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+static double nowUs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+//The handler starts by reading the time
+void CLOCK_getTime(struct tm* now)
+{
+	handler_start_us = nowUs();
+	*now = clock_now;
+}
+
+//The mock reads the level straight through as millivolts
+esp_err_t BATTERY_readMv(int* mv)
+{
+	*mv = battery_percent;
+	return ESP_OK;
+}
+
+int BATTERY_percent(int mv)
+{
+	return mv;
+}
+
+//Woken right before every commit
+void POWER_requestWake(POWER_source_t src)
+{
+	commit_start_us = nowUs();
+}
+
+static uint32_t dispatched(BUS_msg_type_t type)
+{
+	BUS_stats_t stats;
+	BUS_getStats(&stats);
+	return stats.types[type].dispatched;
+}
+
+//Wait until more than count messages of type went through their handlers
+static bool waitDispatched(BUS_msg_type_t type, uint32_t count)
+{
+	const double end = nowUs() + WAIT_MS * 1000.0;
+
+	while (dispatched(type) <= count)
+	{
+		if (nowUs() > end)
+		{
+			return false;
+		}
+		sched_yield();
+	}
+	return true;
+}
+
+//Post a message and wait for the dispatcher to handle it
+static void postAndWait(const BUS_msg_t* msg)
+{
+	const uint32_t before = dispatched(msg->type);
+	CHECK_EQ(BUS_post(msg), ESP_OK);
+	CHECK(waitDispatched(msg->type, before));
+}
+
+//One clock tick through the face's display handler
+static tick_t tick(const struct tm* now, int battery)
+{
+	const BUS_msg_t msg = {.type = BUS_MSG_CLOCK_TICK};
+	EMU_counters_t c;
+	tick_t t;
+
+	clock_now = *now;
+	battery_percent = battery;
+	LCD_emuFrameEnd(NULL);
+	postAndWait(&msg);
+	const double end = nowUs();
+	t.layout_us = commit_start_us - handler_start_us;
+	t.render_us = end - commit_start_us;
+
+	LCD_emuFrameEnd(&c);
+	t.pixel_bytes = c.pixel_bytes;
+	return t;
+}
+
+static void showIcon(int index, bool forward)
+{
+	const BUS_msg_t msg = {.type = BUS_MSG_ICON, .data.icon = {.index = index, .forward = forward}};
+	postAndWait(&msg);
+}
+
+//What the glass shows inside a widget
+static void snapshot(int id, uint16_t* out)
+{
+	const FB_rect_t r = UI_getBounds(id);
+	assert(r.w * r.h <= REGION_MAX);
+
+	EMU_st7735s_t* emu = LCD_emuLock();
+	for (int j = 0; j < r.h; j++)
+	{
+		for (int i = 0; i < r.w; i++)
+		{
+			*out++ = EMU_viewPixel(emu, r.x + i, r.y + j);
+		}
+	}
+	LCD_emuUnlock();
+}
+
+static bool regionMatches(int id)
+{
+	const FB_rect_t r = UI_getBounds(id);
+	snapshot(id, shown);
+	return memcmp(shown, reference, r.w * r.h * sizeof(uint16_t)) == 0;
+}
+
+static bool rectIs(FB_rect_t r, uint16_t color)
+{
+	bool ok = true;
+	EMU_st7735s_t* emu = LCD_emuLock();
+	for (int j = r.y; j < r.y + r.h && ok; j++)
+	{
+		for (int i = r.x; i < r.x + r.w && ok; i++)
+		{
+			ok = (EMU_viewPixel(emu, i, j) == color);
+		}
+	}
+	LCD_emuUnlock();
+	return ok;
+}
+
+//Single changes damage only what they touch
+static void testDamage(void)
+{
+	struct tm now = {.tm_year = 126, .tm_mon = 9, .tm_mday = 16, .tm_hour = 12, .tm_min = 34};
+	mktime(&now);
+
+	tick(&now, 80);
+
+	//nothing changed
+	tick_t t = tick(&now, 80);
+	CHECK_EQ(t.pixel_bytes, 0);
+
+	//last minute digit
+	now.tm_min = 35;
+	t = tick(&now, 80);
+	CHECK_EQ(t.pixel_bytes, glyph_display_numbers[0].width * glyph_display_numbers[0].height * PIXEL_SIZE);
+
+	//gauge level only
+	t = tick(&now, 50);
+	CHECK(t.pixel_bytes > 0);
+	CHECK(t.pixel_bytes <= UI_BATTERY_WIDTH * UI_BATTERY_HEIGHT * PIXEL_SIZE);
+
+	//narrower text recenters the label, what it no longer covers goes back to the background
+	UI_stats_t before;
+	UI_stats_t after;
+	const FB_rect_t wide = UI_getBounds(face.date);
+	UI_getStats(&before);
+	UI_setText(face.date, "16 Oct");
+	UI_commit();
+	UI_getStats(&after);
+	const FB_rect_t narrow = UI_getBounds(face.date);
+	HOST_report("label relayout: %d px wide at x %d -> %d px wide at x %d", wide.w, wide.x, narrow.w, narrow.x);
+	CHECK_EQ(after.relayouts, before.relayouts + 1);
+	CHECK(narrow.w < wide.w);
+	CHECK(rectIs((FB_rect_t){wide.x, wide.y, narrow.x - wide.x, wide.h}, FACE_BACKGROUND));
+	CHECK(!rectIs(narrow, FACE_BACKGROUND));
+}
+
+//Transitions end the way a plain redraw does, the flush after them comes from the dispatcher
+static void testAnimated(void)
+{
+	struct tm now = {.tm_year = 126, .tm_mon = 9, .tm_mday = 16, .tm_hour = 12, .tm_min = 34};
+	ANIM_stats_t before, after;
+	mktime(&now);
+
+	//plain references
+	FACE_setAnimated(false);
+	tick(&now, 80);
+	now.tm_min = 35;
+	tick(&now, 80);
+	snapshot(face.clock, reference);
+	now.tm_min = 34;
+	tick(&now, 80);
+
+	FACE_setAnimated(true);
+	ANIM_getStats(&before);
+	uint32_t redraws = dispatched(BUS_MSG_REDRAW);
+	now.tm_min = 35;
+	tick(&now, 80);
+	CHECK(waitDispatched(BUS_MSG_REDRAW, redraws));
+	ANIM_getStats(&after);
+	HOST_report("clock transition: %u frames, %u bytes, redraw after it dispatched", after.frames - before.frames,
+		after.bytes - before.bytes);
+	CHECK_EQ(after.transitions, before.transitions + 1);
+	CHECK(regionMatches(face.clock));
+
+	FACE_setAnimated(false);
+	showIcon(1, true);
+	snapshot(face.icon, reference);
+	showIcon(0, false);
+
+	FACE_setAnimated(true);
+	ANIM_getStats(&before);
+	redraws = dispatched(BUS_MSG_REDRAW);
+	showIcon(1, true);
+	CHECK(waitDispatched(BUS_MSG_REDRAW, redraws));
+	ANIM_getStats(&after);
+	HOST_report("icon transition:  %u frames, %u bytes, redraw after it dispatched", after.frames - before.frames,
+		after.bytes - before.bytes);
+	CHECK_EQ(after.transitions, before.transitions + 1);
+	CHECK(regionMatches(face.icon));
+
+	FACE_setAnimated(false);
+}
+
+//A day of minute ticks
+static void testDay(void)
+{
+	struct tm now = {.tm_year = 126, .tm_mon = 9, .tm_mday = 16, .tm_hour = 0, .tm_min = 0};
+	double layout_sum = 0;
+	double render_sum = 0;
+	double layout_max = 0;
+	double render_max = 0;
+	uint64_t bytes = 0;
+	uint32_t bytes_max = 0;
+	UI_stats_t stats;
+
+	mktime(&now);
+	const struct mallinfo2 heap_before = mallinfo2();
+	for (int i = 0; i < TICKS; i++)
+	{
+		const tick_t t = tick(&now, 100 - i / 30);
+		layout_sum += t.layout_us;
+		render_sum += t.render_us;
+		layout_max = (t.layout_us > layout_max) ? t.layout_us : layout_max;
+		render_max = (t.render_us > render_max) ? t.render_us : render_max;
+		bytes += t.pixel_bytes;
+		bytes_max = (t.pixel_bytes > bytes_max) ? t.pixel_bytes : bytes_max;
+
+		now.tm_min++;
+		mktime(&now);
+	}
+	const struct mallinfo2 heap_after = mallinfo2();
+	UI_getStats(&stats);
+
+	HOST_report("%d ticks  layout avg %.2f us max %.2f us  render avg %.2f us max %.2f us (host)",
+		TICKS, layout_sum / TICKS, layout_max, render_sum / TICKS, render_max);
+	HOST_report("pixel bytes per tick avg %.0f max %u, full frame %d (%.1f%%), wire avg %.0f us at %d Hz",
+		(double)bytes / TICKS, bytes_max, FRAME_SIZE, 100.0 * bytes / TICKS / FRAME_SIZE,
+		bytes * 8.0 * 1e6 / TICKS / LCD_busGetClock(), LCD_busGetClock());
+	HOST_report("updates %u  unchanged %u  relayouts %u  commit max %u us",
+		stats.updates, stats.unchanged, stats.relayouts, stats.max_commit_us);
+
+	//no allocation once the widgets exist
+	CHECK_EQ(heap_after.uordblks, heap_before.uordblks);
+	//a minute tick is a digit or two, never the whole screen
+	CHECK(bytes / TICKS < FRAME_SIZE / 10);
+	CHECK(bytes_max < FRAME_SIZE / 2);
+}
+
+int main(void)
+{
+	LCD_emuInit();
+	CHECK_EQ(LCD_busInit(&spi, LCD_BUS_DEFAULT_HZ), ESP_OK);
+	LCD_init(spi);
+
+	//vsync is never started, so the flush does not pace itself
+	CHECK_EQ(BUS_init(), ESP_OK);
+	CHECK_EQ(FACE_init(spi), ESP_OK);
+	FACE_getWidgets(&face);
+	//a day of transitions would take minutes, they get their own test
+	FACE_setAnimated(false);
+	showIcon(0, true);
+
+	testDamage();
+	testAnimated();
+	testDay();
+
+	EMU_st7735s_t* emu = LCD_emuLock();
+	CHECK_EQ(emu->unknown_cmds, 0);
+	CHECK_EQ(emu->bad_params, 0);
+	CHECK_EQ(emu->bad_pixels, 0);
+	CHECK(!emu->scroll);
+	LCD_emuUnlock();
+
+	CHECK_EQ(LCD_emuDump(HOST_FRAME_DIR "/ui_face.png"), 0);
+	return HOST_testDone("test_ui");
+}
@@ -0,0 +1,192 @@
+/**
+ * @file test_vsync.c
+ * @author Nicholas Cantone
+ * @date October 2026
+ * @brief Flush pacing with and without a TE line
+ *
+ * Without TE (PIN_TE is -1 on the board) a flush must not wait at all. A
+ * thread then plays the panel's TE output on a spare pin: init has to find
+ * the line and measure its period, every wait has to return on a fresh edge
+ * and the framebuffer flushes have to start on one. When the line goes quiet
+ * the waits time out a few times and then stop waiting.
+ */
+
+/************************************************
+ *  INCLUDES
+ ***********************************************/
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include "display_main.h"
+#include "display_bus.h"
+#include "display_fb.h"
+#include "display_vsync.h"
+#include "esp_timer.h"
+#include "host_shim.h"
+#include "lcd_port_emu.h"
+#include "host_test.h"
+
+/************************************************
+ *  DEFINITIONS
+ ***********************************************/
+
+#define TE_GPIO        34         //spare input standing in for the TE line
+#define TE_PERIOD_US   8000
+#define WAITS          10
+#define FLUSHES        10
+#define BACKGROUND     0x7D7D
+
+/************************************************
+ *  GLOBALS
+ ***********************************************/
+
+static spi_device_handle_t spi;
+static pthread_t te_thread;
+static atomic_bool te_running;
+static atomic_int te_edges;
+
+/************************************************
+ *  FUNCTIONS
+ ***********************************************/
+
+static void sleepUs(int us)
+{
+	const struct timespec ts = {us / 1000000, (us % 1000000) * 1000L};
+	nanosleep(&ts, NULL);
+}
+
+//The panel's TE output, high at the start of every vertical blanking
+static void* teSource(void* arg)
+{
+	while (atomic_load(&te_running))
+	{
+		HOST_gpioSetInput(TE_GPIO, 1);
+		atomic_fetch_add(&te_edges, 1);
+		sleepUs(TE_PERIOD_US / 2);
+		HOST_gpioSetInput(TE_GPIO, 0);
+		sleepUs(TE_PERIOD_US / 2);
+	}
+	return NULL;
+}
+
+static bool tearingOn(void)
+{
+	EMU_st7735s_t* emu = LCD_emuLock();
+	const bool on = emu->tearing;
+	LCD_emuUnlock();
+	return on;
+}
+
+//A small change so every flush has something to send
+static int64_t timedFlushes(int n)
+{
+	const int64_t start = esp_timer_get_time();
+	for (int i = 0; i < n; i++)
+	{
+		FB_setFill(0, (FB_rect_t){10, 10, 20, 20}, (i & 1) ? 0xF800 : 0x001F);
+		FB_flush();
+	}
+	return esp_timer_get_time() - start;
+}
+
+//PIN_TE is -1: nothing to sync to, flushes go straight out
+static void testNotWired(void)
+{
+	LCD_vsync_stats_t s;
+
+	CHECK_EQ(LCD_vsyncInit(spi, -1), ESP_OK);
+	const int64_t start = esp_timer_get_time();
+	for (int i = 0; i < WAITS; i++)
+	{
+		LCD_vsyncWait();
+	}
+	const int64_t waited = esp_timer_get_time() - start;
+	const int64_t flushed = timedFlushes(FLUSHES);
+	LCD_vsyncGetStats(&s);
+
+	HOST_report("not wired  %d waits %lld us  %d flushes %lld us", WAITS, (long long)waited, FLUSHES, (long long)flushed);
+	CHECK_EQ(s.source, LCD_VSYNC_OFF);
+	CHECK_EQ(s.waits, 0);
+	CHECK(!tearingOn());
+	CHECK(waited < LCD_VSYNC_DEFAULT_US);
+	//a paced flush would take up to a refresh period each
+	CHECK(flushed < FLUSHES * LCD_VSYNC_DEFAULT_US / 2);
+}
+
+static void testTe(void)
+{
+	LCD_vsync_stats_t s;
+	int fresh = 0;
+	int spaced = 0;
+
+	atomic_store(&te_running, true);
+	pthread_create(&te_thread, NULL, teSource, NULL);
+
+	CHECK_EQ(LCD_vsyncInit(spi, TE_GPIO), ESP_OK);
+	LCD_vsyncGetStats(&s);
+	HOST_report("TE         source %d  measured period %u us (sent %d)", s.source, s.period_us, TE_PERIOD_US);
+	CHECK_EQ(s.source, LCD_VSYNC_TE);
+	CHECK(s.period_us > TE_PERIOD_US * 3 / 4 && s.period_us < TE_PERIOD_US * 5 / 4);
+	CHECK(tearingOn());
+
+	//every wait returns on an edge that came after it was called
+	int64_t prev = LCD_vsyncWait();
+	for (int i = 0; i < WAITS; i++)
+	{
+		const int64_t called = esp_timer_get_time();
+		const int64_t edge = LCD_vsyncWait();
+		fresh += (edge >= called);
+		spaced += (edge - prev >= TE_PERIOD_US / 2);
+		prev = edge;
+	}
+	CHECK_EQ(fresh, WAITS);
+	CHECK_EQ(spaced, WAITS);
+
+	const int edges_before = atomic_load(&te_edges);
+	const int64_t flushed = timedFlushes(FLUSHES);
+	const int edges = atomic_load(&te_edges) - edges_before;
+	LCD_vsyncGetStats(&s);
+	HOST_report("TE         %d flushes %lld us over %d edges, waits %u  frames %u  overruns %u",
+		FLUSHES, (long long)flushed, edges, s.waits, s.frames, s.overruns);
+	//one edge per flush at least
+	CHECK(edges >= FLUSHES);
+	CHECK_EQ(s.frames, FLUSHES);
+	CHECK_EQ(s.timeouts, 0);
+
+	//the line goes quiet, a few timeouts and then no more waiting
+	atomic_store(&te_running, false);
+	pthread_join(te_thread, NULL);
+	for (int i = 0; i < LCD_VSYNC_MAX_MISSES; i++)
+	{
+		LCD_vsyncWait();
+	}
+	const int64_t start = esp_timer_get_time();
+	LCD_vsyncWait();
+	const int64_t waited = esp_timer_get_time() - start;
+	LCD_vsyncGetStats(&s);
+	HOST_report("TE stopped timeouts %u, source %d, next wait %lld us", s.timeouts, s.source, (long long)waited);
+	CHECK_EQ(s.timeouts, LCD_VSYNC_MAX_MISSES);
+	CHECK_EQ(s.source, LCD_VSYNC_OFF);
+	CHECK(waited < LCD_VSYNC_TIMEOUT_MS * 1000 / 2);
+}
+
+int main(void)
+{
+	LCD_emuInit();
+	CHECK_EQ(LCD_busInit(&spi, LCD_BUS_DEFAULT_HZ), ESP_OK);
+	LCD_init(spi);
+	FB_init(spi, BACKGROUND);
+	FB_flush();
+
+	testNotWired();
+	testTe();
+
+	EMU_st7735s_t* emu = LCD_emuLock();
+	CHECK_EQ(emu->unknown_cmds, 0);
+	CHECK_EQ(emu->bad_params, 0);
+	CHECK_EQ(emu->bad_pixels, 0);
+	LCD_emuUnlock();
+
+	return HOST_testDone("test_vsync");
+}
@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+"""
+Convert the raw RGB565 tables in display_templates.c into palette indexed
+glyph tables (display_templates_glyph.c) for the expander in src/display_glyph.c.
+
+Each asset group shares one palette so it can be recolored as a whole. The bit
+depth is the smallest of 1/2/4 bpp that holds the group's colors. Groups with
+more than 16 colors keep the 16 most used ones and map the rest to the nearest
+palette entry, the script reports when that happens.
+
+usage: palette_assets.py src/display_templates.c src/display_templates_glyph.c
+"""
+
+import sys
+from collections import Counter
+
+from rle_assets import PIXEL_SIZE, parse_tables
+
+MAX_COLORS = 16
+
+# group -> (palette name, [(name in display_templates.c, glyph table name, width, height, count or None)])
+GROUPS = {
+    "clock": ("clock_palette_colors", [
+        ("display_numbers", "glyph_display_numbers", 25, 42, 10),
+        ("semi_colon",      "glyph_semi_colon",      9,  42, None),
+    ]),
+    "icons": ("icon_palette_colors", [
+        ("media_icons",     "glyph_media_icons",     30, 30, 7),
+    ]),
+}
+
+
+def to_rgb(c):
+    return ((c >> 11) & 0x1F) << 3, ((c >> 5) & 0x3F) << 2, (c & 0x1F) << 3
+
+
+def distance(a, b):
+    return sum((x - y) ** 2 for x, y in zip(to_rgb(a), to_rgb(b)))
+
+
+def pixels_of(raw):
+    return [(raw[i] << 8) | raw[i + 1] for i in range(0, len(raw), PIXEL_SIZE)]
+
+
+def pack(indices, bpp):
+    out = bytearray()
+    acc = 0
+    nbits = 0
+    for index in indices:
+        acc = (acc << bpp) | index
+        nbits += bpp
+        if nbits == 8:
+            out.append(acc)
+            acc = 0
+            nbits = 0
+    if nbits:
+        out.append(acc << (8 - nbits))
+    return bytes(out)
+
+
+def quantize(bitmaps):
+    """Shared palette for a group, bitmaps is a list of assets each holding a list of pixel lists.
+
+    Returns (palette padded to 1 << bpp entries, bpp, {color: index}, reduction report or None).
+    """
+    usage = Counter(p for asset in bitmaps for bitmap in asset for p in bitmap)
+    palette = [c for c, _ in usage.most_common(MAX_COLORS)]
+    bpp = next(b for b in (1, 2, 4) if len(palette) <= (1 << b))
+    lookup = {c: min(range(len(palette)), key=lambda i: distance(c, palette[i])) for c in usage}
+    report = None
+    if len(usage) > MAX_COLORS:
+        worst = max(distance(c, palette[lookup[c]]) for c in usage)
+        report = "%d colors reduced to %d (worst squared rgb error %d)" % (len(usage), MAX_COLORS, worst)
+
+    palette += [0] * ((1 << bpp) - len(palette))
+    return palette, bpp, lookup, report
+
+
+def c_values(values, fmt, per_line, indent="\t"):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append(indent + ", ".join(fmt % v for v in values[i:i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def main(argv):
+    if len(argv) != 3:
+        print(__doc__.strip())
+        return 1
+
+    with open(argv[1]) as f:
+        tables = parse_tables(f.read())
+
+    out = [
+        "/**",
+        " * @file display_templates_glyph.c",
+        " * @brief Palette indexed display assets, generated by tools/palette_assets.py. Do not edit.",
+        " */",
+        "",
+        '#include "display_templates.h"',
+        "",
+    ]
+
+    for group, (palette_name, assets) in GROUPS.items():
+        bitmaps = []
+        for name, glyph_name, width, height, count in assets:
+            size = width * height * PIXEL_SIZE
+            raw = tables[name]
+            n = count or 1
+            if len(raw) != size * n:
+                print("%s: expected %d bytes, found %d" % (name, size * n, len(raw)))
+                return 1
+            bitmaps.append([pixels_of(raw[k * size:(k + 1) * size]) for k in range(n)])
+
+        palette, bpp, lookup, report = quantize(bitmaps)
+        if report:
+            print("%s: %s" % (group, report))
+
+        out.append("const uint16_t %s[%d] = {" % (palette_name, len(palette)))
+        out.append(c_values(palette, "0x%04x", 8))
+        out.append("};")
+        out.append("")
+
+        packed_total = 0
+        raw_total = 0
+        for (name, glyph_name, width, height, count), asset in zip(assets, bitmaps):
+            entries = []
+            for k, bitmap in enumerate(asset):
+                data = pack([lookup[p] for p in bitmap], bpp)
+                packed_total += len(data)
+                raw_total += len(bitmap) * PIXEL_SIZE
+                data_name = "%s_%d_data" % (glyph_name, k) if count else "%s_data" % glyph_name
+                out.append("static const uint8_t %s[%d] = {" % (data_name, len(data)))
+                out.append(c_values(data, "0x%02x", 16))
+                out.append("};")
+                out.append("")
+                entries.append("{%d, %d, %d, %s}" % (width, height, bpp, data_name))
+
+            if count:
+                out.append("const LCD_glyph_t %s[%d] = {" % (glyph_name, count))
+                out.extend("\t%s," % e for e in entries)
+                out.append("};")
+            else:
+                out.append("const LCD_glyph_t %s = %s;" % (glyph_name, entries[0]))
+            out.append("")
+
+        print("%s: %d bpp, raw %d bytes -> %d bytes" % (group, bpp, raw_total, packed_total))
+
+    with open(argv[2], "w") as f:
+        f.write("\n".join(out))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,378 @@
+#!/usr/bin/env python3
+"""
+Build the display asset tables from the PNG sources in assets/.
+
+Runs as a build step (src/CMakeLists.txt) and writes display_assets.h and
+display_assets.c into the build directory. The header carries the metadata of
+every asset (dimensions, stride, format, compression, encoded size) so sizes
+and layout arithmetic are computed by the compiler instead of kept by hand, and
+the generated source checks every table against that metadata with
+_Static_assert.
+
+Each asset is one PNG, or a directory of numbered PNGs (0.png, 1.png, ...) for
+a set of frames that share the same dimensions. Pixels are converted to RGB565
+and emitted twice: run length encoded (display_rle.c) and palette indexed per
+group (display_glyph.c).
+
+The raw command writes the decoded RGB565 frames as plain tables
+(display_assets_raw.h/.c) straight from the PNGs, the host tests check the
+firmware decoder against them.
+
+The extract command writes the PNG sources from the raw RGB565 tables of the
+old hand maintained display_templates.c, it only needs to run once. That file
+was never committed, so the PNGs in assets/ are placeholders redrawn to the
+same sizes; run extract against the original file to restore the artwork.
+
+usage: png_assets.py build assets/ <output dir>
+       png_assets.py raw assets/ <output dir>
+       png_assets.py extract src/display_templates.c assets/
+"""
+
+import os
+import struct
+import sys
+import zlib
+
+from palette_assets import c_values, pack, quantize
+from rle_assets import ASSETS as RAW_LAYOUT, PIXEL_SIZE, c_bytes, decode, encode, parse_tables
+
+# asset -> (palette group, glyph table, rle table)
+ASSETS = {
+    "display_numbers": ("clock", "glyph_display_numbers", "rle_display_numbers"),
+    "semi_colon":      ("clock", "glyph_semi_colon",      "rle_semi_colon"),
+    "media_icons":     ("icons", "glyph_media_icons",     "rle_media_icons"),
+}
+
+PALETTES = {
+    "clock": "clock_palette_colors",
+    "icons": "icon_palette_colors",
+}
+
+PNG_SIGNATURE = b"\x89PNG\r\n\x1a\n"
+
+
+def png_chunks(data):
+    pos = len(PNG_SIGNATURE)
+    while pos < len(data):
+        length, kind = struct.unpack(">I4s", data[pos:pos + 8])
+        yield kind, data[pos + 8:pos + 8 + length]
+        pos += length + 12
+
+
+def unfilter(raw, width, height, bpp):
+    stride = width * bpp
+    rows = []
+    prev = bytearray(stride)
+    pos = 0
+    for _ in range(height):
+        kind = raw[pos]
+        line = bytearray(raw[pos + 1:pos + 1 + stride])
+        pos += stride + 1
+        for i in range(stride):
+            a = line[i - bpp] if i >= bpp else 0
+            b = prev[i]
+            c = prev[i - bpp] if i >= bpp else 0
+            if kind == 1:
+                line[i] = (line[i] + a) & 0xFF
+            elif kind == 2:
+                line[i] = (line[i] + b) & 0xFF
+            elif kind == 3:
+                line[i] = (line[i] + ((a + b) >> 1)) & 0xFF
+            elif kind == 4:
+                p = a + b - c
+                pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+                pred = a if pa <= pb and pa <= pc else (b if pb <= pc else c)
+                line[i] = (line[i] + pred) & 0xFF
+        rows.append(bytes(line))
+        prev = line
+    return rows
+
+
+def read_png(path):
+    """Return (width, height, [RGB565 pixels]) for an 8 bit, non interlaced PNG."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if not data.startswith(PNG_SIGNATURE):
+        raise ValueError("%s: not a PNG" % path)
+
+    idat = b""
+    plte = b""
+    for kind, body in png_chunks(data):
+        if kind == b"IHDR":
+            width, height, depth, color, _, _, interlace = struct.unpack(">IIBBBBB", body)
+        elif kind == b"PLTE":
+            plte = body
+        elif kind == b"IDAT":
+            idat += body
+
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}.get(color)
+    if depth != 8 or interlace or channels is None:
+        raise ValueError("%s: only 8 bit non interlaced gray, RGB, RGBA or indexed PNGs are supported" % path)
+
+    pixels = []
+    for row in unfilter(zlib.decompress(idat), width, height, channels):
+        for x in range(width):
+            px = row[x * channels:(x + 1) * channels]
+            if color == 3:
+                r, g, b = plte[px[0] * 3:px[0] * 3 + 3]
+            elif color in (0, 4):
+                r = g = b = px[0]
+            else:
+                r, g, b = px[:3]
+            pixels.append(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3))
+    return width, height, pixels
+
+
+def write_png(path, width, height, pixels):
+    """Write RGB565 pixels as an 8 bit RGB PNG, reading it back gives the same pixels."""
+    raw = bytearray()
+    for y in range(height):
+        raw.append(0)
+        for c in pixels[y * width:(y + 1) * width]:
+            r, g, b = (c >> 11) & 0x1F, (c >> 5) & 0x3F, c & 0x1F
+            raw.extend(((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)))
+
+    def chunk(kind, body):
+        return struct.pack(">I", len(body)) + kind + body + struct.pack(">I", zlib.crc32(kind + body))
+
+    with open(path, "wb") as f:
+        f.write(PNG_SIGNATURE)
+        f.write(chunk(b"IHDR", struct.pack(">IIBBBBB", width, height, 8, 2, 0, 0, 0)))
+        f.write(chunk(b"IDAT", zlib.compress(bytes(raw), 9)))
+        f.write(chunk(b"IEND", b""))
+
+
+def load_asset(asset_dir, name):
+    """Return (width, height, [frames], is_set), every frame a list of RGB565 pixels."""
+    path = os.path.join(asset_dir, name)
+    if os.path.isdir(path):
+        files = []
+        while os.path.exists(os.path.join(path, "%d.png" % len(files))):
+            files.append(os.path.join(path, "%d.png" % len(files)))
+        is_set = True
+    else:
+        files = [path + ".png"]
+        is_set = False
+    if not files or not os.path.exists(files[0]):
+        raise ValueError("%s: no PNG sources found" % path)
+
+    frames = []
+    width = height = None
+    for f in files:
+        w, h, pixels = read_png(f)
+        if width is not None and (w, h) != (width, height):
+            raise ValueError("%s: %dx%d, other frames are %dx%d" % (f, w, h, width, height))
+        width, height = w, h
+        frames.append(pixels)
+    return width, height, frames, is_set
+
+
+def to_bytes(pixels):
+    return b"".join(struct.pack(">H", p) for p in pixels)
+
+
+def build(asset_dir, out_dir):
+    assets = {name: load_asset(asset_dir, name) for name in ASSETS}
+
+    header = [
+        "/**",
+        " * @file display_assets.h",
+        " * @brief Display asset tables and their metadata, generated by tools/png_assets.py. Do not edit.",
+        " */",
+        "",
+        "#pragma once",
+        "",
+        '#include "display_rle.h"',
+        '#include "display_glyph.h"',
+        "",
+        "#define ASSET_FORMAT_RGB565       0  //big endian, display byte order",
+        "#define ASSET_FORMAT_INDEXED      1  //palette indices packed MSB first, no row padding",
+        "#define ASSET_COMPRESSION_NONE    0",
+        "#define ASSET_COMPRESSION_RLE     1",
+        "",
+    ]
+    source = [
+        "/**",
+        " * @file display_assets.c",
+        " * @brief Display asset tables, generated by tools/png_assets.py from %s. Do not edit." % os.path.basename(os.path.normpath(asset_dir)),
+        " */",
+        "",
+        '#include "display_assets.h"',
+        "",
+    ]
+
+    for group, palette_name in PALETTES.items():
+        members = [name for name, spec in ASSETS.items() if spec[0] == group]
+        palette, bpp, lookup, report = quantize([assets[name][2] for name in members])
+        if report:
+            print("%s: %s" % (group, report))
+
+        header.append("/* %s palette */" % group)
+        header.append("#define %s_BPP %d" % (palette_name.upper(), bpp))
+        header.append("extern const uint16_t %s[1 << %s_BPP];" % (palette_name, palette_name.upper()))
+        header.append("")
+        source.append("const uint16_t %s[1 << %s_BPP] = {" % (palette_name, palette_name.upper()))
+        source.append(c_values(palette, "0x%04x", 8))
+        source.append("};")
+        source.append("")
+
+        for name in members:
+            _, glyph_name, rle_name = ASSETS[name]
+            width, height, frames, is_set = assets[name]
+            macro = name.upper()
+            count = len(frames)
+            array = "[%s_COUNT]" % macro if is_set else ""
+
+            header.append("/* %s: %d frame%s from %s */" % (name, count, "s" if count > 1 else "", name + ("/" if is_set else ".png")))
+            header.append("#define %s_WIDTH %d" % (macro, width))
+            header.append("#define %s_HEIGHT %d" % (macro, height))
+            header.append("#define %s_COUNT %d" % (macro, count))
+            header.append("#define %s_STRIDE (%s_WIDTH * PIXEL_SIZE)  //bytes per decoded row" % (macro, macro))
+            header.append("#define %s_SIZE (%s_STRIDE * %s_HEIGHT)   //bytes per decoded frame" % (macro, macro, macro))
+            header.append("#define %s_FORMAT ASSET_FORMAT_RGB565" % rle_name.upper())
+            header.append("#define %s_COMPRESSION ASSET_COMPRESSION_RLE" % rle_name.upper())
+            header.append("#define %s_FORMAT ASSET_FORMAT_INDEXED" % glyph_name.upper())
+            header.append("#define %s_COMPRESSION ASSET_COMPRESSION_NONE" % glyph_name.upper())
+            header.append("#define %s_BPP %s_BPP" % (glyph_name.upper(), palette_name.upper()))
+            header.append("#define %s_DATA_SIZE ((%s_WIDTH * %s_HEIGHT * %s_BPP + 7) / 8)"
+                          % (glyph_name.upper(), macro, macro, glyph_name.upper()))
+            header.append("extern const LCD_rle_asset_t %s%s;" % (rle_name, array))
+            header.append("extern const LCD_glyph_t %s%s;" % (glyph_name, array))
+            header.append("")
+
+            source.append("_Static_assert(%s_WIDTH <= WIDTH && %s_HEIGHT <= HEIGHT, \"%s is larger than the screen\");"
+                          % (macro, macro, name))
+            source.append("")
+
+            rle_entries = []
+            glyph_entries = []
+            for k, pixels in enumerate(frames):
+                suffix = "_%d" % k if is_set else ""
+                raw = to_bytes(pixels)
+
+                rle = encode(raw)
+                if decode(rle) != raw:
+                    raise ValueError("%s[%d]: decoded output differs from source" % (name, k))
+                rle_data = "%s%s_data" % (rle_name, suffix)
+                source.append("static const uint8_t %s[] = {" % rle_data)
+                source.append(c_bytes(rle))
+                source.append("};")
+                rle_entries.append("{%s_WIDTH, %s_HEIGHT, sizeof(%s), %s}" % (macro, macro, rle_data, rle_data))
+
+                glyph = pack([lookup[p] for p in pixels], bpp)
+                glyph_data = "%s%s_data" % (glyph_name, suffix)
+                source.append("static const uint8_t %s[] = {" % glyph_data)
+                source.append(c_values(glyph, "0x%02x", 16))
+                source.append("};")
+                source.append("_Static_assert(sizeof(%s) == %s_DATA_SIZE, \"%s does not match its metadata\");"
+                              % (glyph_data, glyph_name.upper(), glyph_data))
+                source.append("")
+                glyph_entries.append("{%s_WIDTH, %s_HEIGHT, %s_BPP, %s}" % (macro, macro, glyph_name.upper(), glyph_data))
+
+            for table, kind, entries in ((rle_name, "LCD_rle_asset_t", rle_entries), (glyph_name, "LCD_glyph_t", glyph_entries)):
+                if is_set:
+                    source.append("const %s %s%s = {" % (kind, table, array))
+                    source.extend("\t%s," % e for e in entries)
+                    source.append("};")
+                else:
+                    source.append("const %s %s = %s;" % (kind, table, entries[0]))
+                source.append("")
+
+            print("%s: %d x %dx%d, %d bpp" % (name, count, width, height, bpp))
+
+    write_outputs(out_dir, (("display_assets.h", header), ("display_assets.c", source)))
+    return 0
+
+
+def raw(asset_dir, out_dir):
+    header = [
+        "/**",
+        " * @file display_assets_raw.h",
+        " * @brief Uncompressed RGB565 frames of the display assets, generated by tools/png_assets.py. Do not edit.",
+        " */",
+        "",
+        "#pragma once",
+        "",
+        '#include "display_assets.h"',
+        "",
+    ]
+    source = [
+        "/**",
+        " * @file display_assets_raw.c",
+        " * @brief Uncompressed display assets, generated by tools/png_assets.py from %s. Do not edit." % os.path.basename(os.path.normpath(asset_dir)),
+        " */",
+        "",
+        '#include "display_assets_raw.h"',
+        "",
+    ]
+
+    for name in ASSETS:
+        width, height, frames, is_set = load_asset(asset_dir, name)
+        macro = name.upper()
+        array = "[%s_COUNT][%s_SIZE]" % (macro, macro) if is_set else "[%s_SIZE]" % macro
+        header.append("extern const uint8_t raw_%s%s;" % (name, array))
+        source.append("const uint8_t raw_%s%s = {" % (name, array))
+        for pixels in frames:
+            data = c_bytes(to_bytes(pixels), "\t\t" if is_set else "\t")
+            source.append("\t{\n%s\n\t}," % data if is_set else data)
+        source.append("};")
+        source.append("")
+
+    header.append("")
+    write_outputs(out_dir, (("display_assets_raw.h", header), ("display_assets_raw.c", source)))
+    return 0
+
+
+def write_outputs(out_dir, files):
+    os.makedirs(out_dir, exist_ok=True)
+    for filename, lines in files:
+        path = os.path.join(out_dir, filename)
+        text = "\n".join(lines)
+        #leave unchanged outputs alone so dependents are not rebuilt
+        if os.path.exists(path):
+            with open(path) as f:
+                if f.read() == text:
+                    continue
+        with open(path, "w") as f:
+            f.write(text)
+
+
+def extract(templates, asset_dir):
+    with open(templates) as f:
+        tables = parse_tables(f.read())
+
+    for name, (_, width, height, count) in RAW_LAYOUT.items():
+        size = width * height * PIXEL_SIZE
+        raw = tables[name]
+        n = count or 1
+        if len(raw) != size * n:
+            raise ValueError("%s: expected %d bytes, found %d" % (name, size * n, len(raw)))
+
+        path = os.path.join(asset_dir, name)
+        if count:
+            os.makedirs(path, exist_ok=True)
+        for k in range(n):
+            frame = raw[k * size:(k + 1) * size]
+            pixels = [(frame[i] << 8) | frame[i + 1] for i in range(0, size, PIXEL_SIZE)]
+            out = os.path.join(path, "%d.png" % k) if count else path + ".png"
+            write_png(out, width, height, pixels)
+            if read_png(out)[2] != pixels:
+                raise ValueError("%s: pixels changed on the way through PNG" % out)
+        print("%s: %d x %dx%d" % (name, n, width, height))
+    return 0
+
+
+def main(argv):
+    commands = {"build": build, "raw": raw, "extract": extract}
+    if len(argv) != 4 or argv[1] not in commands:
+        print(__doc__.strip())
+        return 1
+    try:
+        return commands[argv[1]](argv[2], argv[3])
+    except ValueError as e:
+        print(e)
+        return 1
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
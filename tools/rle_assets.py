@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+"""
+Convert the raw RGB565 tables in display_templates.c into run length encoded
+tables (display_templates_rle.c) for the decoder in src/display_rle.c.
+
+Every table is decoded again after encoding and compared byte for byte with the
+original, the script fails if anything differs.
+
+usage: rle_assets.py src/display_templates.c src/display_templates_rle.c
+"""
+
+import re
+import sys
+
+PIXEL_SIZE = 2
+REPEAT_FLAG = 0x80
+MAX_RUN = 128
+
+# name in display_templates.c -> (rle table name, width, height, count or None for a single bitmap)
+ASSETS = {
+    "display_numbers": ("rle_display_numbers", 25, 42, 10),
+    "media_icons":     ("rle_media_icons",     30, 30, 7),
+    "semi_colon":      ("rle_semi_colon",      9,  42, None),
+}
+
+
+def parse_tables(text):
+    """Return {name: [bytes]} for every array initializer in a C source."""
+    tables = {}
+    for match in re.finditer(r"(\w+)\s*(?:\[[^\]]*\])+\s*=\s*{", text):
+        name = match.group(1)
+        depth = 0
+        start = match.end() - 1
+        for end in range(start, len(text)):
+            if text[end] == "{":
+                depth += 1
+            elif text[end] == "}":
+                depth -= 1
+                if depth == 0:
+                    break
+        body = re.sub(r"/\*.*?\*/|//[^\n]*", "", text[start:end + 1], flags=re.S)
+        tables[name] = bytes(int(v, 0) for v in re.findall(r"0[xX][0-9a-fA-F]+|\d+", body))
+    return tables
+
+
+def encode(raw):
+    pixels = [raw[i:i + PIXEL_SIZE] for i in range(0, len(raw), PIXEL_SIZE)]
+    out = bytearray()
+    literal = []
+
+    def flush_literal():
+        while literal:
+            block = literal[:MAX_RUN]
+            del literal[:MAX_RUN]
+            out.append(len(block) - 1)
+            for p in block:
+                out.extend(p)
+
+    i = 0
+    while i < len(pixels):
+        run = 1
+        while i + run < len(pixels) and run < MAX_RUN and pixels[i + run] == pixels[i]:
+            run += 1
+        # a run of 2 costs the same as a literal, only break the literal for 3+
+        if run >= 3:
+            flush_literal()
+            out.append(REPEAT_FLAG | (run - 1))
+            out.extend(pixels[i])
+        else:
+            literal.extend(pixels[i:i + run])
+        i += run
+    flush_literal()
+    return bytes(out)
+
+
+def decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        header = data[i]
+        count = (header & 0x7F) + 1
+        i += 1
+        if header & REPEAT_FLAG:
+            out.extend(data[i:i + PIXEL_SIZE] * count)
+            i += PIXEL_SIZE
+        else:
+            out.extend(data[i:i + count * PIXEL_SIZE])
+            i += count * PIXEL_SIZE
+    return bytes(out)
+
+
+def c_bytes(data, indent="\t"):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append(indent + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",")
+    return "\n".join(lines)
+
+
+def main(argv):
+    if len(argv) != 3:
+        print(__doc__.strip())
+        return 1
+
+    with open(argv[1]) as f:
+        tables = parse_tables(f.read())
+
+    out = [
+        "/**",
+        " * @file display_templates_rle.c",
+        " * @brief Run length encoded display assets, generated by tools/rle_assets.py. Do not edit.",
+        " */",
+        "",
+        '#include "display_templates.h"',
+        "",
+    ]
+    raw_total = 0
+    rle_total = 0
+
+    for name, (rle_name, width, height, count) in ASSETS.items():
+        size = width * height * PIXEL_SIZE
+        raw = tables[name]
+        n = count or 1
+        if len(raw) != size * n:
+            print("%s: expected %d bytes, found %d" % (name, size * n, len(raw)))
+            return 1
+
+        entries = []
+        for k in range(n):
+            bitmap = raw[k * size:(k + 1) * size]
+            data = encode(bitmap)
+            if decode(data) != bitmap:
+                print("%s[%d]: decoded output differs from source" % (name, k))
+                return 1
+            raw_total += len(bitmap)
+            rle_total += len(data)
+            data_name = "%s_%d_data" % (rle_name, k) if count else "%s_data" % rle_name
+            out.append("static const uint8_t %s[%d] = {" % (data_name, len(data)))
+            out.append(c_bytes(data))
+            out.append("};")
+            out.append("")
+            entries.append("{%d, %d, %d, %s}" % (width, height, len(data), data_name))
+
+        if count:
+            out.append("const LCD_rle_asset_t %s[%d] = {" % (rle_name, count))
+            out.extend("\t%s," % e for e in entries)
+            out.append("};")
+        else:
+            out.append("const LCD_rle_asset_t %s = %s;" % (rle_name, entries[0]))
+        out.append("")
+
+    with open(argv[2], "w") as f:
+        f.write("\n".join(out))
+
+    print("raw %d bytes -> rle %d bytes (%.1f%%), all tables verified"
+          % (raw_total, rle_total, 100.0 * rle_total / raw_total))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))